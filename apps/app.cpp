@@ -1,26 +1,273 @@
+#include <batch.hpp>
 #include <convex_hull.hpp>
+#include <csignal>
 #include <fstream>
+#include <hull_server.hpp>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
 #include <iostream>
 #include <json.hpp>
+#include <merge.hpp>
+#include <new>
+#include <nms.hpp>
+#include <quantization.hpp>
+#include <simplification.hpp>
+#include <stdexcept>
+#include <thread_pool.hpp>
+#include <trace.hpp>
 
 using json = nlohmann::json;
 
+#ifdef CONVEX_HULL_STATS
+// Count every heap allocation of the process for the --stats report
+void *operator new(std::size_t size) {
+  stats::addCount(stats::kAllocations, 1);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+void printUsage(std::ostream &stream) {
+  stream << "Usage: app [options] [inputs...]\n"
+            "  --stats                 print counters and stage times\n"
+            "  --trace FILE            write a Chrome trace\n"
+            "  --quantize RESOLUTION   integer coordinate mode\n"
+            "  --nms IOU               score ordered NMS\n"
+            "  --nms-method NAME       hard, linear or gaussian\n"
+            "  --merge                 merge overlapping hulls\n"
+            "  --descriptors           compute and write shape descriptors\n"
+            "  --simplify MAX_ERROR    simplify the hulls at load\n"
+            "  --simplify-mode NAME    outer or inner\n"
+            "  --backend NAME          intersection backend\n"
+            "  --output-dir DIR        batch mode output directory\n"
+            "  --threads N             worker threads\n"
+            "  --serve SOCKET          serve requests on a Unix socket\n";
+}
+
 int main(int argc, char *argv[]) {
   std::vector<std::string> args(argv + 1, argv + argc);
-  std::string filename("../convex_hulls.json");
-  if (args.size() > 0) filename = args[0];
+  std::vector<std::string> inputs;
+  std::string output_dir;  // set (or several inputs) runs the batch mode
+  int n_threads = 0;
+  std::string socket_path;  // set runs the server mode
+  std::string trace_filename;
+  bool print_stats = false;
+  double resolution = 0.;  // > 0 runs the quantized (integer) mode
+  double nms_iou = 0.;     // > 0 runs score ordered NMS instead
+  NmsMethod nms_method = kNmsHard;
+  bool merge = false;  // merges overlapping hulls instead of eliminating
+  bool descriptors = false;  // computes and writes the shape descriptors
+  SimplificationOptions simplification;  // max_error > 0 simplifies at load
+  std::string backend_name(AutoBackend::getName());
+  bool backend_given = false;
+  for (int i = 0; i < args.size(); ++i) {
+    if (args[i] == "--stats")
+      print_stats = true;
+    else if (args[i] == "--trace" && i + 1 < args.size())
+      trace_filename = args[++i];
+    else if (args[i] == "--quantize" && i + 1 < args.size())
+      resolution = std::stod(args[++i]);
+    else if (args[i] == "--nms" && i + 1 < args.size())
+      nms_iou = std::stod(args[++i]);
+    else if (args[i] == "--nms-method" && i + 1 < args.size()) {
+      try {
+        nms_method = nmsMethodFromName(args[++i]);
+      } catch (const std::invalid_argument &e) {
+        std::cerr << e.what() << "\n";
+        printUsage(std::cerr);
+        return 1;
+      }
+    } else if (args[i] == "--merge")
+      merge = true;
+    else if (args[i] == "--descriptors")
+      descriptors = true;
+    else if (args[i] == "--simplify" && i + 1 < args.size())
+      simplification.max_error = std::stod(args[++i]);
+    else if (args[i] == "--simplify-mode" && i + 1 < args.size()) {
+      try {
+        simplification.mode = simplificationModeFromName(args[++i]);
+      } catch (const std::invalid_argument &e) {
+        std::cerr << e.what() << "\n";
+        printUsage(std::cerr);
+        return 1;
+      }
+    } else if (args[i] == "--backend" && i + 1 < args.size()) {
+      backend_name = args[++i];
+      backend_given = true;
+    } else if (args[i] == "--output-dir" && i + 1 < args.size())
+      output_dir = args[++i];
+    else if (args[i] == "--threads" && i + 1 < args.size())
+      n_threads = std::stoi(args[++i]);
+    else if (args[i] == "--serve" && i + 1 < args.size())
+      socket_path = args[++i];
+    else
+      inputs.push_back(args[i]);
+  }
+  if (inputs.empty()) inputs.push_back("../convex_hulls.json");
+  inputs = expandInputs(inputs);
+  bool batch = !output_dir.empty() || inputs.size() > 1;
+  if (batch && output_dir.empty()) {
+    std::cerr << "Several inputs need an --output-dir\n";
+    return 1;
+  }
+  std::unique_ptr<IntersectionBackend> backend =
+      makeIntersectionBackend(backend_name);
+  if (!backend) {
+    std::cerr << "Unknown intersection backend " << backend_name
+              << ", expected one of:";
+    for (const std::string &name : getIntersectionBackendNames())
+      std::cerr << " " << name;
+    std::cerr << "\n";
+    return 1;
+  }
+  // One mode per run: none of them takes precedence over another
+  if ((resolution > 0.) + (nms_iou > 0.) + merge > 1) {
+    std::cerr << "--quantize, --nms and --merge are mutually exclusive\n";
+    return 1;
+  }
+  if (resolution > 0. && simplification.max_error > 0.) {
+    std::cerr << "--simplify can not be combined with --quantize\n";
+    return 1;
+  }
+  // The quantized mode has its own exact intersection
+  if (backend_given && resolution > 0.) {
+    std::cerr << "--backend can not be combined with --quantize\n";
+    return 1;
+  }
+  stats::reset();
+  trace::setEnabled(!trace_filename.empty());
+
+  if (!socket_path.empty()) {
+    // Blocked in every thread, so they are only received by sigwait below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    HullServerOptions options;
+    options.socket_path = socket_path;
+    options.backend = backend_name;
+    options.n_threads = n_threads;
+    HullServer server(options);
+    std::string error;
+    if (!server.start(&error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    std::cout << "Listening on " << socket_path << "\n";
+    int signal;
+    sigwait(&signals, &signal);
+    server.stop();
+    std::cout << "Served " << server.getNRequests() << " requests\n";
+    if (print_stats) stats::printReport(std::cout);
+    return 0;
+  }
 
-  std::ifstream f(filename);
-  json data = json::parse(f);
-  std::vector<ConvexHull> convex_hull_v;
-  convex_hull_v = convexHullsFromJson(data);
   double overlap = 0.5;
-  std::vector<ConvexHull> remaining_c_hulls =
-      eliminateOverlappingCHulls(&convex_hull_v, overlap);
-  json remaining_c_hulls_json = convexHullsToJson(remaining_c_hulls);
+  // Merges the components of a single input in parallel (the batch mode
+  // already runs one file per thread)
+  std::unique_ptr<ThreadPool> merge_pool;
+  if (merge && !batch) merge_pool.reset(new ThreadPool(n_threads));
+  // Hulls of one frame in, remaining hulls out. Runs concurrently on several
+  // frames in the batch mode
+  auto process = [&](const json &data) {
+    std::vector<ConvexHull> remaining_c_hulls;
+    std::vector<double> remaining_scores;  // NMS only
+    if (resolution > 0.) {
+      Quantizer quantizer(resolution);
+      QuantizationReport report;
+      std::vector<QuantizedHull> quantized_v;
+      {
+        CH_STATS_STAGE(kStageFromJson);
+        quantized_v = convexHullsFromJson(data, quantizer, &report);
+      }
+      {
+        CH_STATS_STAGE(kStageEliminate);
+        std::vector<QuantizedHull> remaining =
+            eliminateOverlappingCHulls(&quantized_v, overlap);
+        for (const QuantizedHull &hull : remaining)
+          remaining_c_hulls.push_back(dequantize(hull, quantizer));
+      }
+      if (!batch) std::cout << "Quantization: " << report << "\n";
+    } else {
+      std::vector<ConvexHull> convex_hull_v;
+      {
+        CH_STATS_STAGE(kStageFromJson);
+        if (simplification.max_error > 0.) {
+          SimplificationReport report;
+          convex_hull_v = convexHullsFromJson(data, simplification, &report);
+          if (!batch) std::cout << "Simplification: " << report << "\n";
+        } else {
+          convex_hull_v = convexHullsFromJson(data);
+        }
+        // Cached on the hulls, the elimination uses their rectangles too
+        if (descriptors) {
+          for (ConvexHull &c : convex_hull_v) c.getDescriptors();
+        }
+      }
+      CH_STATS_STAGE(kStageEliminate);
+      if (nms_iou > 0.) {
+        NmsOptions options;
+        options.method = nms_method;
+        options.iou_threshold = nms_iou;
+        options.backend = backend.get();
+        std::vector<int> kept = nonMaximumSuppression(
+            &convex_hull_v, scoresFromJson(data), options, &remaining_scores);
+        for (int i : kept) remaining_c_hulls.push_back(convex_hull_v[i]);
+      } else if (merge) {
+        remaining_c_hulls = mergeOverlappingCHulls(
+            &convex_hull_v, overlap, merge_pool.get(), backend.get());
+      } else {
+        remaining_c_hulls =
+            eliminateOverlappingCHullsWith(&convex_hull_v, overlap, *backend);
+      }
+    }
+    CH_STATS_STAGE(kStageToJson);
+    // Merged and dequantized hulls are new and have none cached yet
+    if (descriptors) {
+      for (ConvexHull &c : remaining_c_hulls) c.getDescriptors();
+    }
+    json remaining_c_hulls_json = convexHullsToJson(remaining_c_hulls);
+    for (int i = 0; i < remaining_scores.size(); ++i)
+      remaining_c_hulls_json["convex hulls"][i]["score"] = remaining_scores[i];
+    return remaining_c_hulls_json;
+  };
 
-  std::ofstream file("result_convex_hulls.json");
-  file << std::setw(4) << remaining_c_hulls_json << std::endl;
+  int status = 0;
+  if (batch) {
+    ThreadPool pool(n_threads);
+    BatchResult result = processBatch(inputs, output_dir, process, &pool);
+    for (const std::string &error : result.errors)
+      std::cerr << error << "\n";
+    std::cout << "Processed " << result.n_files - result.n_failed << " of "
+              << result.n_files << " files with " << pool.getNThreads()
+              << " threads\n";
+    if (result.n_failed > 0) status = 1;
+  } else {
+    json data;
+    {
+      CH_STATS_STAGE(kStageParse);
+      CH_TRACE_SPAN("parse");
+      std::ifstream f(inputs[0]);
+      data = json::parse(f);
+    }
+    json remaining_c_hulls_json = process(data);
+    {
+      CH_STATS_STAGE(kStageWrite);
+      CH_TRACE_SPAN("write");
+      std::ofstream file("result_convex_hulls.json");
+      file << std::setw(4) << remaining_c_hulls_json << std::endl;
+    }
+  }
+  if (print_stats) stats::printReport(std::cout);
+  if (!trace_filename.empty()) {
+    std::ofstream trace_file(trace_filename);
+    int n_spans = trace::writeChromeTrace(trace_file);
+    std::cout << "Wrote " << n_spans << " spans to " << trace_filename << "\n";
+  }
   std::cout << "Done\n";
-  return 0;
+  return status;
 }
@@ -0,0 +1,46 @@
+#include <convex_hull_c.h>
+#include <stdio.h>
+
+/*
+ * Minimal use of the C API: three squares in flat caller owned arrays, the
+ * second one mostly covering the first one.
+ */
+int main(void) {
+  const double xy[] = {0, 0, 2, 0, 2, 2, 0, 2,          /* hull 0 */
+                       0.5, 0, 2.5, 0, 2.5, 2, 0.5, 2,  /* hull 1 */
+                       10, 10, 11, 10, 11, 11, 10, 11}; /* hull 2 */
+  const int32_t offsets[] = {0, 4, 8, 12};
+  const int32_t ids[] = {100, 101, 102};
+  ch_hullset *set = NULL;
+  int32_t kept[3], n_kept = 0, i;
+  double area = 0;
+  ch_status status;
+
+  if (ch_api_version() != CH_API_VERSION) {
+    fprintf(stderr, "Library and header versions differ\n");
+    return 1;
+  }
+  status = ch_hullset_create_from_buffers(xy, offsets, ids, 3, &set);
+  if (status != CH_OK) {
+    fprintf(stderr, "%s\n", ch_status_string(status));
+    return 1;
+  }
+  ch_intersection_area(set, 0, 1, &area);
+  printf("Intersection of hulls 0 and 1: %g\n", area);
+
+  status = ch_eliminate(set, 0.5, kept, &n_kept);
+  if (status != CH_OK) {
+    fprintf(stderr, "%s\n", ch_status_string(status));
+    ch_hullset_destroy(set);
+    return 1;
+  }
+  printf("Remaining hulls:");
+  for (i = 0; i < n_kept; ++i) {
+    int32_t id;
+    ch_hull_id(set, kept[i], &id);
+    printf(" %d", id);
+  }
+  printf("\n");
+  ch_hullset_destroy(set);
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include <fstream>
+#include <hull_generator.hpp>
+#include <iostream>
+#include <string>
+
+// Writes a reproducible synthetic convex hull workload, in the json format
+// read by app. Usage:
+//   ./generate_hulls [--count N] [--seed S] [--min-vertices N]
+//                    [--max-vertices N] [--min-radius R] [--max-radius R]
+//                    [--clusters K] [--cluster-spread F] [--overlap D]
+//                    [--output file.json]
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  HullGeneratorOptions options;
+  std::string output("generated_convex_hulls.json");
+
+  for (int i = 0; i + 1 < args.size(); i += 2) {
+    const std::string &flag = args[i];
+    const std::string &value = args[i + 1];
+    if (flag == "--count")
+      options.count = std::stoi(value);
+    else if (flag == "--seed")
+      options.seed = std::stoul(value);
+    else if (flag == "--min-vertices")
+      options.min_vertices = std::stoi(value);
+    else if (flag == "--max-vertices")
+      options.max_vertices = std::stoi(value);
+    else if (flag == "--min-radius")
+      options.min_radius = std::stod(value);
+    else if (flag == "--max-radius")
+      options.max_radius = std::stod(value);
+    else if (flag == "--clusters")
+      options.n_clusters = std::stoi(value);
+    else if (flag == "--cluster-spread")
+      options.cluster_spread = std::stod(value);
+    else if (flag == "--overlap")
+      options.overlap_density = std::stod(value);
+    else if (flag == "--output")
+      output = value;
+    else {
+      std::cerr << "Unknown option " << flag << "\n";
+      return 1;
+    }
+  }
+  if (args.size() % 2 != 0) {
+    std::cerr << "Missing value for option " << args.back() << "\n";
+    return 1;
+  }
+  if (options.min_vertices < 3 || options.max_vertices < options.min_vertices ||
+      options.min_radius <= 0 || options.max_radius < options.min_radius ||
+      options.overlap_density <= 0) {
+    std::cerr << "Invalid workload parameters\n";
+    return 1;
+  }
+
+  std::ofstream file(output);
+  writeGeneratedConvexHullsJson(options, file);
+  std::cout << "Wrote " << options.count << " convex hulls to " << output
+            << "\n";
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <binary_format.hpp>
+#include <chrono>
+#include <fstream>
+#include <hull_server.hpp>
+#include <iostream>
+#include <json.hpp>
+#include <sstream>
+
+using json = nlohmann::json;
+
+// Sends a hull file to a running `app --serve` and writes the remaining
+// hulls. With --repeat the request is sent several times and the round trip
+// latency is reported.
+//
+//   ./hull_client <socket> <hulls.json> [--binary] [--repeat N]
+//                 [--output result.json]
+int main(int argc, char *argv[]) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::vector<std::string> positional;
+  std::string output("result_convex_hulls.json");
+  bool binary = false;
+  int n_repeats = 1;
+  for (int i = 0; i < args.size(); ++i) {
+    if (args[i] == "--binary")
+      binary = true;
+    else if (args[i] == "--repeat" && i + 1 < args.size())
+      n_repeats = std::max(1, std::stoi(args[++i]));
+    else if (args[i] == "--output" && i + 1 < args.size())
+      output = args[++i];
+    else
+      positional.push_back(args[i]);
+  }
+  if (positional.size() != 2) {
+    std::cerr << "Usage: hull_client <socket> <hulls.json> [--binary] "
+                 "[--repeat N] [--output result.json]\n";
+    return 1;
+  }
+
+  std::ifstream f(positional[1]);
+  std::stringstream text;
+  text << f.rdbuf();
+  std::string payload;
+  MessageKind kind = kMessageJson;
+  if (binary) {
+    std::vector<ConvexHull> hulls =
+        convexHullsFromJson(json::parse(text.str()));
+    encodeHulls(hulls, &payload);
+    kind = kMessageBinary;
+  } else {
+    payload = text.str();
+  }
+
+  HullClient client;
+  std::string error;
+  if (!client.connect(positional[0], &error)) {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  MessageKind response_kind;
+  std::string response;
+  std::vector<double> latencies;
+  for (int r = 0; r < n_repeats; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    if (!client.request(kind, payload, &response_kind, &response)) {
+      std::cerr << "Connection to the server failed\n";
+      return 1;
+    }
+    latencies.push_back(std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+  }
+  if (response_kind == kMessageError) {
+    std::cerr << "Server error: " << response << "\n";
+    return 1;
+  }
+
+  json result;
+  if (binary) {
+    std::vector<ConvexHull> remaining;
+    decodeHulls(response.data(), response.size(), &remaining);
+    result = convexHullsToJson(remaining);
+  } else {
+    result = json::parse(response);
+  }
+  std::ofstream file(output);
+  file << std::setw(4) << result << std::endl;
+
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "Round trip over " << n_repeats << " requests: median "
+            << latencies[latencies.size() / 2] << " us, p99 "
+            << latencies[latencies.size() * 99 / 100] << " us\n";
+  return 0;
+}
@@ -0,0 +1,233 @@
+#include <benchmark/benchmark.h>
+
+#include <clustering.hpp>
+#include <convex_hull_view.hpp>
+#include <hull_generator.hpp>
+#include <incremental_eliminator.hpp>
+#include <overlap_matrix.hpp>
+#include <memory>
+#include <nms.hpp>
+#include <simplification.hpp>
+#include <sstream>
+
+// End-to-end benchmark of the app pipeline (parse, convexHullsFromJson,
+// eliminateOverlappingCHulls, convexHullsToJson and dump) over generated
+// workloads. The first argument is the number of hulls, the second the number
+// of clusters (0 = uniform placement).
+
+namespace {
+std::string workloadText(int count, int n_clusters) {
+  HullGeneratorOptions options;
+  options.count = count;
+  options.seed = 42;
+  options.n_clusters = n_clusters;
+  std::ostringstream stream;
+  writeGeneratedConvexHullsJson(options, stream);
+  return stream.str();
+}
+}  // namespace
+
+static void BM_AppPipeline(benchmark::State &state) {
+  int count = state.range(0);
+  std::string text = workloadText(count, state.range(1));
+  for (auto _ : state) {
+    json data = json::parse(text);
+    std::vector<ConvexHull> convex_hull_v = convexHullsFromJson(data);
+    std::vector<ConvexHull> remaining_c_hulls =
+        eliminateOverlappingCHulls(&convex_hull_v, 0.5);
+    std::string out = convexHullsToJson(remaining_c_hulls).dump(4);
+    benchmark::DoNotOptimize(out.data());
+  }
+  double pairs = 0.5 * count * (count - 1.);
+  state.counters["hulls_per_second"] = benchmark::Counter(
+      static_cast<double>(count),
+      benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["pairs_per_second"] = benchmark::Counter(
+      pairs, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_AppPipeline)
+    ->ArgsProduct({{256, 1024, 4096}, {0, 8}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GenerateWorkload(benchmark::State &state) {
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  for (auto _ : state) {
+    std::vector<ConvexHull> hulls = generateConvexHulls(options);
+    benchmark::DoNotOptimize(hulls.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GenerateWorkload)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_StreamingElimination(benchmark::State &state) {
+  // Hulls streamed from the generator into the grid based eliminator, so
+  // only the inserted hulls are held: the cost per hull stays flat up to
+  // millions of hulls, unlike the all-pairs eliminateOverlappingCHulls
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  for (auto _ : state) {
+    HullGenerator generator(options);
+    IncrementalEliminator eliminator(0.5, 4.);
+    for (int i = 0; i < options.count; ++i) eliminator.insert(generator.next());
+    benchmark::DoNotOptimize(eliminator.getNSurvivors());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamingElimination)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_OverlapMatrix(benchmark::State &state) {
+  // Detections against the same hulls slightly moved (tracks), on
+  // state.range(1) threads (0 = calling thread only)
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  std::vector<ConvexHull> detections = generateConvexHulls(options);
+  std::vector<ConvexHull> tracks;
+  for (const ConvexHull &c : detections) {
+    std::vector<Point> apexes;
+    for (const Point &p : c.apex) apexes.push_back(Point(p.x + 0.1, p.y));
+    tracks.push_back(ConvexHull(apexes, c.id));
+  }
+  std::unique_ptr<ThreadPool> pool;
+  if (state.range(1) > 0) pool.reset(new ThreadPool(state.range(1)));
+  for (auto _ : state) {
+    OverlapMatrix matrix =
+        computeOverlapMatrix(&detections, &tracks, pool.get(), 4.);
+    benchmark::DoNotOptimize(matrix.entries.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OverlapMatrix)
+    ->ArgsProduct({{1000, 10000}, {0, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_ClusterOverlappingHulls(benchmark::State &state) {
+  // Dense clustered workload, on state.range(1) threads (0 = calling thread)
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  options.n_clusters = state.range(0) / 50;
+  options.overlap_density = 4.;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  std::unique_ptr<ThreadPool> pool;
+  if (state.range(1) > 0) pool.reset(new ThreadPool(state.range(1)));
+  for (auto _ : state) {
+    HullClusters clusters =
+        clusterOverlappingCHulls(&hulls, 0., pool.get(), 4.);
+    benchmark::DoNotOptimize(clusters.labels.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClusterOverlappingHulls)
+    ->ArgsProduct({{1000, 10000}, {0, 2, 4}})
+    ->Args({1000000, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_NonMaximumSuppression(benchmark::State &state) {
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  options.overlap_density = 8.;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> unit(0., 1.);
+  std::vector<double> scores;
+  for (int i = 0; i < hulls.size(); ++i) scores.push_back(unit(gen));
+  NmsOptions nms_options;
+  nms_options.method = static_cast<NmsMethod>(state.range(1));
+  nms_options.cell_size = 4.;
+  nms_options.score_threshold = 0.001;
+  for (auto _ : state) {
+    std::vector<int> kept = nonMaximumSuppression(&hulls, scores, nms_options);
+    benchmark::DoNotOptimize(kept.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+// Second argument: NmsMethod (hard, linear, Gaussian)
+BENCHMARK(BM_NonMaximumSuppression)
+    ->ArgsProduct({{1000, 10000, 50000}, {kNmsHard, kNmsLinear, kNmsGaussian}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_EliminateSimplified(benchmark::State &state) {
+  // Hulls of 200 to 400 vertices, simplified in outer mode with a bound of
+  // state.range(1) / 1000 before the elimination (0 = not simplified)
+  HullGeneratorOptions options;
+  options.count = state.range(0);
+  options.min_vertices = 200;
+  options.max_vertices = 400;
+  options.overlap_density = 4.;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  SimplificationOptions simplification;
+  simplification.max_error = state.range(1) / 1000.;
+  for (auto _ : state) {
+    std::vector<ConvexHull> input = hulls;
+    if (simplification.max_error > 0.)
+      simplifyConvexHulls(&input, simplification, nullptr);
+    std::vector<ConvexHull> remaining = eliminateOverlappingCHulls(&input, 0.5);
+    benchmark::DoNotOptimize(remaining.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EliminateSimplified)
+    ->ArgsProduct({{1000}, {0, 1, 10}})
+    ->Unit(benchmark::kMillisecond);
+
+namespace {
+// Vertices of a generated workload in one shared buffer, as in the caller
+// code that motivated ConvexHullView
+struct VertexBuffer {
+  std::vector<Point> vertices;
+  std::vector<int> offsets = {0};
+
+  explicit VertexBuffer(int count) {
+    HullGeneratorOptions options;
+    options.count = count;
+    options.seed = 42;
+    for (const ConvexHull &hull : generateConvexHulls(options)) {
+      vertices.insert(vertices.end(), hull.apex.begin(), hull.apex.end());
+      offsets.push_back(vertices.size());
+    }
+  }
+};
+}  // namespace
+
+static void BM_EliminateFromBufferHulls(benchmark::State &state) {
+  // Owning hulls: every vertex is copied into the hulls, then into the output
+  VertexBuffer buffer(state.range(0));
+  for (auto _ : state) {
+    std::vector<ConvexHull> hulls;
+    hulls.reserve(state.range(0));
+    for (int h = 0; h < state.range(0); ++h) {
+      hulls.emplace_back(buffer.vertices.data() + buffer.offsets[h],
+                         buffer.offsets[h + 1] - buffer.offsets[h], h);
+    }
+    std::vector<ConvexHull> remaining = eliminateOverlappingCHulls(&hulls, 0.5);
+    benchmark::DoNotOptimize(remaining.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EliminateFromBufferHulls)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_EliminateFromBufferViews(benchmark::State &state) {
+  VertexBuffer buffer(state.range(0));
+  for (auto _ : state) {
+    std::vector<ConvexHullView> views =
+        makeConvexHullViews(buffer.vertices.data(), buffer.offsets.data(),
+                            nullptr, state.range(0));
+    std::vector<ConvexHullView> remaining =
+        eliminateOverlappingCHulls(&views, 0.5);
+    benchmark::DoNotOptimize(remaining.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EliminateFromBufferViews)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Unit(benchmark::kMillisecond);
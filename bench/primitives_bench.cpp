@@ -0,0 +1,232 @@
+#include <benchmark/benchmark.h>
+
+#include <convex_hull.hpp>
+#include <gjk.hpp>
+#include <intersection_backends.hpp>
+#include <obb.hpp>
+#include <predicates.hpp>
+#include <shape_descriptors.hpp>
+
+// Benchmarks of the geometric primitives. Every benchmark is parameterized by
+// the number of vertices of the polygons (first argument) and, where it
+// applies, the overlap configuration (second argument).
+
+namespace {
+enum Overlap { kDisjoint = 0, kPartial = 1, kContained = 2 };
+const std::vector<int64_t> kVertexCounts = {3, 4, 8, 16, 64, 256};
+const std::vector<int64_t> kOverlaps = {kDisjoint, kPartial, kContained};
+
+std::vector<Point> regularPolygon(int n, double cx, double cy, double r) {
+  std::vector<Point> vertices;
+  vertices.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    double a = 2. * M_PI * i / n + 0.1;
+    vertices.push_back(Point(cx + r * std::cos(a), cy + r * std::sin(a)));
+  }
+  return vertices;
+}
+
+// Second polygon of a pair, placed relative to a unit polygon at the origin
+std::vector<Point> secondPolygon(int n, int overlap) {
+  switch (overlap) {
+    case kDisjoint:
+      return regularPolygon(n, 3., 0., 1.);
+    case kPartial:
+      return regularPolygon(n, 0.7, 0.3, 1.);
+    default:
+      return regularPolygon(n, 0.1, -0.1, 0.4);
+  }
+}
+
+Point queryPoint(int overlap) {
+  return overlap == kDisjoint ? Point(3., 0.) : Point(0.1, -0.1);
+}
+
+json hullsJson(int n_hulls, int n_vertices) {
+  std::vector<ConvexHull> hulls;
+  hulls.reserve(n_hulls);
+  for (int i = 0; i < n_hulls; ++i)
+    hulls.push_back(ConvexHull(regularPolygon(n_vertices, i, 0., 1.), i));
+  return convexHullsToJson(hulls);
+}
+}  // namespace
+
+static void BM_PointInPolygon(benchmark::State &state) {
+  std::vector<Point> vertices = regularPolygon(state.range(0), 0., 0., 1.);
+  Point P = queryPoint(state.range(1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pointInPolygon(vertices, P));
+  }
+}
+BENCHMARK(BM_PointInPolygon)
+    ->ArgsProduct({kVertexCounts, {kDisjoint, kContained}});
+
+static void BM_SegmentsIntersect(benchmark::State &state) {
+  // Edges of two polygons, so every configuration contains a mix of crossing,
+  // parallel and disjoint segments
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  Point intersection;
+  for (auto _ : state) {
+    for (int i = 0; i < C1.getNSegments(); ++i) {
+      Line l1 = C1.getSegment(i);
+      for (int j = 0; j < C2.getNSegments(); ++j) {
+        Line l2 = C2.getSegment(j);
+        benchmark::DoNotOptimize(segmentsIntersect(&l1, &l2, &intersection));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * C1.getNSegments() *
+                          C2.getNSegments());
+}
+BENCHMARK(BM_SegmentsIntersect)->ArgsProduct({{3, 4, 8, 16, 64}, kOverlaps});
+
+static void BM_Orient2d(benchmark::State &state) {
+  // Generic points are decided by the floating point filter, points a few
+  // ulps away from the line go through the exact fallback
+  double ulp = std::nextafter(0.5, 1.) - 0.5;
+  double offset = state.range(0) ? 3 * ulp : 0.25;
+  Point a(0.5, 0.5 + offset), b(12., 12.), c(24., 24.);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(predicates::orient2d(a, b, c));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_Orient2d)->Arg(0)->Arg(1);
+
+static void BM_SortPointsCCW(benchmark::State &state) {
+  std::vector<Point> vertices = regularPolygon(state.range(0), 0., 0., 1.);
+  // Interleave the vertices so the sort has work to do
+  std::vector<Point> shuffled;
+  for (int i = 0; i < vertices.size(); i += 2) shuffled.push_back(vertices[i]);
+  for (int i = 1; i < vertices.size(); i += 2) shuffled.push_back(vertices[i]);
+  for (auto _ : state) {
+    std::vector<Point> points(shuffled);
+    sortPointsCCW(&points);
+    benchmark::DoNotOptimize(points.data());
+  }
+}
+BENCHMARK(BM_SortPointsCCW)->ArgsProduct({kVertexCounts});
+
+static void BM_GetIntersectionPolygonVertices(benchmark::State &state) {
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  for (auto _ : state) {
+    std::vector<Point> vertices = getIntersectionPolygonVertices(&C1, &C2);
+    benchmark::DoNotOptimize(vertices.data());
+  }
+}
+BENCHMARK(BM_GetIntersectionPolygonVertices)
+    ->ArgsProduct({kVertexCounts, kOverlaps});
+
+static void BM_GetIntersectingPolygon(benchmark::State &state) {
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  for (auto _ : state) {
+    ConvexHull intersection;
+    benchmark::DoNotOptimize(getIntersectingPolygon(&C1, &C2, &intersection));
+  }
+}
+BENCHMARK(BM_GetIntersectingPolygon)->ArgsProduct({kVertexCounts, kOverlaps});
+
+static void BM_IntersectionArea(benchmark::State &state) {
+  // Dispatches to the unrolled kernels for 3 and 4 vertices
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(intersectionArea(&C1, &C2));
+  }
+}
+BENCHMARK(BM_IntersectionArea)->ArgsProduct({kVertexCounts, kOverlaps});
+
+// Every intersection backend on the same inputs
+template <typename Backend>
+static void BM_IntersectionBackend(benchmark::State &state) {
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  Backend backend;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(backend.intersectionArea(&C1, &C2));
+  }
+  state.SetLabel(Backend::getName());
+}
+BENCHMARK_TEMPLATE(BM_IntersectionBackend, VertexCollectionBackend)
+    ->ArgsProduct({kVertexCounts, kOverlaps});
+BENCHMARK_TEMPLATE(BM_IntersectionBackend, SutherlandHodgmanBackend)
+    ->ArgsProduct({kVertexCounts, kOverlaps});
+BENCHMARK_TEMPLATE(BM_IntersectionBackend, EdgeAdvancingBackend)
+    ->ArgsProduct({kVertexCounts, kOverlaps});
+
+static void BM_HullProximity(benchmark::State &state) {
+  // GJK, plus EPA for the overlapping configurations
+  ConvexHull C1(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  ConvexHull C2(secondPolygon(state.range(0), state.range(1)), 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hullProximity(C1, C2));
+  }
+}
+BENCHMARK(BM_HullProximity)
+    ->ArgsProduct({{3, 4, 8, 16, 64, 256, 1024, 4096}, kOverlaps});
+
+static void BM_OBBIntersectionArea(benchmark::State &state) {
+  // Unit squares: disjoint, partially overlapping or one inside the other
+  const double offsets[] = {3., 0.8, 0.};
+  const double half_extents[] = {1., 1., 0.4};
+  OrientedBox A(0., 0., 1., 1., 0.1, 0);
+  double h = half_extents[state.range(0)];
+  OrientedBox B(offsets[state.range(0)], 0.3, h, h, 0.6, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(obbIntersectionArea(A, B));
+  }
+}
+BENCHMARK(BM_OBBIntersectionArea)->ArgsProduct({kOverlaps});
+
+static void BM_ComputeArea(benchmark::State &state) {
+  ConvexHull C(regularPolygon(state.range(0), 0., 0., 1.), 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(C.getArea());
+  }
+}
+BENCHMARK(BM_ComputeArea)->ArgsProduct({kVertexCounts});
+
+static void BM_HullDescriptors(benchmark::State &state) {
+  // Uncached: the whole rotating calipers pass
+  std::vector<Point> vertices = regularPolygon(state.range(0), 0., 0., 1.);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        computeHullDescriptors(vertices.data(), vertices.size()));
+  }
+}
+BENCHMARK(BM_HullDescriptors)->ArgsProduct({kVertexCounts});
+
+static void BM_ConvexHullsFromJson(benchmark::State &state) {
+  json data = hullsJson(state.range(0), state.range(1));
+  for (auto _ : state) {
+    std::vector<ConvexHull> hulls = convexHullsFromJson(data);
+    benchmark::DoNotOptimize(hulls.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvexHullsFromJson)->ArgsProduct({{10, 1000}, {4, 16, 64}});
+
+static void BM_ConvexHullsToJson(benchmark::State &state) {
+  std::vector<ConvexHull> hulls =
+      convexHullsFromJson(hullsJson(state.range(0), state.range(1)));
+  for (auto _ : state) {
+    json data = convexHullsToJson(hulls);
+    benchmark::DoNotOptimize(data);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConvexHullsToJson)->ArgsProduct({{10, 1000}, {4, 16, 64}});
+
+static void BM_JsonParseAndDump(benchmark::State &state) {
+  std::string text = hullsJson(state.range(0), state.range(1)).dump(4);
+  for (auto _ : state) {
+    json data = json::parse(text);
+    std::string out = data.dump(4);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_JsonParseAndDump)->ArgsProduct({{10, 1000}, {4, 16, 64}});
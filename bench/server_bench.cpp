@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <binary_format.hpp>
+#include <hull_generator.hpp>
+#include <hull_server.hpp>
+
+// Round trip latency of small frames sent to a HullServer running in the
+// same process, against the same frame processed in process. The argument is
+// the number of hulls of the frame.
+
+namespace {
+std::vector<ConvexHull> frameHulls(int count) {
+  HullGeneratorOptions options;
+  options.count = count;
+  options.seed = 7;
+  return generateConvexHulls(options);
+}
+
+// Server shared by all the benchmarks
+HullServer *getServer(std::string *socket_path) {
+  static std::string path =
+      "/tmp/server_bench_" + std::to_string(getpid()) + ".sock";
+  static HullServer *server = [] {
+    HullServerOptions options;
+    options.socket_path = path;
+    HullServer *s = new HullServer(options);
+    std::string error;
+    if (!s->start(&error)) {
+      delete s;
+      return static_cast<HullServer *>(nullptr);
+    }
+    return s;
+  }();
+  *socket_path = path;
+  return server;
+}
+
+template <MessageKind kKind>
+void serverRoundTrip(benchmark::State &state) {
+  std::string socket_path, error;
+  HullClient client;
+  if (getServer(&socket_path) == nullptr ||
+      !client.connect(socket_path, &error)) {
+    state.SkipWithError("the server could not be started");
+    return;
+  }
+  std::vector<ConvexHull> hulls = frameHulls(state.range(0));
+  std::string payload, response;
+  if (kKind == kMessageJson)
+    payload = convexHullsToJson(hulls).dump();
+  else
+    encodeHulls(hulls, &payload);
+  MessageKind response_kind;
+  for (auto _ : state) {
+    client.request(kKind, payload, &response_kind, &response);
+    benchmark::DoNotOptimize(response.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+}  // namespace
+
+static void BM_ServerRoundTripJson(benchmark::State &state) {
+  serverRoundTrip<kMessageJson>(state);
+}
+BENCHMARK(BM_ServerRoundTripJson)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+static void BM_ServerRoundTripBinary(benchmark::State &state) {
+  serverRoundTrip<kMessageBinary>(state);
+}
+BENCHMARK(BM_ServerRoundTripBinary)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+static void BM_InProcessJson(benchmark::State &state) {
+  // What the server does for a json request, without the socket
+  std::string payload = convexHullsToJson(frameHulls(state.range(0))).dump();
+  for (auto _ : state) {
+    std::vector<ConvexHull> hulls = convexHullsFromJson(json::parse(payload));
+    std::string response =
+        convexHullsToJson(eliminateOverlappingCHulls(&hulls, 0.5)).dump();
+    benchmark::DoNotOptimize(response.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_InProcessJson)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,67 @@
+#ifndef INCLUDE_BATCH_HPP_
+#define INCLUDE_BATCH_HPP_
+
+#include <functional>
+#include <json.hpp>
+#include <string>
+#include <thread_pool.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+/**
+ * Batch processing of many hull files in one process. Every file is read,
+ * processed and written by a task of a shared ThreadPool, and several files
+ * are in flight at once, so the reads, the eliminations and the writes of
+ * different files overlap. The number of files in flight is bounded, so the
+ * memory use does not depend on the number of files.
+ */
+
+/**
+ * Outcome of a batch. Failures (missing or malformed files, unwritable
+ * outputs) are recorded and the remaining files are still processed.
+ */
+struct BatchResult {
+ public:
+  int n_files;
+  int n_failed;
+  std::vector<std::string> errors;  // "<input>: <reason>" for every failure
+  BatchResult() : n_files(0), n_failed(0) {}
+};
+
+/**
+ * Expands the input arguments into a list of files. Each argument is a
+ * path, a glob pattern (expanded and sorted, e.g. "frames/frame_*.json") or
+ * "@list.txt", a file with one path or pattern per line. Patterns without
+ * any match are kept as they are, so they are reported as missing files.
+ * @param arguments: Input arguments.
+ * @return the files, in the order of the arguments
+ */
+std::vector<std::string> expandInputs(
+    const std::vector<std::string> &arguments);
+
+/**
+ * @param input: Input file.
+ * @param output_dir: Output directory.
+ * @return output_dir/<file name of input>
+ */
+std::string batchOutputPath(const std::string &input,
+                            const std::string &output_dir);
+
+/**
+ * Reads every input json, applies process to it and writes the result to
+ * batchOutputPath(input, output_dir).
+ * @param inputs: Input files.
+ * @param output_dir: Existing output directory.
+ * @param process: Called concurrently on the parsed json of every file.
+ * @param pool: Thread pool that runs the files.
+ * @param max_in_flight: Largest number of files being processed at once. 0
+ * uses twice the number of threads of the pool.
+ * @return the number of files and the failures
+ */
+BatchResult processBatch(const std::vector<std::string> &inputs,
+                         const std::string &output_dir,
+                         const std::function<json(const json &)> &process,
+                         ThreadPool *pool, int max_in_flight = 0);
+
+#endif  //  INCLUDE_BATCH_HPP_
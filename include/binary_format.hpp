@@ -0,0 +1,44 @@
+#ifndef INCLUDE_BINARY_FORMAT_HPP_
+#define INCLUDE_BINARY_FORMAT_HPP_
+
+#include <convex_hull.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary encoding of a set of convex hulls, an alternative to the
+ * json format when parsing dominates (e.g. small frames sent to the server).
+ * All the fields are in host byte order:
+ *   uint32 magic ("CHB1"), uint32 number of hulls, then for every hull
+ *   int32 ID, uint32 number of apexes, and the apexes as (double x, double y)
+ * Sets where some hull has cached descriptors are written as "CHB2", where
+ * every hull also has a uint32 flags field after its number of apexes and,
+ * when flag kBinaryHullHasDescriptors is set, its descriptors after the
+ * apexes as 9 doubles: diameter, min width, centroid (x, y), rectangle
+ * center (x, y), half x, half y and yaw. The decoder caches them as they
+ * are read; the broad phase checks them against the apexes before use.
+ */
+
+const uint32_t kBinaryHullsMagic = 0x31424843;    // "CHB1" in little endian
+const uint32_t kBinaryHullsMagicV2 = 0x32424843;  // "CHB2" in little endian
+const uint32_t kBinaryHullHasDescriptors = 1;
+
+/**
+ * Encodes hulls in the binary format.
+ * @param hulls: Convex hulls.
+ * @param out: Replaced by the encoded bytes (its capacity is reused).
+ */
+void encodeHulls(const std::vector<ConvexHull> &hulls, std::string *out);
+
+/**
+ * Decodes hulls from the binary format (either version).
+ * @param data: Encoded bytes.
+ * @param size: Number of bytes.
+ * @param hulls: Replaced by the decoded hulls.
+ * @return false if the data is not a complete, valid encoding (hulls of
+ * fewer than 3 apexes and non-finite coordinates are invalid)
+ */
+bool decodeHulls(const char *data, size_t size, std::vector<ConvexHull> *hulls);
+
+#endif  //  INCLUDE_BINARY_FORMAT_HPP_
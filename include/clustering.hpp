@@ -0,0 +1,79 @@
+#ifndef INCLUDE_CLUSTERING_HPP_
+#define INCLUDE_CLUSTERING_HPP_
+
+#include <atomic>
+#include <convex_hull.hpp>
+#include <memory>
+#include <thread_pool.hpp>
+#include <vector>
+
+/**
+ * Lock-free disjoint sets of the indices [0, n), safe to use from several
+ * threads at once. The parent of every index is never larger than the index,
+ * so the root of a set is always its smallest member. find halves the path
+ * with compare and swap, and unite links the larger root under the smaller
+ * one, retrying when another thread changed the root in between. No lock is
+ * taken, and the final sets do not depend on the order of the unions.
+ */
+class ConcurrentUnionFind {
+ public:
+  explicit ConcurrentUnionFind(int n);
+
+  ConcurrentUnionFind(const ConcurrentUnionFind &) = delete;
+  ConcurrentUnionFind &operator=(const ConcurrentUnionFind &) = delete;
+
+  int getSize() const { return n_; }
+
+  /**
+   * @param i: Index in [0, n).
+   * @return the root of the set of i, its smallest member once every
+   * concurrent unite has returned
+   */
+  int find(int i);
+
+  /**
+   * Merges the sets of i and j.
+   * @return true if they were in different sets
+   */
+  bool unite(int i, int j);
+
+ private:
+  int n_;
+  std::unique_ptr<std::atomic<int>[]> parent_;
+};
+
+/**
+ * Connected components of an overlap graph: labels[i] is the cluster of hull
+ * i. Clusters are numbered 0 .. n_clusters - 1 by their first member.
+ */
+struct HullClusters {
+ public:
+  std::vector<int> labels;
+  int n_clusters;
+  HullClusters() : n_clusters(0) {}
+
+  int getNClusters() const { return n_clusters; }
+};
+
+/**
+ * Groups the hulls into clusters of (transitively) overlapping hulls. Two
+ * hulls are connected when their intersection area is larger than
+ * min_intersection_area. The candidate pairs come from a SpatialHashGrid
+ * over the bounding boxes, and the intersections are computed in parallel
+ * on the pool (row blocks), each chunk uniting the pairs it finds in a
+ * shared ConcurrentUnionFind. The labels do not depend on the number of
+ * threads.
+ * @param hulls: Vector of Convex Hulls.
+ * @param min_intersection_area: Intersection area above which two hulls are
+ * in the same cluster (0 connects every overlapping pair).
+ * @param pool: Thread pool to run on, nullptr runs on the calling thread.
+ * @param cell_size: Cell size of the spatial index, in the order of the
+ * typical convex hull size.
+ * @return the cluster of every hull
+ */
+HullClusters clusterOverlappingCHulls(std::vector<ConvexHull> *hulls,
+                                      double min_intersection_area = 0.,
+                                      ThreadPool *pool = nullptr,
+                                      double cell_size = 10.);
+
+#endif  //  INCLUDE_CLUSTERING_HPP_
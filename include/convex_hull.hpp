@@ -3,22 +3,30 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <json.hpp>
 #include <ostream>
+#include <small_vector.hpp>
 #include <vector>
-struct Point {
+
+// All the geometry is templated on the scalar type T. The double
+// instantiation (Point, Line, Matrix, ConvexHull) is the default one, the
+// float one (PointF, ConvexHullF, ...) halves the memory of sensor-frame data.
+// Both are explicitly instantiated in convex_hull.cpp.
+template <typename T>
+struct PointT {
  public:
-  double x, y, angle;
-  Point() : x(0), y(0), angle(0) {}
-  Point(double x_, double y_) : x(x_), y(y_) { computeAngle(); }
+  T x, y, angle;
+  PointT() : x(0), y(0), angle(0) {}
+  PointT(T x_, T y_) : x(x_), y(y_) { computeAngle(); }
 
   // get angle between this point and another.
   // Will be used to organize points CCW
-  double get_angle(Point &P) {
+  T get_angle(PointT &P) {
     // check to make sure the angle won't be "0"
     if (P.x == x) {
       return 0;
@@ -26,65 +34,67 @@ struct Point {
 
     return (std::atan2((P.y - y), (P.x - x)));
   }
-  void set_angle(double d) { angle = d; }
+  void set_angle(T d) { angle = d; }
   void computeAngle() { angle = std::atan2(y, x); }
 
   // for sorting based on angles
-  bool operator<(const Point &p) const { return (angle < p.angle); }
+  bool operator<(const PointT &p) const { return (angle < p.angle); }
 
-  Point operator*(const double &scalar) {
-    Point res;
+  PointT operator*(const T &scalar) {
+    PointT res;
     res.x = x * scalar;
     res.y = y * scalar;
     return res;
   }
 
-  Point operator+(const Point &P) {
-    Point res;
+  PointT operator+(const PointT &P) {
+    PointT res;
     res.x = x + P.x;
     res.y = y + P.y;
     res.computeAngle();
     return res;
   }
 
-  Point operator-(const Point &P) {
-    Point res;
+  PointT operator-(const PointT &P) {
+    PointT res;
     res.x = x - P.x;
     res.y = y - P.y;
     res.computeAngle();
     return res;
   }
 
-  Point(const Point &other) = default;
-  Point &operator=(const Point &other) = default;
+  PointT(const PointT &other) = default;
+  PointT &operator=(const PointT &other) = default;
 
-  friend std::ostream &operator<<(std::ostream &stream, const Point &P) {
+  friend std::ostream &operator<<(std::ostream &stream, const PointT &P) {
     stream << "(" << std::setprecision(8) << P.x << ", " <<  std::setprecision(8)<< P.y << ")";
     return stream;
   }
 };
 
-struct Line {
+template <typename T>
+struct LineT {
  public:
-  Point p1, p2;
-  Line(Point &p1_, Point &p2_) : p1(p1_), p2(p2_) {}
-  Line() {}
-  Line(const Line &other) = default;
-  Line &operator=(const Line &other) = default;
+  PointT<T> p1, p2;
+  LineT(const PointT<T> &p1_, const PointT<T> &p2_) : p1(p1_), p2(p2_) {}
+  LineT() {}
+  LineT(const LineT &other) = default;
+  LineT &operator=(const LineT &other) = default;
 };
 
-struct Matrix {
+template <typename T>
+struct MatrixT {
  public:
-  double x_00, x_01, x_10, x_11;
-  Matrix() : x_00(0.), x_01(0.), x_10(0.), x_11(0.) {}
-  Matrix(const Point &P1, const Point &P2)
+  T x_00, x_01, x_10, x_11;
+  MatrixT() : x_00(0.), x_01(0.), x_10(0.), x_11(0.) {}
+  MatrixT(const PointT<T> &P1, const PointT<T> &P2)
       : x_00(P1.x), x_01(P2.x), x_10(P1.y), x_11(P2.y) {}
 
-  Matrix(const Matrix &other) = default;
-  Matrix &operator=(const Matrix &other) = default;
+  MatrixT(const MatrixT &other) = default;
+  MatrixT &operator=(const MatrixT &other) = default;
 
-  Matrix operator+(Matrix const &obj) {
-    Matrix res;
+  MatrixT operator+(MatrixT const &obj) {
+    MatrixT res;
     res.x_00 = x_00 + obj.x_00;
     res.x_01 = x_01 + obj.x_01;
     res.x_10 = x_10 + obj.x_10;
@@ -92,84 +102,172 @@ struct Matrix {
     return res;
   }
 
-  Matrix operator*(double const &scalar) {
-    Matrix res;
+  MatrixT operator*(T const &scalar) {
+    MatrixT res;
     res.x_00 = scalar * x_00;
     res.x_01 = scalar * x_01;
     res.x_10 = scalar * x_10;
     res.x_11 = scalar * x_11;
     return res;
   }
-  friend std::ostream &operator<<(std::ostream &stream, const Matrix &M) {
+  friend std::ostream &operator<<(std::ostream &stream, const MatrixT &M) {
     stream << "\n[" << M.x_00 << ", " << M.x_01 << "]"
            << "\n[" << M.x_10 << ", " << M.x_11 << "]\n";
     return stream;
   }
 
-  double getDeterminant() { return x_00 * x_11 - x_01 * x_10; }
+  T getDeterminant() { return x_00 * x_11 - x_01 * x_10; }
+};
+
+/**
+ * Shape descriptors of a convex hull (see shape_descriptors.hpp): diameter
+ * (largest distance between two vertices), minimum width (smallest distance
+ * between two parallel supporting lines), area centroid and minimum area
+ * bounding rectangle. The rectangle is stored like an OrientedBox: center,
+ * half extents along its own axes and yaw.
+ */
+template <typename T>
+struct HullDescriptorsT {
+ public:
+  T diameter, min_width;
+  PointT<T> centroid;
+  PointT<T> rect_center;
+  T rect_half_x, rect_half_y, rect_yaw;
+  HullDescriptorsT()
+      : diameter(0), min_width(0), rect_half_x(0), rect_half_y(0),
+        rect_yaw(0) {}
+
+  T getRectArea() const { return 4 * rect_half_x * rect_half_y; }
 };
 
-class ConvexHull {
+// Hulls with up to this many vertices keep them inline, without any heap
+// allocation. Larger hulls fall back to the heap. Edges are not stored:
+// getSegment builds them from the apexes.
+const int kInlineApexes = 16;
+
+template <typename T>
+class ConvexHullT {
  public:
-  std::vector<Point> apex;
-  std::vector<Line> line_segments;
+  typedef T Scalar;
+  typedef SmallVector<PointT<T>, kInlineApexes> ApexVector;
+  ApexVector apex;
 
-  double area;
+  T area;
   int id;
-  ConvexHull();
-  ConvexHull(std::vector<Point> const &apex_, int id_);
-  ConvexHull(const ConvexHull &other) = default;
-  ConvexHull &operator=(const ConvexHull &other) = default;
+  ConvexHullT();
+  ConvexHullT(std::vector<PointT<T>> const &apex_, int id_);
+  /**
+   * @param apex_: Pointer to the C. Hull vertices ordered CCW
+   * @param n_apexes: Number of vertices
+   * @param id_: Convex Hull ID
+   */
+  ConvexHullT(const PointT<T> *apex_, int n_apexes, int id_);
+  ConvexHullT(const ConvexHullT &other) = default;
+  ConvexHullT(ConvexHullT &&other) = default;
+  ConvexHullT &operator=(const ConvexHullT &other) = default;
+  ConvexHullT &operator=(ConvexHullT &&other) = default;
 
-  double getArea();
+  T getArea();
 
   int getNvertices();
   int getNSegments();
 
+  /**
+   * @param i: Edge index, in [0, getNSegments()).
+   * @return the edge from apex[i] to the next apex (apex[0] for the last)
+   */
+  LineT<T> getSegment(int i) const {
+    return LineT<T>(apex[i], apex[i + 1 == apex.size() ? 0 : i + 1]);
+  }
+
+  /**
+   * Shape descriptors, computed with computeHullDescriptors on the first
+   * call and cached. set_apexes drops the cache.
+   * @return the cached descriptors
+   */
+  const HullDescriptorsT<T> &getDescriptors();
+
+  /**
+   * Descriptors cached by getDescriptors or setDescriptors, without
+   * computing them.
+   * @return the cached descriptors, or nullptr if there are none
+   */
+  const HullDescriptorsT<T> *getCachedDescriptors() const {
+    return has_descriptors_ ? &descriptors_ : nullptr;
+  }
+
+  /**
+   * Caches descriptors read from a file or a message as they are. Nothing
+   * checks them against the apexes here: the broad phase does it before
+   * using them (see trustedMinAreaRectangle in obb.hpp).
+   * @param descriptors: Descriptors of this hull.
+   */
+  void setDescriptors(const HullDescriptorsT<T> &descriptors) {
+    descriptors_ = descriptors;
+    has_descriptors_ = true;
+  }
+
   /**
    * Fill an empty convex hull with its apexes.
    * @param apex_: Vector of points (C. Hull vertices ordered CCW)
    **/
-  void set_apexes(std::vector<Point> const &apex_);
+  void set_apexes(std::vector<PointT<T>> const &apex_);
 
   /**
    * Uses the Ray casting algorithm:
    *https://en.wikipedia.org/wiki/Point_in_polygon to determine if a Point is
    *inside this Convex Hull
    **/
-  bool isPointInside(const Point &P);
+  bool isPointInside(const PointT<T> &P);
 
  private:
   /**
       * Area of convex polygon computed following this approach
   https://byjus.com/maths/convex-polygon/ We compute and add the area of the
   inner triangles of the c. hull to get its total area. \return convex hull area
-  (double)
+  (T)
   **/
   void computeArea();
-  /**
-   * Fills an internal class member: line_segments with the lines or "edges"
-   * conecting each polygon vertex
-   */
-  void computeLineSegments();
+
+  // Cached shape descriptors, valid when has_descriptors_ is set
+  HullDescriptorsT<T> descriptors_;
+  bool has_descriptors_;
 };
 
+using Point = PointT<double>;
+using Line = LineT<double>;
+using Matrix = MatrixT<double>;
+using HullDescriptors = HullDescriptorsT<double>;
+using ConvexHull = ConvexHullT<double>;
+
+using PointF = PointT<float>;
+using LineF = LineT<float>;
+using MatrixF = MatrixT<float>;
+using HullDescriptorsF = HullDescriptorsT<float>;
+using ConvexHullF = ConvexHullT<float>;
+
 using json = nlohmann::json;
 
 /**
   Reads a Json file with convexHull information and stores the data in a vector
-  of ConvexHull class
+  of ConvexHull class. Hulls that carry "descriptors" get them cached as
+  they are read (see ConvexHullT::setDescriptors). Throws
+  std::invalid_argument for a hull with fewer than 3 apexes or a non-finite
+  coordinate.
   @param data: json object with convex hull data
-  @return vector of ConvexHull
+  @return vector of ConvexHull (convexHullsFromJson<float> for ConvexHullF)
 **/
-std::vector<ConvexHull> convexHullsFromJson(const json &data);
+template <typename T = double>
+std::vector<ConvexHullT<T>> convexHullsFromJson(const json &data);
 
 /**
- *Creates a json object with data from a vector of convexhulls
+ *Creates a json object with data from a vector of convexhulls. Cached
+ *descriptors are written under "descriptors".
  *@param c_hull_vector: Vector to put in Json object
  *@return json object with the data
  */
-json convexHullsToJson(const std::vector<ConvexHull> &c_hull_vector);
+template <typename T>
+json convexHullsToJson(const std::vector<ConvexHullT<T>> &c_hull_vector);
 
 /**
     This Function uses the ray-casting algorithm to decide whether the point is
@@ -181,30 +279,52 @@ json convexHullsToJson(const std::vector<ConvexHull> &c_hull_vector);
     @param P: The Point that is being tested.
     @return true or false
 */
-bool pointInPolygon(std::vector<Point> const &vertices, const Point P);
+template <typename T>
+bool pointInPolygon(std::vector<PointT<T>> const &vertices, const PointT<T> P);
+
+/**
+ * Same as above, for vertices stored in any contiguous buffer.
+ * @param vertices: Pointer to the vertices of the Polygon.
+ * @param n_vertices: Number of vertices.
+ * @param P: The Point that is being tested.
+ * @return true or false
+ */
+template <typename T>
+bool pointInPolygon(const PointT<T> *vertices, int n_vertices,
+                    const PointT<T> P);
 
 /**
- * Check if two Line segments insertect
- *@param vertices: Vertices of the Polygon
+ * Check if two Line segments insertect. The test uses exact orientation
+ * predicates (see predicates.hpp), so it does not depend on a tolerance or
+ * on the scale of the coordinates. Touching segments intersect, collinear
+ * ones do not.
  *@param L1: First Line Segment to test.
  *@param L2: Second Line Segment to test.
  *@param intersect_point: The intersection point data (if it exists) will be
  *copied here.
- *@param epsilon: The tolerance used when comparing floating point substraction
- *results to 0
  *@return true or false
  */
-bool segmentsIntersect(Line *L1, Line *L2, Point *intersect_point,
+template <typename T>
+bool segmentsIntersect(LineT<T> *L1, LineT<T> *L2, PointT<T> *intersect_point);
+
+/**
+ * Same as above. The epsilon used to be the tolerance of the (floating point)
+ * parallel test; the exact predicates do not need it and it is ignored.
+ */
+template <typename T>
+bool segmentsIntersect(LineT<T> *L1, LineT<T> *L2, PointT<T> *intersect_point,
                        const double &epsilon);
 
 /**
- * Sorts a vector of Points CCW by setting one Point as "center", and checking
- * the angle difference between said point and the rest. The points are then
- * arranged based on the pair-wise angle different between each point and the
- * "Center".
+ * Sorts a vector of Points CCW by setting the centroid of the points as
+ * "center", and checking the angle between said center and each point. The
+ * points are then arranged based on their angle around the "Center". Since
+ * the centroid of a convex polygon's vertices lies inside it, the angles never
+ * wrap around.
  * @param point_vector: Vector of points to sort CCW
  */
-void sortPointsCCW(std::vector<Point> *point_vector);
+template <typename T>
+void sortPointsCCW(std::vector<PointT<T>> *point_vector);
 
 /**
  * If two polygons intersect, returns a non-ordered list of vertices
@@ -214,8 +334,9 @@ void sortPointsCCW(std::vector<Point> *point_vector);
  * @param C2: Convex Hull to check for intersection.
  * @returns
  */
-std::vector<Point> getIntersectionPolygonVertices(ConvexHull *C1,
-                                                  ConvexHull *C2);
+template <typename T>
+std::vector<PointT<T>> getIntersectionPolygonVertices(ConvexHullT<T> *C1,
+                                                      ConvexHullT<T> *C2);
 
 /**
  * If two polygons intersect, stores the corresponding polygon created by the
@@ -225,8 +346,20 @@ std::vector<Point> getIntersectionPolygonVertices(ConvexHull *C1,
  * @param Intersection: Intersecting polygon (if it exists) data is stored here
  * @returns true or false, f the polygons intersect or not
  */
-bool getIntersectingPolygon(ConvexHull *C1, ConvexHull *C2,
-                            ConvexHull *Intersection);
+template <typename T>
+bool getIntersectingPolygon(ConvexHullT<T> *C1, ConvexHullT<T> *C2,
+                            ConvexHullT<T> *Intersection);
+
+/**
+ * Area of the polygon formed by the intersection of two convex hulls.
+ * Triangle and quadrilateral pairs are dispatched to the fully unrolled
+ * kernels of hull_kernels.hpp, the rest goes through getIntersectingPolygon.
+ * @param C1: Convex Hull to check for intersection.
+ * @param C2: Convex Hull to check for intersection.
+ * @returns the intersection area, 0 if the hulls do not intersect
+ */
+template <typename T>
+T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2);
 
 /**
  * Compute and find the vertices from each polygon/c. hull that is contained in
@@ -240,7 +373,8 @@ bool getIntersectingPolygon(ConvexHull *C1, ConvexHull *C2,
  * necessary to consider it "eliminated"
  * @returns Vector of remaining polygons/C. Hulls.
  */
-std::vector<ConvexHull> eliminateOverlappingCHulls(
-    std::vector<ConvexHull> *input, double overlapping_percent);
+template <typename T>
+std::vector<ConvexHullT<T>> eliminateOverlappingCHulls(
+    std::vector<ConvexHullT<T>> *input, double overlapping_percent);
 
 #endif  //  INCLUDE_CONVEX_HULL_HPP_
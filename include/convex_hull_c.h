@@ -0,0 +1,106 @@
+#ifndef INCLUDE_CONVEX_HULL_C_H_
+#define INCLUDE_CONVEX_HULL_C_H_
+
+/*
+ * Stable C ABI of the convex hull library, for embedding without json files.
+ *
+ * Hulls are described by caller owned flat arrays: the interleaved vertex
+ * coordinates xy = (x0, y0, x1, y1, ...) of all the hulls one after the
+ * other, and offsets[n_hulls + 1], where hull h has the vertices
+ * offsets[h] .. offsets[h + 1] - 1. A ch_hullset reads these arrays in place
+ * (it only stores a bounding box and an area per hull), so they must stay
+ * alive and unchanged until the set is destroyed. Results are written to
+ * caller provided arrays, and no function throws or aborts: every error is a
+ * ch_status. Only opaque handles, fixed width integers and doubles cross the
+ * boundary, so the ABI does not depend on the C++ compiler or standard
+ * library.
+ */
+
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define CH_API __attribute__((visibility("default")))
+#else
+#define CH_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented on every incompatible change of this header */
+#define CH_API_VERSION 1
+
+typedef enum {
+  CH_OK = 0,
+  CH_ERROR_INVALID_ARGUMENT = 1, /* null pointer, bad offsets or index */
+  CH_ERROR_OUT_OF_MEMORY = 2
+} ch_status;
+
+typedef struct ch_hullset ch_hullset;
+
+/* CH_API_VERSION of the library, to check it against the header */
+CH_API int32_t ch_api_version(void);
+
+/* Static description of a status, never null */
+CH_API const char *ch_status_string(ch_status status);
+
+/*
+ * Creates a hull set over caller owned buffers (not copied).
+ * xy: interleaved vertex coordinates, 2 * offsets[n_hulls] doubles.
+ * offsets: n_hulls + 1 non decreasing vertex offsets, offsets[0] = 0, and
+ *   every hull with at least 3 vertices.
+ * ids: n_hulls hull IDs, or null to use the indices.
+ * n_hulls: number of hulls (>= 0).
+ * out_set: receives the set, to be released with ch_hullset_destroy.
+ */
+CH_API ch_status ch_hullset_create_from_buffers(const double *xy,
+                                                const int32_t *offsets,
+                                                const int32_t *ids,
+                                                int32_t n_hulls,
+                                                ch_hullset **out_set);
+
+/* Releases a set (null is ignored). The buffers are not touched. */
+CH_API void ch_hullset_destroy(ch_hullset *set);
+
+/* Number of hulls of a set (0 for null) */
+CH_API int32_t ch_hullset_size(const ch_hullset *set);
+
+/* ID of hull index (its index if the set has no IDs) */
+CH_API ch_status ch_hull_id(const ch_hullset *set, int32_t index,
+                            int32_t *out_id);
+
+/* Area of hull index */
+CH_API ch_status ch_hull_area(const ch_hullset *set, int32_t index,
+                              double *out_area);
+
+/* Area of the intersection of the hulls i and j of a set */
+CH_API ch_status ch_intersection_area(const ch_hullset *set, int32_t i,
+                                      int32_t j, double *out_area);
+
+/*
+ * Area of the intersection of two convex polygons given by interleaved
+ * coordinates, without building a set. Vertices can be CW or CCW.
+ */
+CH_API ch_status ch_polygon_intersection_area(const double *xy_a, int32_t n_a,
+                                              const double *xy_b, int32_t n_b,
+                                              double *out_area);
+
+/*
+ * Eliminates overlapping hulls with eliminateOverlappingCHulls (the same
+ * implementation and result as the C++ API): a hull is removed when its
+ * intersection with any other hull covers more than overlapping_percent of
+ * its area. The vertices are copied once for the call.
+ * out_kept: room for ch_hullset_size(set) indices; receives the indices of
+ *   the remaining hulls, in increasing order.
+ * out_n_kept: receives the number of remaining hulls.
+ */
+CH_API ch_status ch_eliminate(const ch_hullset *set,
+                              double overlapping_percent, int32_t *out_kept,
+                              int32_t *out_n_kept);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_CONVEX_HULL_C_H_ */
@@ -0,0 +1,111 @@
+#ifndef INCLUDE_CONVEX_HULL_VIEW_HPP_
+#define INCLUDE_CONVEX_HULL_VIEW_HPP_
+
+#include <convex_hull.hpp>
+#include <spatial_index.hpp>
+#include <vector>
+
+/**
+ * Non-owning convex hull: a pointer to vertices stored elsewhere (a shared
+ * buffer, the apexes of a ConvexHullT, ...) plus their count, with the area
+ * and the bounding box computed once at construction. Copying a view never
+ * copies vertices, so it is cheap to pass around and to store. The vertices
+ * must stay alive and unchanged while the view is in use.
+ */
+template <typename T>
+struct ConvexHullViewT {
+ public:
+  typedef T Scalar;
+  const PointT<T> *apex;
+  int n_apexes;
+  int id;
+  T area;
+  BoundingBox bounds;
+
+  ConvexHullViewT() : apex(nullptr), n_apexes(0), id(0), area(0) {}
+  /**
+   * @param apex_: Pointer to the C. Hull vertices ordered CCW (or CW)
+   * @param n_apexes_: Number of vertices (at least 3)
+   * @param id_: Convex Hull ID
+   */
+  ConvexHullViewT(const PointT<T> *apex_, int n_apexes_, int id_);
+  // Views the apexes of a hull, which must outlive the view
+  explicit ConvexHullViewT(const ConvexHullT<T> &hull);
+
+  T getArea() const { return area; }
+  int getNvertices() const { return n_apexes; }
+  const PointT<T> &operator[](int i) const { return apex[i]; }
+
+  // Same test as ConvexHullT::isPointInside
+  bool isPointInside(const PointT<T> &P) const;
+};
+
+using ConvexHullView = ConvexHullViewT<double>;
+using ConvexHullViewF = ConvexHullViewT<float>;
+
+/**
+ * Views of hulls whose vertices are stored one after the other in a single
+ * buffer: hull h has the vertices offsets[h] .. offsets[h + 1] - 1.
+ * @param vertices: Shared vertex buffer.
+ * @param offsets: n_hulls + 1 non decreasing offsets, offsets[0] = 0.
+ * @param ids: n_hulls hull IDs, or nullptr to use the indices.
+ * @param n_hulls: Number of hulls.
+ * @return one view per hull
+ */
+template <typename T>
+std::vector<ConvexHullViewT<T>> makeConvexHullViews(const PointT<T> *vertices,
+                                                    const int *offsets,
+                                                    const int *ids,
+                                                    int n_hulls);
+
+/**
+ * Views of the apexes of every hull of a vector, which must not be modified
+ * while the views are in use.
+ */
+template <typename T>
+std::vector<ConvexHullViewT<T>> makeConvexHullViews(
+    const std::vector<ConvexHullT<T>> &hulls);
+
+/**
+ * Same as getIntersectionPolygonVertices for hulls, with the edges taken
+ * directly from the viewed vertices.
+ */
+template <typename T>
+std::vector<PointT<T>> getIntersectionPolygonVertices(
+    const ConvexHullViewT<T> *C1, const ConvexHullViewT<T> *C2);
+
+/**
+ * Same as intersectionArea for hulls: unrolled kernels for triangles and
+ * quadrilaterals, the sorted intersection vertices for the rest. Hulls whose
+ * bounding boxes do not overlap are rejected without looking at the vertices.
+ * @param C1: Convex Hull to check for intersection.
+ * @param C2: Convex Hull to check for intersection.
+ * @returns the intersection area, 0 if the hulls do not intersect
+ */
+template <typename T>
+T intersectionArea(const ConvexHullViewT<T> *C1, const ConvexHullViewT<T> *C2);
+
+/**
+ * eliminateOverlappingCHulls over views: same result, and neither the input
+ * nor the output copies any vertex.
+ * @param input: Vector of views.
+ * @param overlapping_percent: How much % of the overlaped area of a polygon is
+ * necessary to consider it "eliminated"
+ * @returns Views of the remaining hulls.
+ */
+template <typename T>
+std::vector<ConvexHullViewT<T>> eliminateOverlappingCHulls(
+    std::vector<ConvexHullViewT<T>> *input, double overlapping_percent);
+
+// Bounding box of a hull, computed for owning hulls and cached for views
+template <typename T>
+BoundingBox hullBounds(const ConvexHullT<T> &hull) {
+  return computeBoundingBox(hull.apex);
+}
+
+template <typename T>
+const BoundingBox &hullBounds(const ConvexHullViewT<T> &hull) {
+  return hull.bounds;
+}
+
+#endif  //  INCLUDE_CONVEX_HULL_VIEW_HPP_
@@ -0,0 +1,101 @@
+#ifndef INCLUDE_GJK_HPP_
+#define INCLUDE_GJK_HPP_
+
+#include <convex_hull.hpp>
+#include <convex_hull_view.hpp>
+#include <thread_pool.hpp>
+#include <vector>
+
+/**
+ * Proximity of two convex hulls A and B: their distance when they are
+ * separated, the depth of their overlap when they intersect.
+ */
+template <typename T>
+struct HullProximityT {
+ public:
+  bool overlapping;
+  T distance;         // 0 when overlapping
+  T penetration;      // 0 when separated
+  // Unit vector from A towards B: moving B by distance * normal makes the
+  // hulls touch when separated, by penetration * normal when overlapping
+  PointT<T> normal;
+  PointT<T> point_a, point_b;  // closest points (equal when overlapping)
+  int n_iterations;            // GJK + EPA iterations
+
+  HullProximityT()
+      : overlapping(false), distance(0), penetration(0), n_iterations(0) {}
+};
+
+using HullProximity = HullProximityT<double>;
+using HullProximityF = HullProximityT<float>;
+
+/**
+ * Distance between two convex polygons with the Gilbert-Johnson-Keerthi
+ * algorithm on their Minkowski difference A - B, and, when they overlap,
+ * penetration depth with the Expanding Polytope Algorithm. The vertices
+ * can be ordered CCW or CW.
+ *
+ * The support point of a polygon in a direction is found by hill climbing
+ * along the apex list, which is unimodal for a convex polygon: the first
+ * query starts from the best of about sqrt(n) evenly spaced vertices, the
+ * next ones from the previous support vertex, since the search direction
+ * converges. A query never reads all the vertices of large polygons.
+ * @param A: Vertices of the first polygon.
+ * @param n: Number of vertices of the first polygon.
+ * @param B: Vertices of the second polygon.
+ * @param m: Number of vertices of the second polygon.
+ * @param compute_penetration: Run EPA for overlapping polygons (otherwise
+ * their penetration is left at 0).
+ * @return the proximity of the polygons
+ */
+template <typename T>
+HullProximityT<T> polygonProximity(const PointT<T> *A, int n,
+                                   const PointT<T> *B, int m,
+                                   bool compute_penetration = true);
+
+template <typename T>
+HullProximityT<T> hullProximity(const ConvexHullT<T> &A,
+                                const ConvexHullT<T> &B,
+                                bool compute_penetration = true);
+
+template <typename T>
+HullProximityT<T> hullProximity(const ConvexHullViewT<T> &A,
+                                const ConvexHullViewT<T> &B,
+                                bool compute_penetration = true);
+
+// GJK distance only: 0 for overlapping hulls
+template <typename T>
+T hullDistance(const ConvexHullT<T> &A, const ConvexHullT<T> &B);
+
+/**
+ * Pair of hulls closer than the query distance.
+ */
+struct ProximityEntry {
+ public:
+  int i, j;  // i < j
+  double distance;
+  double penetration;
+  ProximityEntry() : i(0), j(0), distance(0.), penetration(0.) {}
+  ProximityEntry(int i_, int j_, double distance_, double penetration_)
+      : i(i_), j(j_), distance(distance_), penetration(penetration_) {}
+};
+
+/**
+ * Finds every pair of hulls whose distance is at most max_distance
+ * (overlapping pairs included, with distance 0 and their penetration), for
+ * proximity alerts. Candidate pairs come from a SpatialHashGrid over the
+ * bounding boxes, queried with boxes grown by max_distance, and the GJK
+ * queries run in parallel on the pool. The result does not depend on the
+ * number of threads.
+ * @param hulls: Convex hulls.
+ * @param max_distance: Largest distance reported.
+ * @param pool: Thread pool to run on, nullptr runs on the calling thread.
+ * @param cell_size: Cell size of the spatial index, in the order of the
+ * typical convex hull size.
+ * @return the pairs, sorted by i and then by j
+ */
+std::vector<ProximityEntry> findProximityPairs(
+    const std::vector<ConvexHull> &hulls, double max_distance,
+    ThreadPool *pool = nullptr, double cell_size = 10.);
+
+#endif  //  INCLUDE_GJK_HPP_
@@ -0,0 +1,85 @@
+#ifndef INCLUDE_HULL_GENERATOR_HPP_
+#define INCLUDE_HULL_GENERATOR_HPP_
+
+#include <convex_hull.hpp>
+#include <ostream>
+#include <random>
+#include <vector>
+
+/**
+ * Parameters of a synthetic convex hull workload. The same options (and seed)
+ * always produce the same hulls.
+ */
+struct HullGeneratorOptions {
+ public:
+  int count;             // number of convex hulls
+  unsigned seed;         // seed of the random generator
+  int min_vertices;      // vertex count is uniform in [min, max]
+  int max_vertices;
+  double min_radius;     // hull size (circumradius) is log-uniform in
+  double max_radius;     // [min, max]
+  int n_clusters;        // 0 places the hulls uniformly in the world
+  double cluster_spread; // cluster std. deviation, relative to world size
+  // Expected number of hulls whose circumscribed circles overlap a given
+  // hull. The world size is derived from it, so the overlap density stays
+  // the same whatever the count.
+  double overlap_density;
+
+  HullGeneratorOptions()
+      : count(1000),
+        seed(0),
+        min_vertices(3),
+        max_vertices(12),
+        min_radius(0.5),
+        max_radius(3.),
+        n_clusters(0),
+        cluster_spread(0.05),
+        overlap_density(2.) {}
+};
+
+/**
+ * Produces the convex hulls of a workload one at a time, so workloads with
+ * millions of hulls can be streamed to a file without keeping them in memory.
+ * Each hull is a random ellipse sampled at sorted random angles, which is
+ * always convex and ordered CCW.
+ */
+class HullGenerator {
+ public:
+  explicit HullGenerator(const HullGeneratorOptions &options);
+
+  /**
+   * @returns the next convex hull. Ids are consecutive, starting at 0.
+   */
+  ConvexHull next();
+
+  // Side length of the square world the hulls are placed in
+  double getWorldSize() const { return world_size_; }
+
+ private:
+  Point sampleCenter();
+
+  HullGeneratorOptions options_;
+  std::mt19937_64 gen_;
+  double world_size_;
+  std::vector<Point> cluster_centers_;
+  int next_id_;
+};
+
+/**
+ * Generates a whole workload in memory.
+ * @param options: Parameters of the workload.
+ * @returns Vector of convex hulls.
+ */
+std::vector<ConvexHull> generateConvexHulls(
+    const HullGeneratorOptions &options);
+
+/**
+ * Writes a workload straight to a stream in the json format read by
+ * convexHullsFromJson, without building a json object in memory.
+ * @param options: Parameters of the workload.
+ * @param stream: Output stream.
+ */
+void writeGeneratedConvexHullsJson(const HullGeneratorOptions &options,
+                                   std::ostream &stream);
+
+#endif  //  INCLUDE_HULL_GENERATOR_HPP_
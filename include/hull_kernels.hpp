@@ -0,0 +1,253 @@
+#ifndef INCLUDE_HULL_KERNELS_HPP_
+#define INCLUDE_HULL_KERNELS_HPP_
+
+#include <cmath>
+#include <convex_hull.hpp>
+#include <predicates.hpp>
+
+// Cross product (b - a) x (P - a): positive when P is left of a -> b. The
+// sign is exact (robust orientation predicate)
+template <typename T>
+inline double edgeCross(const PointT<T> &a, const PointT<T> &b,
+                        const PointT<T> &P) {
+  return predicates::orient2d(a, b, P);
+}
+
+/**
+ * Kernels for convex polygons whose vertex count N is known at compile time.
+ * Every loop has a constant trip count, so the compiler fully unrolls them,
+ * and the triangle (N = 3) and quadrilateral (N = 4) cases are written out
+ * by hand. The vertices can be ordered CW or CCW.
+ *
+ * The generic API (ConvexHullT::getArea, ConvexHullT::isPointInside,
+ * intersectionArea) dispatches to these kernels for triangles and
+ * quadrilaterals.
+ */
+template <typename T, int N>
+struct PolygonKernel {
+  // Twice the signed area (positive for CCW vertices)
+  static T signedArea2(const PointT<T> *v) {
+    T sum = v[N - 1].x * v[0].y - v[0].x * v[N - 1].y;
+    for (int i = 0; i < N - 1; ++i)
+      sum += v[i].x * v[i + 1].y - v[i + 1].x * v[i].y;
+    return sum;
+  }
+
+  static T area(const PointT<T> *v) { return std::abs(signedArea2(v)) / 2; }
+
+  // True if P is strictly inside the polygon
+  static bool contains(const PointT<T> *v, const PointT<T> &P) {
+    bool all_left = true, all_right = true;
+    for (int i = 0; i < N; ++i) {
+      double cross = edgeCross(v[i], v[i + 1 == N ? 0 : i + 1], P);
+      all_left &= cross > 0;
+      all_right &= cross < 0;
+    }
+    return all_left | all_right;
+  }
+};
+
+template <typename T>
+struct PolygonKernel<T, 3> {
+  static T signedArea2(const PointT<T> *v) {
+    return (v[1].x - v[0].x) * (v[2].y - v[0].y) -
+           (v[2].x - v[0].x) * (v[1].y - v[0].y);
+  }
+
+  static T area(const PointT<T> *v) { return std::abs(signedArea2(v)) / 2; }
+
+  static bool contains(const PointT<T> *v, const PointT<T> &P) {
+    double c0 = edgeCross(v[0], v[1], P);
+    double c1 = edgeCross(v[1], v[2], P);
+    double c2 = edgeCross(v[2], v[0], P);
+    return ((c0 > 0) & (c1 > 0) & (c2 > 0)) | ((c0 < 0) & (c1 < 0) & (c2 < 0));
+  }
+};
+
+template <typename T>
+struct PolygonKernel<T, 4> {
+  // Shoelace over the diagonals: 2A = (p2 - p0) x (p3 - p1)
+  static T signedArea2(const PointT<T> *v) {
+    return (v[2].x - v[0].x) * (v[3].y - v[1].y) -
+           (v[3].x - v[1].x) * (v[2].y - v[0].y);
+  }
+
+  static T area(const PointT<T> *v) { return std::abs(signedArea2(v)) / 2; }
+
+  static bool contains(const PointT<T> *v, const PointT<T> &P) {
+    double c0 = edgeCross(v[0], v[1], P);
+    double c1 = edgeCross(v[1], v[2], P);
+    double c2 = edgeCross(v[2], v[3], P);
+    double c3 = edgeCross(v[3], v[0], P);
+    return ((c0 > 0) & (c1 > 0) & (c2 > 0) & (c3 > 0)) |
+           ((c0 < 0) & (c1 < 0) & (c2 < 0) & (c3 < 0));
+  }
+};
+
+/**
+ * Area of the intersection of a convex N-gon and a convex M-gon, computed by
+ * clipping the first polygon against every edge of the second one
+ * (Sutherland-Hodgman). Each clip adds at most one vertex, so the working
+ * polygon lives in fixed size stack arrays (with room to spare for vertices
+ * produced by rounding in degenerate configurations, which are dropped once
+ * the arrays are full).
+ * @param subject: Vertices of the first polygon.
+ * @param clip: Vertices of the second polygon.
+ * @return the intersection area (0 if the polygons do not overlap)
+ */
+template <typename T, int N, int M>
+T clipIntersectionArea(const PointT<T> *subject, const PointT<T> *clip) {
+  const int kMaxVertices = 2 * (N + M);
+  T xs[2][kMaxVertices], ys[2][kMaxVertices];
+  for (int i = 0; i < N; ++i) {
+    xs[0][i] = subject[i].x;
+    ys[0][i] = subject[i].y;
+  }
+  int n = N, in = 0;
+  // Inside of every clip edge is on its left for CCW polygons
+  T orientation = PolygonKernel<T, M>::signedArea2(clip) >= 0 ? 1 : -1;
+
+  for (int e = 0; e < M; ++e) {
+    const PointT<T> &a = clip[e];
+    const PointT<T> &b = clip[e + 1 == M ? 0 : e + 1];
+    T ex = orientation * (b.x - a.x), ey = orientation * (b.y - a.y);
+    const T *x = xs[in], *y = ys[in];
+    T *out_x = xs[1 - in], *out_y = ys[1 - in];
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+      int j = i + 1 == n ? 0 : i + 1;
+      T di = ex * (y[i] - a.y) - ey * (x[i] - a.x);
+      T dj = ex * (y[j] - a.y) - ey * (x[j] - a.x);
+      if (di >= 0 && m < kMaxVertices) {
+        out_x[m] = x[i];
+        out_y[m] = y[i];
+        ++m;
+      }
+      if ((di >= 0) != (dj >= 0) && m < kMaxVertices) {
+        T t = di / (di - dj);
+        out_x[m] = x[i] + t * (x[j] - x[i]);
+        out_y[m] = y[i] + t * (y[j] - y[i]);
+        ++m;
+      }
+    }
+    n = m;
+    in = 1 - in;
+    if (n < 3) return 0;
+  }
+
+  const T *x = xs[in], *y = ys[in];
+  T sum = x[n - 1] * y[0] - x[0] * y[n - 1];
+  for (int i = 0; i < n - 1; ++i) sum += x[i] * y[i + 1] - x[i + 1] * y[i];
+  return std::abs(sum) / 2;
+}
+
+/**
+ * Sutherland-Hodgman for vertex counts known only at run time, on any vertex
+ * layout: vertex(polygon, i, &x, &y) reads the i-th vertex of the subject
+ * (polygon 0) or of the clip polygon (polygon 1). The working polygon lives
+ * in inline (stack) storage up to a few times kInlineApexes vertices.
+ * @param n: Number of vertices of the subject polygon.
+ * @param m: Number of vertices of the clip polygon.
+ * @param vertex: Vertex accessor.
+ * @return the intersection area (0 if the polygons do not overlap)
+ */
+template <typename T, typename VertexAccessor>
+T clipIntersectionAreaWith(int n, int m, const VertexAccessor &vertex) {
+  const int max_vertices = 2 * (n + m);
+  SmallVector<T, 8 * kInlineApexes> buffer;
+  buffer.resize(4 * max_vertices);
+  T *xs[2] = {buffer.data(), buffer.data() + max_vertices};
+  T *ys[2] = {buffer.data() + 2 * max_vertices,
+              buffer.data() + 3 * max_vertices};
+  for (int i = 0; i < n; ++i) vertex(0, i, &xs[0][i], &ys[0][i]);
+  int in = 0;
+  T first_x, first_y, last_x, last_y;
+  vertex(1, 0, &first_x, &first_y);
+  vertex(1, m - 1, &last_x, &last_y);
+  T signed_area2 = last_x * first_y - first_x * last_y;
+  T ax = first_x, ay = first_y;
+  for (int i = 1; i < m; ++i) {
+    T bx, by;
+    vertex(1, i, &bx, &by);
+    signed_area2 += ax * by - bx * ay;
+    ax = bx;
+    ay = by;
+  }
+  T orientation = signed_area2 >= 0 ? 1 : -1;
+
+  T bx = first_x, by = first_y;
+  for (int e = 0; e < m; ++e) {
+    // Edge a -> b, b is the next vertex (wrapping to the first one)
+    ax = bx;
+    ay = by;
+    if (e + 1 == m) {
+      bx = first_x;
+      by = first_y;
+    } else {
+      vertex(1, e + 1, &bx, &by);
+    }
+    T ex = orientation * (bx - ax), ey = orientation * (by - ay);
+    const T *x = xs[in], *y = ys[in];
+    T *out_x = xs[1 - in], *out_y = ys[1 - in];
+    int k = 0;
+    for (int i = 0; i < n; ++i) {
+      int j = i + 1 == n ? 0 : i + 1;
+      T di = ex * (y[i] - ay) - ey * (x[i] - ax);
+      T dj = ex * (y[j] - ay) - ey * (x[j] - ax);
+      if (di >= 0 && k < max_vertices) {
+        out_x[k] = x[i];
+        out_y[k] = y[i];
+        ++k;
+      }
+      if ((di >= 0) != (dj >= 0) && k < max_vertices) {
+        T t = di / (di - dj);
+        out_x[k] = x[i] + t * (x[j] - x[i]);
+        out_y[k] = y[i] + t * (y[j] - y[i]);
+        ++k;
+      }
+    }
+    n = k;
+    in = 1 - in;
+    if (n < 3) return 0;
+  }
+
+  const T *x = xs[in], *y = ys[in];
+  T sum = x[n - 1] * y[0] - x[0] * y[n - 1];
+  for (int i = 0; i < n - 1; ++i) sum += x[i] * y[i + 1] - x[i + 1] * y[i];
+  return std::abs(sum) / 2;
+}
+
+/**
+ * clipIntersectionArea for vertex counts known only at run time.
+ * @param subject: Vertices of the first polygon.
+ * @param n: Number of vertices of the first polygon.
+ * @param clip: Vertices of the second polygon.
+ * @param m: Number of vertices of the second polygon.
+ * @return the intersection area (0 if the polygons do not overlap)
+ */
+template <typename T>
+T clipIntersectionArea(const PointT<T> *subject, int n, const PointT<T> *clip,
+                       int m) {
+  const PointT<T> *polygons[2] = {subject, clip};
+  return clipIntersectionAreaWith<T>(
+      n, m, [&polygons](int polygon, int i, T *x, T *y) {
+        *x = polygons[polygon][i].x;
+        *y = polygons[polygon][i].y;
+      });
+}
+
+/**
+ * Same as above on interleaved coordinates (x0, y0, x1, y1, ...), read in
+ * place.
+ */
+template <typename T>
+T clipIntersectionArea(const T *subject_xy, int n, const T *clip_xy, int m) {
+  const T *polygons[2] = {subject_xy, clip_xy};
+  return clipIntersectionAreaWith<T>(
+      n, m, [&polygons](int polygon, int i, T *x, T *y) {
+        *x = polygons[polygon][2 * i];
+        *y = polygons[polygon][2 * i + 1];
+      });
+}
+
+#endif  //  INCLUDE_HULL_KERNELS_HPP_
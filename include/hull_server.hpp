@@ -0,0 +1,147 @@
+#ifndef INCLUDE_HULL_SERVER_HPP_
+#define INCLUDE_HULL_SERVER_HPP_
+
+#include <atomic>
+#include <convex_hull.hpp>
+#include <cstdint>
+#include <intersection_backends.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <thread_pool.hpp>
+#include <vector>
+
+/**
+ * Long running elimination server on a local Unix domain socket, so clients
+ * pay neither the process startup nor the library initialization on every
+ * frame. A connection carries any number of requests, answered in order.
+ * Every message is a header (uint32 kind, uint32 payload size, host byte
+ * order) followed by the payload:
+ *   kMessageJson: a "convex hulls" json document, answered in json
+ *   kMessageBinary: hulls in the binary format (binary_format.hpp), answered
+ *   in binary
+ *   kMessageError: answer to a request that could not be processed, the
+ *   payload is the reason
+ */
+
+enum MessageKind : uint32_t {
+  kMessageJson = 1,
+  kMessageBinary = 2,
+  kMessageError = 3
+};
+
+// Larger payloads are refused and the connection is closed. Smaller ones
+// are read in chunks, so only the bytes received are allocated.
+const uint32_t kMaxMessageSize = 1u << 30;
+
+struct HullServerOptions {
+ public:
+  std::string socket_path;
+  double overlapping_percent;  // see eliminateOverlappingCHulls
+  std::string backend;         // one of getIntersectionBackendNames()
+  int n_threads;               // elimination threads, 0 = one per core
+  // Connections served at once, each by its own thread. Further clients get
+  // a kMessageError and are closed.
+  int max_connections;
+
+  HullServerOptions()
+      : overlapping_percent(0.5),
+        backend("auto"),
+        n_threads(0),
+        max_connections(64) {}
+};
+
+/**
+ * Every connection is read and written by its own thread, which keeps its
+ * buffers (message bytes and hulls) across requests, so a warm connection
+ * does not reallocate them. The eliminations run on a shared ThreadPool
+ * started with the server, which bounds the CPU use whatever the number of
+ * clients.
+ */
+class HullServer {
+ public:
+  explicit HullServer(const HullServerOptions &options);
+  ~HullServer();
+
+  HullServer(const HullServer &) = delete;
+  HullServer &operator=(const HullServer &) = delete;
+
+  /**
+   * Binds the socket (replacing a stale socket file) and starts accepting
+   * connections in the background.
+   * @param error: Reason of the failure, if any.
+   * @return false if the server could not be started
+   */
+  bool start(std::string *error);
+
+  // Closes the socket and every connection, and waits for their threads
+  void stop();
+
+  uint64_t getNRequests() const { return n_requests_; }
+
+ private:
+  void acceptLoop();
+  void serveConnection(int fd);
+  // Joins the threads of the closed connections, with mutex_ held
+  void reapConnections();
+
+  HullServerOptions options_;
+  std::unique_ptr<IntersectionBackend> backend_;
+  ThreadPool pool_;
+  int listen_fd_;
+  std::thread accept_thread_;
+  std::mutex mutex_;  // guards the connections
+  std::vector<std::thread> connection_threads_;
+  std::vector<int> connection_fds_;
+  std::vector<std::thread::id> finished_threads_;
+  std::atomic<bool> stopping_;
+  std::atomic<uint64_t> n_requests_;
+};
+
+/**
+ * Blocking client of a HullServer, one request at a time.
+ */
+class HullClient {
+ public:
+  HullClient() : fd_(-1) {}
+  ~HullClient() { close(); }
+
+  HullClient(const HullClient &) = delete;
+  HullClient &operator=(const HullClient &) = delete;
+
+  /**
+   * @param socket_path: Socket of the server.
+   * @param error: Reason of the failure, if any.
+   * @return false if the server could not be reached
+   */
+  bool connect(const std::string &socket_path, std::string *error);
+  void close();
+
+  /**
+   * Sends a request and waits for its response.
+   * @param kind: kMessageJson or kMessageBinary.
+   * @param payload: Request payload.
+   * @param response_kind: Kind of the response (kMessageError on failure).
+   * @param response: Response payload.
+   * @return false if the connection failed
+   */
+  bool request(MessageKind kind, const std::string &payload,
+               MessageKind *response_kind, std::string *response);
+
+  /**
+   * Eliminates overlapping hulls on the server, in the binary format.
+   * @param hulls: Convex hulls.
+   * @param remaining: Replaced by the remaining hulls.
+   * @param error: Reason of the failure, if any.
+   * @return false on failure
+   */
+  bool eliminate(const std::vector<ConvexHull> &hulls,
+                 std::vector<ConvexHull> *remaining, std::string *error);
+
+ private:
+  int fd_;
+  std::string request_buffer_, response_buffer_;
+};
+
+#endif  //  INCLUDE_HULL_SERVER_HPP_
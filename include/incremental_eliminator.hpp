@@ -0,0 +1,63 @@
+#ifndef INCLUDE_INCREMENTAL_ELIMINATOR_HPP_
+#define INCLUDE_INCREMENTAL_ELIMINATOR_HPP_
+
+#include <convex_hull.hpp>
+#include <spatial_index.hpp>
+#include <vector>
+
+/**
+ * Streaming version of eliminateOverlappingCHulls. Convex hulls are inserted
+ * one at a time and only checked against the already inserted hulls whose
+ * bounding box overlaps theirs, found through a SpatialHashGrid. The set of
+ * surviving hulls is kept up to date after every insertion.
+ *
+ * Eliminated hulls are kept internally, since (as in the batch function) they
+ * can still eliminate hulls that arrive later. Inserting the hulls of a vector
+ * in order and calling finalize() gives the same result as calling
+ * eliminateOverlappingCHulls on that vector.
+ */
+class IncrementalEliminator {
+ public:
+  /**
+   * @param overlapping_percent: How much % of the overlaped area of a polygon
+   * is necessary to consider it "eliminated"
+   * @param cell_size: Cell size of the spatial index, in the order of the
+   * typical convex hull size.
+   */
+  explicit IncrementalEliminator(double overlapping_percent,
+                                 double cell_size = 10.);
+
+  /**
+   * Checks a new convex hull against the overlapping hulls inserted so far
+   * and updates which hulls remain.
+   * @param hull: Convex Hull to insert.
+   */
+  void insert(const ConvexHull &hull);
+
+  /**
+   * @returns the currently remaining convex hulls, in insertion order.
+   */
+  std::vector<ConvexHull> survivors() const;
+
+  /**
+   * Returns the remaining convex hulls and resets the eliminator so it can
+   * be used for a new stream.
+   * @returns Vector of remaining polygons/C. Hulls, in insertion order.
+   */
+  std::vector<ConvexHull> finalize();
+
+  int getNInserted() const { return hulls_.size(); }
+  int getNSurvivors() const { return n_survivors_; }
+
+ private:
+  void eliminate(int i);
+
+  double overlapping_percent_;
+  std::vector<ConvexHull> hulls_;
+  std::vector<bool> remaining_convex_hulls_;
+  int n_survivors_;
+  SpatialHashGrid grid_;
+  std::vector<int> candidates_;
+};
+
+#endif  //  INCLUDE_INCREMENTAL_ELIMINATOR_HPP_
@@ -0,0 +1,99 @@
+#ifndef INCLUDE_INSTRUMENTATION_HPP_
+#define INCLUDE_INSTRUMENTATION_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Low overhead pipeline statistics: time per stage and event counters.
+ * Every thread bumps the counters in its own cache line, so the threads of a
+ * pool never contend on them; getCount adds up all the threads. Stage times
+ * are recorded once per stage in process wide relaxed atomics, both summed
+ * over the threads (getStageTime) and as the wall time from the first start
+ * to the last end of the stage (getStageWallTime). They differ when the
+ * stage runs on several threads at once, as in the batch mode. Building
+ * without CONVEX_HULL_STATS turns the CH_STATS_* macros into no-ops, so the
+ * instrumentation costs nothing.
+ */
+namespace stats {
+
+enum Stage {
+  kStageParse = 0,
+  kStageFromJson,
+  kStageEliminate,
+  kStageToJson,
+  kStageWrite,
+  kNStages
+};
+
+enum Counter {
+  kPairsConsidered = 0,
+  kPairsBroadPhaseRejected,
+  kPairsIntersected,
+  kIntersectionVertices,
+  kExactPredicates,
+  kAllocations,
+  kNCounters
+};
+
+// True when the library was built with CONVEX_HULL_STATS
+bool isEnabled();
+
+void addCount(Counter counter, uint64_t n);
+void addStageTime(Stage stage, uint64_t nanoseconds);
+// addStageTime of the duration, and widens the wall interval of the stage
+void addStageInterval(Stage stage, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end);
+uint64_t getCount(Counter counter);
+// Nanoseconds summed over all the threads that ran the stage
+uint64_t getStageTime(Stage stage);
+// Nanoseconds from the first start to the last end of the stage
+uint64_t getStageWallTime(Stage stage);
+
+// Sets all timings and counters back to 0, while no other thread counts
+void reset();
+
+/**
+ * Writes a human readable report of the stage timings and counters.
+ * @param stream: Output stream.
+ */
+void printReport(std::ostream &stream);
+
+/**
+ * Adds the time between its construction and destruction to a stage.
+ */
+class ScopedStageTimer {
+ public:
+  explicit ScopedStageTimer(Stage stage)
+      : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedStageTimer() {
+    addStageInterval(stage_, start_, std::chrono::steady_clock::now());
+  }
+  ScopedStageTimer(const ScopedStageTimer &) = delete;
+  ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+ private:
+  Stage stage_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace stats
+
+#define CH_STATS_CONCAT_(a, b) a##b
+#define CH_STATS_CONCAT(a, b) CH_STATS_CONCAT_(a, b)
+
+#ifdef CONVEX_HULL_STATS
+#define CH_STATS_COUNT(counter, n) stats::addCount(stats::counter, (n))
+#define CH_STATS_STAGE(stage) \
+  stats::ScopedStageTimer CH_STATS_CONCAT(stats_timer_, __LINE__)(stats::stage)
+#else
+#define CH_STATS_COUNT(counter, n) \
+  do {                             \
+  } while (0)
+#define CH_STATS_STAGE(stage) \
+  do {                        \
+  } while (0)
+#endif
+
+#endif  //  INCLUDE_INSTRUMENTATION_HPP_
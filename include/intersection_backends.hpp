@@ -0,0 +1,235 @@
+#ifndef INCLUDE_INTERSECTION_BACKENDS_HPP_
+#define INCLUDE_INTERSECTION_BACKENDS_HPP_
+
+#include <convex_hull.hpp>
+#include <convex_hull_view.hpp>
+#include <hull_kernels.hpp>
+#include <instrumentation.hpp>
+#include <memory>
+#include <obb.hpp>
+#include <spatial_index.hpp>
+#include <string>
+#include <trace.hpp>
+#include <vector>
+
+/**
+ * Interchangeable algorithms for the area of the intersection of two convex
+ * hulls. A backend is any type with a
+ *   T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) const
+ * member, and the same for const ConvexHullViewT<T> pointers. So it can be
+ * chosen at compile time (a backend struct passed to
+ * eliminateOverlappingCHullsWith, fully inlined) or at run time (an
+ * IntersectionBackend from makeIntersectionBackend, one virtual call per
+ * pair).
+ */
+
+/**
+ * Intersection vertices (contained apexes and edge crossings, see
+ * getIntersectionPolygonVertices) sorted CCW with sortPointsCCW. The
+ * original algorithm of this project, O(n m).
+ */
+struct VertexCollectionBackend {
+  static const char *getName() { return "vertex-collection"; }
+
+  template <typename T>
+  T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) const {
+    std::vector<PointT<T>> vertices = getIntersectionPolygonVertices(C1, C2);
+    if (vertices.size() < 3) return 0;
+    sortPointsCCW(&vertices);
+    return polygonArea(vertices);
+  }
+
+  template <typename T>
+  T intersectionArea(const ConvexHullViewT<T> *C1,
+                     const ConvexHullViewT<T> *C2) const {
+    std::vector<PointT<T>> vertices = getIntersectionPolygonVertices(C1, C2);
+    if (vertices.size() < 3) return 0;
+    sortPointsCCW(&vertices);
+    return polygonArea(vertices);
+  }
+
+ private:
+  template <typename T>
+  static T polygonArea(const std::vector<PointT<T>> &v) {
+    T sum = v.back().x * v.front().y - v.front().x * v.back().y;
+    for (int i = 0; i + 1 < v.size(); ++i)
+      sum += v[i].x * v[i + 1].y - v[i + 1].x * v[i].y;
+    return std::abs(sum) / 2;
+  }
+};
+
+/**
+ * Sutherland-Hodgman: the first hull is clipped by every edge of the second
+ * one (clipIntersectionArea), O(n m) without any sort.
+ */
+struct SutherlandHodgmanBackend {
+  static const char *getName() { return "sutherland-hodgman"; }
+
+  template <typename T>
+  T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) const {
+    return clipIntersectionArea(C1->apex.data(), C1->getNvertices(),
+                                C2->apex.data(), C2->getNvertices());
+  }
+
+  template <typename T>
+  T intersectionArea(const ConvexHullViewT<T> *C1,
+                     const ConvexHullViewT<T> *C2) const {
+    return clipIntersectionArea(C1->apex, C1->n_apexes, C2->apex,
+                                C2->n_apexes);
+  }
+};
+
+/**
+ * Area of the intersection of two convex polygons with the edge-advancing
+ * algorithm of O'Rourke et al. ("A new linear algorithm for intersecting
+ * convex polygons", 1982): the two boundaries are walked together, advancing
+ * on one edge at a time, so the cost is O(n + m). Vertices can be CW or CCW.
+ * @param P: Vertices of the first polygon.
+ * @param n: Number of vertices of the first polygon.
+ * @param Q: Vertices of the second polygon.
+ * @param m: Number of vertices of the second polygon.
+ * @return the intersection area (0 if the polygons do not overlap)
+ */
+template <typename T>
+T edgeAdvancingIntersectionArea(const PointT<T> *P, int n, const PointT<T> *Q,
+                                int m);
+
+struct EdgeAdvancingBackend {
+  static const char *getName() { return "edge-advancing"; }
+
+  template <typename T>
+  T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) const {
+    return edgeAdvancingIntersectionArea(C1->apex.data(), C1->getNvertices(),
+                                         C2->apex.data(), C2->getNvertices());
+  }
+
+  template <typename T>
+  T intersectionArea(const ConvexHullViewT<T> *C1,
+                     const ConvexHullViewT<T> *C2) const {
+    return edgeAdvancingIntersectionArea(C1->apex, C1->n_apexes, C2->apex,
+                                         C2->n_apexes);
+  }
+};
+
+/**
+ * The default: unrolled kernels for triangles and quadrilaterals, vertex
+ * collection for the rest (the global intersectionArea).
+ */
+struct AutoBackend {
+  static const char *getName() { return "auto"; }
+
+  template <typename T>
+  T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) const {
+    return ::intersectionArea(C1, C2);
+  }
+
+  template <typename T>
+  T intersectionArea(const ConvexHullViewT<T> *C1,
+                     const ConvexHullViewT<T> *C2) const {
+    return ::intersectionArea(C1, C2);
+  }
+};
+
+/**
+ * Run time selectable backend (double precision hulls).
+ */
+class IntersectionBackend {
+ public:
+  virtual ~IntersectionBackend() {}
+  virtual const char *getName() const = 0;
+  virtual double intersectionArea(ConvexHull *C1, ConvexHull *C2) const = 0;
+  virtual double intersectionArea(const ConvexHullView *C1,
+                                  const ConvexHullView *C2) const = 0;
+};
+
+template <typename Backend>
+class IntersectionBackendAdapter : public IntersectionBackend {
+ public:
+  const char *getName() const override { return Backend::getName(); }
+  double intersectionArea(ConvexHull *C1, ConvexHull *C2) const override {
+    return backend_.intersectionArea(C1, C2);
+  }
+  double intersectionArea(const ConvexHullView *C1,
+                          const ConvexHullView *C2) const override {
+    return backend_.intersectionArea(C1, C2);
+  }
+
+ private:
+  Backend backend_;
+};
+
+/**
+ * @param name: One of getIntersectionBackendNames().
+ * @return the backend, or nullptr if the name is unknown
+ */
+std::unique_ptr<IntersectionBackend> makeIntersectionBackend(
+    const std::string &name);
+
+std::vector<std::string> getIntersectionBackendNames();
+
+/**
+ * eliminateOverlappingCHulls with a given intersection backend (a backend
+ * struct, or an IntersectionBackend for run time selection), over owning
+ * hulls (ConvexHullT) or views (ConvexHullViewT, no vertex is copied). Other
+ * shapes only need a Scalar type, an id, getArea(), the hullBounds and
+ * trustedMinAreaRectangle overloads and a backend for their pairs (see
+ * eliminateOverlappingOBBs), so every elimination shares this pair rule.
+ * @param input: Vector of Convex hulls.
+ * @param overlapping_percent: How much % of the overlaped area of a polygon
+ * is necessary to consider it "eliminated"
+ * @param backend: Computes the intersection area of each pair.
+ * @returns Vector of remaining Convex Hulls.
+ */
+template <typename Hull, typename Backend>
+std::vector<Hull> eliminateOverlappingCHullsWith(std::vector<Hull> *input,
+                                                 double overlapping_percent,
+                                                 const Backend &backend) {
+  CH_TRACE_SPAN("eliminateOverlappingCHulls", input->size());
+  // Use a vector to keep track of which C Hulls should remain
+  std::vector<bool> remaining_convex_hulls(input->size(), true);
+  std::vector<Hull> output;
+  output.reserve(input->size());
+  // Broad phase: polygons whose bounding boxes (or cached minimum area
+  // rectangles) do not overlap can not intersect, so the expensive
+  // intersection is skipped for them
+  std::vector<BoundingBox> boxes;
+  std::vector<OrientedBoxT<typename Hull::Scalar>> rectangles(input->size());
+  std::vector<bool> has_rectangle(input->size());
+  boxes.reserve(input->size());
+  for (int i = 0; i < input->size(); ++i) {
+    boxes.push_back(hullBounds(input->at(i)));
+    has_rectangle[i] = trustedMinAreaRectangle(input->at(i), &rectangles[i]);
+  }
+
+  for (int i = 0; i + 1 < input->size(); ++i) {
+    for (int j = i + 1; j < input->size(); ++j) {
+      CH_STATS_COUNT(kPairsConsidered, 1);
+      if (!boxes[i].overlaps(boxes[j]) ||
+          (has_rectangle[i] && has_rectangle[j] &&
+           !obbsOverlap(rectangles[i], rectangles[j]))) {
+        CH_STATS_COUNT(kPairsBroadPhaseRejected, 1);
+        continue;
+      }
+      CH_TRACE_SPAN("intersect pair", input->at(i).id, input->at(j).id);
+      typename Hull::Scalar intersection_area =
+          backend.intersectionArea(&input->at(i), &input->at(j));
+      // For each C. Hull check for overlapping with the remaining C. Hulls
+      if (intersection_area > 0) {
+        CH_STATS_COUNT(kPairsIntersected, 1);
+        // If the overlapping area is larger that the desired percent, tag the
+        // index to be eliminated. this check is done for both C. Hulls
+        if (intersection_area > overlapping_percent * input->at(i).getArea())
+          remaining_convex_hulls[i] = false;
+        if (intersection_area > overlapping_percent * input->at(j).getArea())
+          remaining_convex_hulls[j] = false;
+      }
+    }
+  }
+  // Store the convex hulls that should remain, ignoring the rest.
+  for (int i = 0; i < remaining_convex_hulls.size(); ++i) {
+    if (remaining_convex_hulls[i]) output.push_back(input->at(i));
+  }
+  return output;
+}
+
+#endif  //  INCLUDE_INTERSECTION_BACKENDS_HPP_
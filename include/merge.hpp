@@ -0,0 +1,45 @@
+#ifndef INCLUDE_MERGE_HPP_
+#define INCLUDE_MERGE_HPP_
+
+#include <convex_hull.hpp>
+#include <thread_pool.hpp>
+#include <vector>
+
+class IntersectionBackend;
+
+/**
+ * Convex hull of the union of several convex hulls. The vertices of every
+ * hull are sorted by (x, y) in linear time, by merging its lower and upper
+ * chains, the sorted lists are merged pairwise and Andrew's monotone chain
+ * builds the hull, so the cost is O(N log k) for N vertices in k hulls,
+ * without any general sort. Hulls can be ordered CCW or CW.
+ * @param hulls: Pointers to the hulls to merge (at least one).
+ * @param n_hulls: Number of hulls.
+ * @param id: ID of the merged hull.
+ * @return the merged hull, ordered CCW and without collinear vertices
+ */
+ConvexHull mergeConvexHulls(const ConvexHull *const *hulls, int n_hulls,
+                            int id);
+
+/**
+ * Merge policy, the counterpart of eliminateOverlappingCHulls for fusion:
+ * two hulls are connected when their intersection is larger than
+ * overlapping_percent of the area of either of them (the pairs that
+ * elimination would act on), and every connected component of this overlap
+ * graph is replaced by the convex hull of its members (mergeConvexHulls).
+ * The merged hulls are built in parallel on the pool, one task per group of
+ * components. The result does not depend on the number of threads.
+ * @param input: Vector of Convex Hulls.
+ * @param overlapping_percent: How much % of the overlaped area of a polygon is
+ * necessary to merge it with the other one
+ * @param pool: Thread pool to run on, nullptr runs on the calling thread.
+ * @param backend: Intersection areas of the pairs, nullptr for
+ * intersectionArea (the auto backend).
+ * @returns one hull per component, ordered by the first member in input and
+ * with its ID. Hulls that do not overlap any other are returned unchanged.
+ */
+std::vector<ConvexHull> mergeOverlappingCHulls(
+    std::vector<ConvexHull> *input, double overlapping_percent,
+    ThreadPool *pool = nullptr, const IntersectionBackend *backend = nullptr);
+
+#endif  //  INCLUDE_MERGE_HPP_
@@ -0,0 +1,89 @@
+#ifndef INCLUDE_NMS_HPP_
+#define INCLUDE_NMS_HPP_
+
+#include <convex_hull.hpp>
+#include <json.hpp>
+#include <string>
+#include <vector>
+
+class IntersectionBackend;
+
+using json = nlohmann::json;
+
+// How a kept hull treats the hulls that overlap it
+enum NmsMethod {
+  kNmsHard = 0,  // suppressed above iou_threshold
+  kNmsLinear,    // score * (1 - IoU) above iou_threshold (Soft-NMS)
+  kNmsGaussian   // score * exp(-IoU^2 / sigma) (Soft-NMS)
+};
+
+// "hard", or "linear" or "gaussian" (Soft-NMS). Throws
+// std::invalid_argument for any other name.
+NmsMethod nmsMethodFromName(const std::string &name);
+
+/**
+ * Parameters of the non-maximum suppression.
+ */
+struct NmsOptions {
+ public:
+  NmsMethod method;
+  double iou_threshold;    // overlap above which a hull is suppressed (hard)
+                           // or decayed (linear)
+  double sigma;            // width of the Gaussian decay
+  double score_threshold;  // hulls scoring (or decayed) below are dropped
+  int max_output;          // stop once this many hulls are kept (0 = all)
+  double cell_size;        // cell size of the spatial index
+  // Intersection areas of the IoUs, nullptr for intersectionArea (the auto
+  // backend). Not owned.
+  const IntersectionBackend *backend;
+
+  NmsOptions()
+      : method(kNmsHard), iou_threshold(0.5), sigma(0.5), score_threshold(0.),
+        max_output(0), cell_size(10.), backend(nullptr) {}
+};
+
+/**
+ * Score ordered non-maximum suppression over convex hulls, the detection
+ * counterpart of eliminateOverlappingCHulls. IoU is the polygon IoU, so
+ * rotated boxes and general convex hulls are handled alike. The result does
+ * not depend on the input order (ties are broken by position in input).
+ *
+ * kNmsHard is the classic greedy NMS: hulls are visited by descending score,
+ * and a hull is kept unless its IoU with an already kept hull is above the
+ * threshold. Kept hulls are registered in a SpatialHashGrid, so every
+ * candidate is only compared with the kept hulls whose bounding box overlaps
+ * its own, and the comparison stops at the first suppressing hull.
+ *
+ * kNmsLinear and kNmsGaussian are Soft-NMS (Bodla et al. 2017): the best
+ * remaining hull is kept and the scores of the hulls overlapping it are
+ * decayed, instead of removed, then the process repeats. The hulls live in a
+ * SpatialHashGrid and the scores in a max-heap with lazy updates, so keeping
+ * a hull only rescores its overlapping neighbours.
+ *
+ * Both stop as soon as max_output hulls are kept, and hulls scoring below
+ * score_threshold are dropped.
+ * @param input: Vector of convex hulls.
+ * @param scores: Score of every hull (same size as input).
+ * @param options: Method, thresholds and limits.
+ * @param kept_scores: If not null, the (decayed) score of every kept hull is
+ * stored here.
+ * @returns Indices of the kept hulls in input, in the order they were kept
+ * (by descending score).
+ */
+std::vector<int> nonMaximumSuppression(std::vector<ConvexHull> *input,
+                                       const std::vector<double> &scores,
+                                       const NmsOptions &options,
+                                       std::vector<double> *kept_scores =
+                                           nullptr);
+
+/**
+ * Reads the optional "score" of every convex hull of a json with the format
+ * of convexHullsFromJson.
+ * @param data: Json object with the "convex hulls" array.
+ * @param default_score: Score of the hulls without one.
+ * @return the scores, in the order of the hulls
+ */
+std::vector<double> scoresFromJson(const json &data,
+                                   double default_score = 0.);
+
+#endif  //  INCLUDE_NMS_HPP_
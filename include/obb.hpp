@@ -0,0 +1,176 @@
+#ifndef INCLUDE_OBB_HPP_
+#define INCLUDE_OBB_HPP_
+
+#include <convex_hull.hpp>
+#include <convex_hull_view.hpp>
+#include <spatial_index.hpp>
+#include <vector>
+
+/**
+ * Oriented bounding box (rotated rectangle): center, half extents along its
+ * own axes and yaw (rotation of the box x axis, in radians, CCW).
+ * Rotated-rectangle detections can be processed as boxes directly, without
+ * converting them into 4-apex ConvexHulls first.
+ */
+template <typename T>
+struct OrientedBoxT {
+ public:
+  typedef T Scalar;
+  PointT<T> center;
+  T half_x, half_y, yaw;
+  int id;
+
+  OrientedBoxT() : half_x(0), half_y(0), yaw(0), id(0) {}
+  OrientedBoxT(T cx, T cy, T half_x_, T half_y_, T yaw_, int id_)
+      : center(cx, cy), half_x(half_x_), half_y(half_y_), yaw(yaw_), id(id_) {}
+
+  T getArea() const { return 4 * half_x * half_y; }
+
+  /**
+   * Computes the four corners of the box, ordered CCW.
+   * @param corners: Array of 4 Points where the corners are stored.
+   */
+  void getCorners(PointT<T> corners[4]) const;
+
+  // Axis aligned bounding box of the rotated box
+  BoundingBox getBoundingBox() const;
+
+  // The same box as a general polygon
+  ConvexHullT<T> toConvexHull() const;
+};
+
+using OrientedBox = OrientedBoxT<double>;
+using OrientedBoxF = OrientedBoxT<float>;
+
+/**
+ * Separating axis test between two boxes (only the 4 box axes are needed).
+ * @param A: First box.
+ * @param B: Second box.
+ * @return true if the boxes overlap
+ */
+template <typename T>
+bool obbsOverlap(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B);
+
+/**
+ * Area of the intersection of two boxes. The corners of B are expressed in
+ * the frame of A, where A is an axis aligned rectangle, and clipped against
+ * its four sides with fixed size arrays. Separated boxes are rejected with
+ * the separating axis test before clipping.
+ * @param A: First box.
+ * @param B: Second box.
+ * @return the intersection area (0 if they do not overlap)
+ */
+template <typename T>
+T obbIntersectionArea(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B);
+
+/**
+ * Area of the intersection of a box and a convex hull, computed by clipping
+ * the hull (in the frame of the box) against the sides of the box.
+ * @param A: Box.
+ * @param C: Convex Hull.
+ * @return the intersection area (0 if they do not overlap)
+ */
+template <typename T>
+T obbHullIntersectionArea(const OrientedBoxT<T> &A, const ConvexHullT<T> &C);
+
+template <typename T>
+T obbHullIntersectionArea(const OrientedBoxT<T> &A,
+                          const ConvexHullViewT<T> &C);
+
+/**
+ * Tests whether a point is inside a box.
+ * @param A: Box.
+ * @param P: The Point that is being tested.
+ * @return true or false
+ */
+template <typename T>
+bool isPointInsideOBB(const OrientedBoxT<T> &A, const PointT<T> &P);
+
+/**
+ * Minimum area bounding rectangle of a hull, from its shape descriptors.
+ * @param descriptors: Descriptors of the hull (ConvexHullT::getDescriptors).
+ * @param id: ID of the box.
+ * @return the rectangle as a box
+ */
+template <typename T>
+OrientedBoxT<T> minAreaRectangle(const HullDescriptorsT<T> &descriptors,
+                                 int id = 0) {
+  return OrientedBoxT<T>(descriptors.rect_center.x, descriptors.rect_center.y,
+                         descriptors.rect_half_x, descriptors.rect_half_y,
+                         descriptors.rect_yaw, id);
+}
+
+/**
+ * Cached minimum area rectangle of a hull for the broad phase, grown by a
+ * few ulps of the coordinates against rounding. Descriptors can come from
+ * the input or go stale when apex is edited directly, so the rectangle is
+ * only returned when every apex lies in it: O(n), nothing else is computed.
+ * @param hull: Convex Hull.
+ * @param rectangle: Set to the grown rectangle when it is returned.
+ * @return false if the hull has no cached descriptors or its rectangle does
+ * not contain all its apexes
+ */
+template <typename T>
+bool trustedMinAreaRectangle(const ConvexHullT<T> &hull,
+                             OrientedBoxT<T> *rectangle);
+
+// Views carry no descriptors
+template <typename T>
+bool trustedMinAreaRectangle(const ConvexHullViewT<T> & /*hull*/,
+                             OrientedBoxT<T> * /*rectangle*/) {
+  return false;
+}
+
+/**
+ * Broad phase pre-test on the cached minimum area rectangles of two hulls,
+ * tighter than the axis aligned boxes for rotated hulls. Both rectangles
+ * come from trustedMinAreaRectangle, so separated rectangles mean the hulls
+ * do not intersect. The elimination checks every hull once instead of
+ * calling this for every pair.
+ * @param A: First Convex Hull.
+ * @param B: Second Convex Hull.
+ * @return true if both rectangles are trusted and do not overlap
+ */
+template <typename T>
+bool minAreaRectanglesSeparated(const ConvexHullT<T> &A,
+                                const ConvexHullT<T> &B);
+
+// What eliminateOverlappingCHullsWith needs to run on boxes: their axis
+// aligned bounding box, no rectangle pre-test (the intersection already
+// starts with the separating axis test) and the intersection area
+template <typename T>
+BoundingBox hullBounds(const OrientedBoxT<T> &box) {
+  return box.getBoundingBox();
+}
+
+template <typename T>
+bool trustedMinAreaRectangle(const OrientedBoxT<T> & /*box*/,
+                             OrientedBoxT<T> * /*rectangle*/) {
+  return false;
+}
+
+struct OBBIntersectionBackend {
+  static const char *getName() { return "obb"; }
+
+  template <typename T>
+  T intersectionArea(const OrientedBoxT<T> *A, const OrientedBoxT<T> *B) const {
+    return obbIntersectionArea(*A, *B);
+  }
+};
+
+/**
+ * Same rule as eliminateOverlappingCHulls, running on boxes: a box is
+ * eliminated if its intersection with another box is larger than
+ * overlapping_percent of its own area. Pairs whose axis aligned bounding
+ * boxes do not overlap are skipped. It is eliminateOverlappingCHullsWith
+ * with an OBBIntersectionBackend.
+ * @param input: Vector of boxes.
+ * @param overlapping_percent: How much % of the overlaped area of a box is
+ * necessary to consider it "eliminated"
+ * @returns Vector of remaining boxes.
+ */
+template <typename T>
+std::vector<OrientedBoxT<T>> eliminateOverlappingOBBs(
+    std::vector<OrientedBoxT<T>> *input, double overlapping_percent);
+
+#endif  //  INCLUDE_OBB_HPP_
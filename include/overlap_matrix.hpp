@@ -0,0 +1,54 @@
+#ifndef INCLUDE_OVERLAP_MATRIX_HPP_
+#define INCLUDE_OVERLAP_MATRIX_HPP_
+
+#include <convex_hull.hpp>
+#include <thread_pool.hpp>
+#include <vector>
+
+/**
+ * Non zero element of an overlap matrix: hull i of the first set overlaps
+ * hull j of the second set.
+ */
+struct OverlapEntry {
+ public:
+  int i, j;
+  double intersection_area;
+  double iou;  // intersection over union
+  OverlapEntry() : i(0), j(0), intersection_area(0.), iou(0.) {}
+  OverlapEntry(int i_, int j_, double intersection_area_, double iou_)
+      : i(i_), j(j_), intersection_area(intersection_area_), iou(iou_) {}
+};
+
+/**
+ * Sparse N x M matrix of the overlaps between two sets of convex hulls (e.g.
+ * detections and tracks). Only pairs with a positive intersection area are
+ * stored, sorted by row and then by column.
+ */
+struct OverlapMatrix {
+ public:
+  int n_rows, n_cols;
+  std::vector<OverlapEntry> entries;
+  OverlapMatrix() : n_rows(0), n_cols(0) {}
+
+  int getNEntries() const { return entries.size(); }
+};
+
+/**
+ * Computes the intersection area and IoU of every overlapping pair (i, j),
+ * with i in rows and j in cols. The candidate pairs come from a
+ * SpatialHashGrid over the bounding boxes of cols, and the intersections are
+ * computed in parallel on the pool (row blocks), with intersectionArea. The
+ * result does not depend on the number of threads.
+ * @param rows: First set of convex hulls (matrix rows).
+ * @param cols: Second set of convex hulls (matrix columns).
+ * @param pool: Thread pool to run on, nullptr runs on the calling thread.
+ * @param cell_size: Cell size of the spatial index, in the order of the
+ * typical convex hull size.
+ * @return the sparse overlap matrix
+ */
+OverlapMatrix computeOverlapMatrix(std::vector<ConvexHull> *rows,
+                                   std::vector<ConvexHull> *cols,
+                                   ThreadPool *pool = nullptr,
+                                   double cell_size = 10.);
+
+#endif  //  INCLUDE_OVERLAP_MATRIX_HPP_
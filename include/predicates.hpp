@@ -0,0 +1,100 @@
+#ifndef INCLUDE_PREDICATES_HPP_
+#define INCLUDE_PREDICATES_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <convex_hull.hpp>
+
+/**
+ * Robust geometric predicates (after Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates").
+ *
+ * The determinants are first evaluated in plain double precision together
+ * with a bound of their rounding error. Only when the error could flip the
+ * sign (nearly collinear points) is the determinant recomputed exactly with
+ * floating point expansions, so the common case costs a few extra flops.
+ * Float coordinates are promoted to double.
+ */
+namespace predicates {
+
+// Unit roundoff of double, 2^-53
+const double kEpsilon = 1.1102230246251565e-16;
+// Relative error bound of the double precision orientation determinant
+const double kOrientErrorBound = (3. + 16. * kEpsilon) * kEpsilon;
+
+/**
+ * Exact orientation determinant, computed with floating point expansions.
+ * @return a value with the exact sign of the determinant
+ */
+double orient2dExact(double ax, double ay, double bx, double by, double cx,
+                     double cy);
+
+/**
+ * Orientation of the point c relative to the directed line a -> b.
+ * @return positive if c is on the left (a, b, c CCW), negative if it is on
+ * the right, 0 if the points are collinear. The sign is always exact.
+ */
+inline double orient2d(double ax, double ay, double bx, double by, double cx,
+                       double cy) {
+  double det_left = (ax - cx) * (by - cy);
+  double det_right = (ay - cy) * (bx - cx);
+  double det = det_left - det_right;
+  // |det_left| + |det_right| bounds the magnitude of the operands (when the
+  // terms have opposite signs the bound is loose, but never wrong)
+  double det_sum = std::abs(det_left) + std::abs(det_right);
+  if (std::abs(det) > kOrientErrorBound * det_sum) return det;
+  if (det_sum == 0) return 0;
+  return orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+template <typename T>
+inline double orient2d(const PointT<T> &a, const PointT<T> &b,
+                       const PointT<T> &c) {
+  return orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+// Sign of the orientation: 1 (left), -1 (right) or 0 (collinear)
+template <typename T>
+inline int orientation(const PointT<T> &a, const PointT<T> &b,
+                       const PointT<T> &c) {
+  double det = orient2d(a, b, c);
+  return (det > 0) - (det < 0);
+}
+
+/**
+ * Exact segment intersection test. Touching segments (an endpoint on the
+ * other segment) intersect, collinear segments do not: the vertices they
+ * share are found by the containment tests of the polygon intersection.
+ * @param a1, a2: Endpoints of the first segment.
+ * @param b1, b2: Endpoints of the second segment.
+ * @param t: If the segments intersect, the position of the intersection
+ * along a1 -> a2 (in [0, 1]) is copied here.
+ * @return true or false
+ */
+template <typename T>
+inline bool segmentsCross(const PointT<T> &a1, const PointT<T> &a2,
+                          const PointT<T> &b1, const PointT<T> &b2,
+                          double *t) {
+  // Comparisons are exact: segments with disjoint boxes can not intersect
+  if (std::max(a1.x, a2.x) < std::min(b1.x, b2.x) ||
+      std::max(b1.x, b2.x) < std::min(a1.x, a2.x) ||
+      std::max(a1.y, a2.y) < std::min(b1.y, b2.y) ||
+      std::max(b1.y, b2.y) < std::min(a1.y, a2.y))
+    return false;
+  double a1_side = orient2d(b1, b2, a1);
+  double a2_side = orient2d(b1, b2, a2);
+  if ((a1_side > 0 && a2_side > 0) || (a1_side < 0 && a2_side < 0))
+    return false;
+  double b1_side = orient2d(a1, a2, b1);
+  double b2_side = orient2d(a1, a2, b2);
+  if ((b1_side > 0 && b2_side > 0) || (b1_side < 0 && b2_side < 0))
+    return false;
+  if (a1_side == 0 && a2_side == 0) return false;  // collinear
+  // a1_side and a2_side have opposite signs (or one is 0), so t is in [0, 1]
+  *t = a1_side / (a1_side - a2_side);
+  return true;
+}
+
+}  // namespace predicates
+
+#endif  //  INCLUDE_PREDICATES_HPP_
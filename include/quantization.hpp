@@ -0,0 +1,179 @@
+#ifndef INCLUDE_QUANTIZATION_HPP_
+#define INCLUDE_QUANTIZATION_HPP_
+
+#include <convex_hull.hpp>
+#include <cstdint>
+#include <json.hpp>
+#include <obb.hpp>
+#include <ostream>
+#include <small_vector.hpp>
+#include <spatial_index.hpp>
+#include <vector>
+
+using json = nlohmann::json;
+
+/**
+ * Integer coordinate mode. Vertices are snapped to a regular grid of a given
+ * resolution (e.g. 1 mm for sensor-frame meters) and stored as int32. With
+ * coordinates bounded by kMaxQuantized every orientation determinant fits in
+ * an int64, so the geometric predicates are exact without any floating
+ * point filter, and the vertices are stored as separate x and y arrays so the
+ * containment loops can be vectorized by the compiler.
+ */
+
+// Largest quantized coordinate (in grid units). Differences fit in 31 bits,
+// so products fit in 62 bits and determinants in an int64.
+const int32_t kMaxQuantized = (1 << 30) - 1;
+
+/**
+ * Accuracy of a quantization: how far the vertices moved when snapped to the
+ * grid and how much the hull areas changed.
+ */
+struct QuantizationReport {
+ public:
+  int n_vertices;
+  int n_clamped;             // vertices outside of the representable range
+  double max_error;          // largest vertex displacement
+  double sum_error;          // sum of vertex displacements
+  double error_bound;        // resolution * sqrt(2) / 2 (without clamping)
+  double max_area_error;     // largest relative area change of a hull
+  QuantizationReport()
+      : n_vertices(0), n_clamped(0), max_error(0.), sum_error(0.),
+        error_bound(0.), max_area_error(0.) {}
+
+  double getMeanError() const {
+    return n_vertices == 0 ? 0. : sum_error / n_vertices;
+  }
+
+  friend std::ostream &operator<<(std::ostream &stream,
+                                  const QuantizationReport &R) {
+    stream << "vertices: " << R.n_vertices << ", clamped: " << R.n_clamped
+           << ", max error: " << R.max_error
+           << ", mean error: " << R.getMeanError()
+           << ", error bound: " << R.error_bound
+           << ", max relative area error: " << R.max_area_error;
+    return stream;
+  }
+};
+
+/**
+ * Maps world coordinates to the integer grid and back:
+ * q = round((p - origin) / resolution).
+ */
+class Quantizer {
+ public:
+  explicit Quantizer(double resolution, double origin_x = 0.,
+                     double origin_y = 0.);
+
+  /**
+   * Snaps a coordinate to the grid, clamping it to [-kMaxQuantized,
+   * kMaxQuantized].
+   * @param value: World coordinate.
+   * @param origin: Origin of the axis.
+   * @param clamped: Set to true if the value had to be clamped.
+   * @return the quantized coordinate
+   */
+  int32_t quantize(double value, double origin, bool *clamped) const;
+  double dequantize(int32_t q, double origin) const {
+    return origin + q * resolution_;
+  }
+
+  double getResolution() const { return resolution_; }
+  double getOriginX() const { return origin_x_; }
+  double getOriginY() const { return origin_y_; }
+
+ private:
+  double resolution_, origin_x_, origin_y_;
+};
+
+/**
+ * Convex hull with vertices on the integer grid. The twice signed area is
+ * exact, and so are the containment tests.
+ */
+class QuantizedHull {
+ public:
+  typedef double Scalar;  // of the areas
+  typedef SmallVector<int32_t, kInlineApexes> CoordinateVector;
+  CoordinateVector xs, ys;
+  int64_t area2;  // twice the signed area, in grid units
+  int id;
+
+  QuantizedHull() : area2(0), id(0) {}
+  QuantizedHull(const int32_t *xs_, const int32_t *ys_, int n_apexes, int id_);
+
+  int getNvertices() const { return xs.size(); }
+  // Area in grid units (multiply by resolution^2 for world units)
+  double getArea() const { return std::abs(static_cast<double>(area2)) / 2; }
+
+  /**
+   * Tests whether a grid point is strictly inside the hull (exact).
+   * @param px, py: Quantized coordinates of the point.
+   * @return true or false
+   */
+  bool isPointInside(int64_t px, int64_t py) const;
+
+ private:
+  void computeArea();
+};
+
+/**
+ * Loads convex hulls as in convexHullsFromJson, quantizing the vertices at
+ * load time.
+ * @param data: Json object with the "convex hulls" array.
+ * @param quantizer: Grid the vertices are snapped to.
+ * @param report: If not null, filled with the quantization errors.
+ * @return vector with the quantized hulls
+ */
+std::vector<QuantizedHull> convexHullsFromJson(const json &data,
+                                               const Quantizer &quantizer,
+                                               QuantizationReport *report);
+
+/**
+ * Converts a quantized hull back to world coordinates.
+ * @param hull: Quantized hull.
+ * @param quantizer: The grid used to quantize it.
+ * @return the convex hull
+ */
+ConvexHull dequantize(const QuantizedHull &hull, const Quantizer &quantizer);
+
+/**
+ * Area of the intersection of two quantized hulls, in grid units. Vertex
+ * containment and edge crossings are decided exactly in int64; only the
+ * coordinates of the crossing points are computed in double.
+ * @param C1: First hull.
+ * @param C2: Second hull.
+ * @return the intersection area (0 if they do not overlap)
+ */
+double intersectionArea(const QuantizedHull &C1, const QuantizedHull &C2);
+
+// What eliminateOverlappingCHullsWith needs to run on quantized hulls: the
+// bounding box in grid units (exact in double), no rectangle pre-test and
+// the exact intersection area
+BoundingBox hullBounds(const QuantizedHull &hull);
+
+inline bool trustedMinAreaRectangle(const QuantizedHull & /*hull*/,
+                                    OrientedBox * /*rectangle*/) {
+  return false;
+}
+
+struct QuantizedIntersectionBackend {
+  static const char *getName() { return "quantized"; }
+
+  double intersectionArea(const QuantizedHull *C1,
+                          const QuantizedHull *C2) const {
+    return ::intersectionArea(*C1, *C2);
+  }
+};
+
+/**
+ * eliminateOverlappingCHulls on quantized hulls, through
+ * eliminateOverlappingCHullsWith with a QuantizedIntersectionBackend.
+ * @param input: Vector of quantized hulls.
+ * @param overlapping_percent: How much % of the overlaped area of a hull is
+ * necessary to consider it "eliminated"
+ * @returns Vector of remaining hulls.
+ */
+std::vector<QuantizedHull> eliminateOverlappingCHulls(
+    std::vector<QuantizedHull> *input, double overlapping_percent);
+
+#endif  //  INCLUDE_QUANTIZATION_HPP_
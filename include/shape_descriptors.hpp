@@ -0,0 +1,23 @@
+#ifndef INCLUDE_SHAPE_DESCRIPTORS_HPP_
+#define INCLUDE_SHAPE_DESCRIPTORS_HPP_
+
+#include <convex_hull.hpp>
+
+/**
+ * Diameter, minimum width, minimum area bounding rectangle and centroid of a
+ * convex polygon. One linear pass computes the signed area and the centroid,
+ * and a single rotating calipers walk over the edges gives the other three:
+ * for every edge it advances the vertex furthest along the edge, the vertex
+ * furthest from the edge (antipodal, giving the width and the diameter
+ * candidates) and the vertex furthest behind the edge. The minimum area
+ * rectangle has a side on an edge of the polygon, so the best of the n edge
+ * aligned rectangles is exact. Total cost O(n).
+ * @param apex: Pointer to the polygon vertices, ordered CCW or CW.
+ * @param n_apexes: Number of vertices.
+ * @return the descriptors (all zero for an empty polygon)
+ */
+template <typename T>
+HullDescriptorsT<T> computeHullDescriptors(const PointT<T> *apex,
+                                           int n_apexes);
+
+#endif  //  INCLUDE_SHAPE_DESCRIPTORS_HPP_
@@ -0,0 +1,120 @@
+#ifndef INCLUDE_SIMPLIFICATION_HPP_
+#define INCLUDE_SIMPLIFICATION_HPP_
+
+#include <convex_hull.hpp>
+#include <json.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+enum SimplificationMode {
+  kSimplifyOuter = 0,  // drops edges: the result contains the hull
+  kSimplifyInner       // drops vertices: the result is inside the hull
+};
+
+// "outer" or "inner". Throws std::invalid_argument for any other name.
+SimplificationMode simplificationModeFromName(const std::string &name);
+
+struct SimplificationOptions {
+ public:
+  SimplificationMode mode;
+  double max_error;  // Hausdorff distance bound between hull and result
+  int min_vertices;  // hulls with at most this many vertices are kept as is
+  SimplificationOptions()
+      : mode(kSimplifyOuter), max_error(0.), min_vertices(8) {}
+};
+
+/**
+ * Accuracy of a simplification. The result of either mode is nested with
+ * the hull (outer contains it, inner is contained), so the area of their
+ * symmetric difference is the area change. The intersection area of two
+ * simplified hulls differs from the original one by at most the sum of
+ * their area changes, which bounds the overlap area error of every pair.
+ */
+struct SimplificationReport {
+ public:
+  int n_hulls;
+  int n_simplified;        // hulls that lost vertices
+  int n_vertices_before;
+  int n_vertices_after;
+  double max_error;        // largest Hausdorff distance reached
+  double error_bound;      // max_error of the options
+  double max_area_change;  // largest absolute area change of a hull
+  double overlap_area_error_bound;  // two largest area changes added
+  SimplificationReport()
+      : n_hulls(0), n_simplified(0), n_vertices_before(0),
+        n_vertices_after(0), max_error(0.), error_bound(0.),
+        max_area_change(0.), overlap_area_error_bound(0.) {}
+
+  friend std::ostream &operator<<(std::ostream &stream,
+                                  const SimplificationReport &R) {
+    stream << "hulls: " << R.n_hulls << ", simplified: " << R.n_simplified
+           << ", vertices: " << R.n_vertices_before << " -> "
+           << R.n_vertices_after << ", max error: " << R.max_error
+           << ", error bound: " << R.error_bound
+           << ", max area change: " << R.max_area_change
+           << ", overlap area error bound: " << R.overlap_area_error_bound;
+    return stream;
+  }
+};
+
+/**
+ * Convex simplification with a guaranteed Hausdorff bound. Both modes make
+ * one greedy walk around the hull from its lowest (x, y) vertex, extending
+ * every run of removed vertices (edges) while the error stays within the bound.
+ * Inner mode keeps a subset of the vertices: a run of vertices is replaced
+ * by the chord between its neighbours, and the error is the distance from
+ * every removed vertex to that chord. Outer mode keeps a subset of the
+ * edges: a run of edges is replaced by extending its two neighbouring edges
+ * up to the point where their lines meet, and the error is the distance from
+ * that point to the removed part of the boundary. The result is convex and
+ * has at least 3 vertices.
+ * @param hull: Convex Hull, ordered CCW.
+ * @param options: Mode and error bound (min_vertices is ignored here).
+ * @param error: If not null, set to the Hausdorff distance reached.
+ * @return the simplified hull, with the ID of hull
+ */
+template <typename T>
+ConvexHullT<T> simplifyConvexHull(const ConvexHullT<T> &hull,
+                                  const SimplificationOptions &options,
+                                  T *error = nullptr);
+
+/**
+ * Simplifies every hull with more than options.min_vertices vertices.
+ * @param hulls: Convex Hulls, replaced by their simplified versions.
+ * @param options: Mode and error bound.
+ * @param report: If not null, filled with the simplification errors.
+ */
+void simplifyConvexHulls(std::vector<ConvexHull> *hulls,
+                         const SimplificationOptions &options,
+                         SimplificationReport *report);
+
+/**
+ * Loads convex hulls as in convexHullsFromJson, simplifying them at load
+ * time.
+ * @param data: Json object with the "convex hulls" array.
+ * @param options: Mode and error bound.
+ * @param report: If not null, filled with the simplification errors.
+ * @return vector with the simplified hulls
+ */
+std::vector<ConvexHull> convexHullsFromJson(
+    const json &data, const SimplificationOptions &options,
+    SimplificationReport *report);
+
+/**
+ * Measures the overlap area error of a simplification: the largest change
+ * of the intersection area of a pair of hulls. Candidate pairs come from a
+ * SpatialHashGrid over the bounding boxes of both sets.
+ * @param original: Convex Hulls before simplification.
+ * @param simplified: The same hulls, simplified.
+ * @param cell_size: Cell size of the spatial index, in the order of the
+ * typical convex hull size.
+ * @return the largest absolute intersection area difference
+ */
+double overlapAreaError(std::vector<ConvexHull> *original,
+                        std::vector<ConvexHull> *simplified,
+                        double cell_size = 10.);
+
+#endif  //  INCLUDE_SIMPLIFICATION_HPP_
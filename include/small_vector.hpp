@@ -0,0 +1,171 @@
+#ifndef INCLUDE_SMALL_VECTOR_HPP_
+#define INCLUDE_SMALL_VECTOR_HPP_
+
+#include <assert.h>
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Vector with inline storage for up to N elements, that only allocates on
+ * the heap when it grows larger. Restricted to trivially copyable types, so
+ * copies and (inline) moves are a single memcpy of the used elements and
+ * never call the allocator while the elements fit inline.
+ */
+template <typename T, int N>
+class SmallVector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SmallVector only holds trivially copyable types");
+  static_assert(N > 0, "SmallVector needs some inline capacity");
+
+ public:
+  typedef T value_type;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+  static const int kInlineCapacity = N;
+
+  SmallVector() : data_(inlineData()), size_(0), capacity_(N) {}
+
+  template <typename InputIt>
+  SmallVector(InputIt first, InputIt last) : SmallVector() {
+    assign(first, last);
+  }
+
+  explicit SmallVector(const std::vector<T> &other) : SmallVector() {
+    assign(other.data(), other.data() + other.size());
+  }
+
+  SmallVector(const SmallVector &other) : SmallVector() {
+    assign(other.data(), other.data() + other.size());
+  }
+
+  SmallVector(SmallVector &&other) noexcept : SmallVector() {
+    moveFrom(&other);
+  }
+
+  ~SmallVector() { release(); }
+
+  SmallVector &operator=(const SmallVector &other) {
+    if (this != &other) assign(other.data(), other.data() + other.size());
+    return *this;
+  }
+
+  SmallVector &operator=(SmallVector &&other) noexcept {
+    if (this != &other) {
+      release();
+      data_ = inlineData();
+      capacity_ = N;
+      size_ = 0;
+      moveFrom(&other);
+    }
+    return *this;
+  }
+
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last) {
+    clear();
+    for (; first != last; ++first) push_back(*first);
+  }
+
+  // Contiguous input is copied with a single memcpy
+  void assign(const T *first, const T *last) {
+    int n = last - first;
+    size_ = 0;
+    reserve(n);
+    if (n > 0) std::memcpy(data_, first, n * sizeof(T));
+    size_ = n;
+  }
+
+  void push_back(const T &value) {
+    if (size_ == capacity_) {
+      T copy = value;  // value may live in our own storage
+      reserve(2 * capacity_);
+      data_[size_++] = copy;
+    } else {
+      data_[size_++] = value;
+    }
+  }
+
+  void pop_back() {
+    assert(size_ > 0);
+    --size_;
+  }
+
+  void reserve(int n) {
+    if (n <= capacity_) return;
+    T *heap = static_cast<T *>(::operator new(n * sizeof(T)));
+    if (size_ > 0) std::memcpy(heap, data_, size_ * sizeof(T));
+    release();
+    data_ = heap;
+    capacity_ = n;
+  }
+
+  void resize(int n) {
+    reserve(n);
+    for (int i = size_; i < n; ++i) new (data_ + i) T();
+    size_ = n;
+  }
+
+  void clear() { size_ = 0; }
+
+  int size() const { return size_; }
+  int capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  // True while the elements live in the inline storage
+  bool isInline() const { return data_ == inlineData(); }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+  T &operator[](int i) { return data_[i]; }
+  const T &operator[](int i) const { return data_[i]; }
+  T &at(int i) {
+    if (i < 0 || i >= size_) throw std::out_of_range("SmallVector::at");
+    return data_[i];
+  }
+  const T &at(int i) const {
+    if (i < 0 || i >= size_) throw std::out_of_range("SmallVector::at");
+    return data_[i];
+  }
+  T &front() { return data_[0]; }
+  const T &front() const { return data_[0]; }
+  T &back() { return data_[size_ - 1]; }
+  const T &back() const { return data_[size_ - 1]; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+
+ private:
+  T *inlineData() { return reinterpret_cast<T *>(&storage_); }
+  const T *inlineData() const { return reinterpret_cast<const T *>(&storage_); }
+
+  void release() {
+    if (!isInline()) ::operator delete(data_);
+  }
+
+  // Expects this vector to be empty and inline
+  void moveFrom(SmallVector *other) {
+    if (other->isInline()) {
+      if (other->size_ > 0)
+        std::memcpy(data_, other->data_, other->size_ * sizeof(T));
+    } else {  // steal the heap buffer
+      data_ = other->data_;
+      capacity_ = other->capacity_;
+      other->data_ = other->inlineData();
+      other->capacity_ = N;
+    }
+    size_ = other->size_;
+    other->size_ = 0;
+  }
+
+  typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type storage_;
+  T *data_;
+  int size_;
+  int capacity_;
+};
+
+#endif  //  INCLUDE_SMALL_VECTOR_HPP_
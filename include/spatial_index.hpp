@@ -0,0 +1,108 @@
+#ifndef INCLUDE_SPATIAL_INDEX_HPP_
+#define INCLUDE_SPATIAL_INDEX_HPP_
+
+#include <algorithm>
+#include <convex_hull.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Axis aligned bounding box of a polygon. Used as a cheap broad-phase test
+ * before running the (expensive) polygon intersection.
+ */
+struct BoundingBox {
+ public:
+  double min_x, min_y, max_x, max_y;
+  BoundingBox() : min_x(0.), min_y(0.), max_x(0.), max_y(0.) {}
+  BoundingBox(double min_x_, double min_y_, double max_x_, double max_y_)
+      : min_x(min_x_), min_y(min_y_), max_x(max_x_), max_y(max_y_) {}
+
+  // Touching boxes are considered overlapping, so that the broad phase never
+  // rejects a pair the exact test would accept.
+  bool overlaps(const BoundingBox &other) const {
+    return !(other.min_x > max_x || other.max_x < min_x ||
+             other.min_y > max_y || other.max_y < min_y);
+  }
+};
+
+/**
+ * Computes the axis aligned bounding box of a set of vertices.
+ * @param vertices: Vertices of the polygon (at least one), in any container
+ * (std::vector, ConvexHullT::ApexVector, ...).
+ * @return the bounding box
+ */
+template <typename Container>
+BoundingBox computeBoundingBox(Container const &vertices) {
+  assert(!vertices.empty());
+  BoundingBox box(vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y);
+  for (const auto &p : vertices) {
+    box.min_x = std::min<double>(box.min_x, p.x);
+    box.min_y = std::min<double>(box.min_y, p.y);
+    box.max_x = std::max<double>(box.max_x, p.x);
+    box.max_y = std::max<double>(box.max_y, p.y);
+  }
+  return box;
+}
+
+/**
+ * Uniform hash grid over the plane. Every inserted box is registered in all
+ * the cells it touches, so a query only has to look at the cells covered by
+ * the query box. The grid does not need to know the extent of the data in
+ * advance, which makes it suitable for data that arrives incrementally.
+ * Boxes touching more than kMaxCellsPerBox cells, or with a non-finite
+ * coordinate, are kept in a separate list that every query checks, so no
+ * input can make the grid allocate or walk an unbounded number of cells.
+ */
+class SpatialHashGrid {
+ public:
+  /**
+   * @param cell_size: Side length of a grid cell. A good value is in the
+   * order of the typical polygon size.
+   */
+  explicit SpatialHashGrid(double cell_size);
+
+  /**
+   * Registers a box. Ids are assigned in insertion order, starting at 0.
+   * @param box: Bounding box of the element.
+   * @return the id given to the element
+   */
+  int insert(const BoundingBox &box);
+
+  /**
+   * Finds all the inserted elements whose box overlaps the query box.
+   * @param box: Query box.
+   * @param candidates: Ids of the overlapping elements, sorted ascending, are
+   * stored here (previous content is discarded).
+   */
+  void query(const BoundingBox &box, std::vector<int> *candidates);
+
+  void clear();
+  int size() const { return boxes_.size(); }
+  const BoundingBox &getBox(int id) const { return boxes_[id]; }
+
+  static const int64_t kMaxCellsPerBox = 4096;
+
+ private:
+  uint64_t cellKey(int64_t cx, int64_t cy) const;
+  int64_t cellCoordinate(double v) const;
+  /**
+   * @param box: Box.
+   * @param range: Set to the cells touched by the box: min x, max x, min y
+   * and max y cell coordinates.
+   * @return false if the box is not finite or touches more than
+   * kMaxCellsPerBox cells
+   */
+  bool cellRange(const BoundingBox &box, int64_t range[4]) const;
+
+  double cell_size_;
+  std::unordered_map<uint64_t, std::vector<int>> cells_;
+  // Elements that are not registered in any cell (see cellRange)
+  std::vector<int> oversized_;
+  std::vector<BoundingBox> boxes_;
+  // Per element stamp used to report every element only once per query
+  std::vector<unsigned> visited_;
+  unsigned query_stamp_;
+};
+
+#endif  //  INCLUDE_SPATIAL_INDEX_HPP_
@@ -0,0 +1,91 @@
+#ifndef INCLUDE_TEMPORAL_ELIMINATOR_HPP_
+#define INCLUDE_TEMPORAL_ELIMINATOR_HPP_
+
+#include <convex_hull.hpp>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Pair statistics of a single frame processed by a TemporalEliminator.
+ */
+struct FrameStats {
+ public:
+  int n_pairs;         // pairs that passed the bounding box test
+  int n_cache_hits;    // pairs whose previous frame result was reused
+  int n_recomputed;    // pairs whose intersection was computed
+  int n_dirty_hulls;   // hulls that are new or moved beyond the tolerance
+  FrameStats() : n_pairs(0), n_cache_hits(0), n_recomputed(0),
+                 n_dirty_hulls(0) {}
+
+  double getHitRate() const {
+    return n_pairs == 0 ? 0. : static_cast<double>(n_cache_hits) / n_pairs;
+  }
+
+  friend std::ostream &operator<<(std::ostream &stream, const FrameStats &S) {
+    stream << "pairs: " << S.n_pairs << ", cache hits: " << S.n_cache_hits
+           << ", recomputed: " << S.n_recomputed
+           << ", dirty hulls: " << S.n_dirty_hulls
+           << ", hit rate: " << S.getHitRate();
+    return stream;
+  }
+};
+
+/**
+ * Frame-aware version of eliminateOverlappingCHulls for sequences of frames
+ * that contain mostly the same convex hulls, slightly moved.
+ *
+ * Hulls are matched across frames by ConvexHull::id (ids must be unique
+ * within a frame). A hull is "dirty" when it is new, its number of vertices
+ * changed, or one of its vertices moved more than the tolerance away from the
+ * vertices its cached results were computed with. Only pairs with at least one
+ * dirty hull are intersected again, the intersection area of the other pairs
+ * is taken from the previous frame.
+ *
+ * With a tolerance of 0 the result is the same as the batch function.
+ */
+class TemporalEliminator {
+ public:
+  /**
+   * @param overlapping_percent: How much % of the overlaped area of a polygon
+   * is necessary to consider it "eliminated"
+   * @param tolerance: Maximum distance a vertex can move for the hull to
+   * still reuse its previous results.
+   */
+  TemporalEliminator(double overlapping_percent, double tolerance);
+
+  /**
+   * Runs the elimination on a new frame, reusing the still valid pair results
+   * of the previous frame.
+   * @param frame: Convex Hulls of the frame.
+   * @returns Vector of remaining polygons/C. Hulls.
+   */
+  std::vector<ConvexHull> processFrame(std::vector<ConvexHull> *frame);
+
+  /**
+   * @returns the pair statistics (and cache hit rate) of the last frame.
+   */
+  const FrameStats &getLastFrameStats() const { return stats_; }
+
+  // Forget all cached results, the next frame is computed from scratch
+  void reset();
+
+ private:
+  struct PairResult {
+    bool intersect;
+    double area;
+  };
+
+  bool isDirty(const ConvexHull &hull) const;
+  static uint64_t pairKey(int id_a, int id_b);
+
+  double overlapping_percent_;
+  double tolerance_;
+  // Vertices the cached results of each hull id were computed with
+  std::unordered_map<int, std::vector<Point>> reference_apexes_;
+  std::unordered_map<uint64_t, PairResult> pair_cache_;
+  FrameStats stats_;
+};
+
+#endif  //  INCLUDE_TEMPORAL_ELIMINATOR_HPP_
@@ -0,0 +1,61 @@
+#ifndef INCLUDE_THREAD_POOL_HPP_
+#define INCLUDE_THREAD_POOL_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads fed from a single task queue. Besides plain
+ * tasks it offers a blocking parallelFor in which the calling thread also
+ * works, so it can be used from inside a task without deadlocking. Every
+ * chunk of a parallelFor is recorded as a trace span, which shows the load
+ * balance of each worker in the trace viewer.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param n_threads: Number of worker threads. 0 uses one per hardware
+   * thread.
+   */
+  explicit ThreadPool(int n_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int getNThreads() const { return workers_.size(); }
+
+  /**
+   * Queues a task.
+   * @param task: Function to run on a worker.
+   * @return a future that becomes ready when the task has run
+   */
+  std::future<void> submit(std::function<void()> task);
+
+  /**
+   * Runs body over [0, n) split in chunks of (at most) grain indices, and
+   * returns once every chunk is done. Chunks are handed out dynamically, so
+   * uneven chunks are balanced between the threads.
+   * @param n: Number of indices.
+   * @param grain: Number of indices per chunk.
+   * @param body: Called as body(begin, end) for every chunk.
+   */
+  void parallelFor(int n, int grain,
+                   const std::function<void(int, int)> &body);
+
+ private:
+  void workerLoop();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  bool stop_;
+};
+
+#endif  //  INCLUDE_THREAD_POOL_HPP_
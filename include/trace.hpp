@@ -0,0 +1,103 @@
+#ifndef INCLUDE_TRACE_HPP_
+#define INCLUDE_TRACE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * Span tracing of the hot paths, exported in the Chrome trace-event format
+ * (open the file in chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Every thread writes its spans to its own fixed size ring buffer, so
+ * recording takes no lock: the owning thread is the only writer and publishes
+ * each event with a release store of the ring head. When a ring is full the
+ * oldest spans are overwritten. When a thread exits, its spans are moved to a
+ * ring shared by all the exited threads and its buffer is freed, so memory is
+ * bounded by the live threads. Tracing is off until setEnabled(true) is
+ * called, and building without CONVEX_HULL_TRACE compiles the CH_TRACE_*
+ * macros out completely.
+ */
+namespace trace {
+
+// Spans kept per thread before the oldest ones are overwritten
+const int kRingCapacity = 1 << 16;
+
+struct TraceEvent {
+  const char *name;  // must be a string literal (it is stored, not copied)
+  uint64_t start_ns;
+  uint64_t duration_ns;
+  int64_t arg0, arg1;  // optional span arguments, kNoArg when unused
+};
+const int64_t kNoArg = INT64_MIN;
+
+extern std::atomic<bool> enabled;
+inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool on);
+
+// Nanoseconds since the first use of the tracer
+uint64_t now();
+
+/**
+ * Appends a span to the ring buffer of the calling thread.
+ */
+void record(const TraceEvent &event);
+
+/**
+ * Writes all the recorded spans (of every thread) as Chrome trace-event json.
+ * It should be called when the traced threads are idle.
+ * @param stream: Output stream.
+ * @returns the number of spans written
+ */
+int writeChromeTrace(std::ostream &stream);
+
+// Drops all the recorded spans
+void clear();
+
+// Number of per thread ring buffers allocated (threads alive that recorded)
+int getNThreadBuffers();
+
+/**
+ * Records a span covering its own lifetime, if tracing is enabled.
+ */
+class ScopedSpan {
+ public:
+  explicit ScopedSpan(const char *name, int64_t arg0 = kNoArg,
+                      int64_t arg1 = kNoArg)
+      : active_(isEnabled()) {
+    if (active_) {
+      event_.name = name;
+      event_.arg0 = arg0;
+      event_.arg1 = arg1;
+      event_.start_ns = now();
+    }
+  }
+  ~ScopedSpan() {
+    if (active_) {
+      event_.duration_ns = now() - event_.start_ns;
+      record(event_);
+    }
+  }
+  ScopedSpan(const ScopedSpan &) = delete;
+  ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+ private:
+  bool active_;
+  TraceEvent event_;
+};
+
+}  // namespace trace
+
+#define CH_TRACE_CONCAT_(a, b) a##b
+#define CH_TRACE_CONCAT(a, b) CH_TRACE_CONCAT_(a, b)
+
+#ifdef CONVEX_HULL_TRACE
+#define CH_TRACE_SPAN(...) \
+  trace::ScopedSpan CH_TRACE_CONCAT(trace_span_, __LINE__)(__VA_ARGS__)
+#else
+#define CH_TRACE_SPAN(...) \
+  do {                     \
+  } while (0)
+#endif
+
+#endif  //  INCLUDE_TRACE_HPP_
@@ -0,0 +1,117 @@
+#include <glob.h>
+
+#include <batch.hpp>
+#include <deque>
+#include <fstream>
+#include <instrumentation.hpp>
+#include <memory>
+#include <trace.hpp>
+
+namespace {
+void expandPattern(const std::string &pattern,
+                   std::vector<std::string> *files) {
+  glob_t matches;
+  // GLOB_NOCHECK returns the pattern itself when nothing matches
+  if (glob(pattern.c_str(), GLOB_NOCHECK, nullptr, &matches) != 0) {
+    files->push_back(pattern);
+    return;
+  }
+  for (size_t i = 0; i < matches.gl_pathc; ++i)
+    files->push_back(matches.gl_pathv[i]);
+  globfree(&matches);
+}
+
+// Reads, processes and writes one file. Returns an empty string or the error
+std::string processFile(const std::string &input, const std::string &output,
+                        const std::function<json(const json &)> &process) {
+  json data;
+  {
+    CH_STATS_STAGE(kStageParse);
+    CH_TRACE_SPAN("parse");
+    std::ifstream f(input);
+    if (!f) return "can not open the file";
+    try {
+      data = json::parse(f);
+    } catch (const std::exception &e) {
+      return e.what();
+    }
+  }
+  json result;
+  try {
+    result = process(data);
+  } catch (const std::exception &e) {
+    return e.what();
+  }
+  {
+    CH_STATS_STAGE(kStageWrite);
+    CH_TRACE_SPAN("write");
+    std::ofstream file(output);
+    if (!file) return "can not write " + output;
+    file << std::setw(4) << result << std::endl;
+  }
+  return std::string();
+}
+}  // namespace
+
+std::vector<std::string> expandInputs(
+    const std::vector<std::string> &arguments) {
+  std::vector<std::string> files;
+  for (const std::string &argument : arguments) {
+    if (argument.size() > 1 && argument[0] == '@') {
+      std::ifstream list(argument.substr(1));
+      std::string line;
+      while (std::getline(list, line)) {
+        if (!line.empty()) expandPattern(line, &files);
+      }
+    } else {
+      expandPattern(argument, &files);
+    }
+  }
+  return files;
+}
+
+std::string batchOutputPath(const std::string &input,
+                            const std::string &output_dir) {
+  size_t slash = input.find_last_of('/');
+  std::string name =
+      slash == std::string::npos ? input : input.substr(slash + 1);
+  if (output_dir.empty()) return name;
+  if (output_dir.back() == '/') return output_dir + name;
+  return output_dir + "/" + name;
+}
+
+BatchResult processBatch(const std::vector<std::string> &inputs,
+                         const std::string &output_dir,
+                         const std::function<json(const json &)> &process,
+                         ThreadPool *pool, int max_in_flight) {
+  CH_TRACE_SPAN("processBatch", inputs.size());
+  if (max_in_flight <= 0) max_in_flight = 2 * pool->getNThreads();
+  BatchResult result;
+  result.n_files = inputs.size();
+
+  // One error slot per file, written by its task only
+  std::vector<std::string> errors(inputs.size());
+  std::deque<std::future<void>> in_flight;
+  for (int i = 0; i < inputs.size(); ++i) {
+    // Waits for the oldest file before starting a new one once the window is
+    // full; the others keep running meanwhile
+    if (in_flight.size() == max_in_flight) {
+      in_flight.front().get();
+      in_flight.pop_front();
+    }
+    in_flight.push_back(pool->submit([&, i] {
+      CH_TRACE_SPAN("batch file", i);
+      errors[i] =
+          processFile(inputs[i], batchOutputPath(inputs[i], output_dir),
+                      process);
+    }));
+  }
+  for (std::future<void> &task : in_flight) task.get();
+
+  for (int i = 0; i < inputs.size(); ++i) {
+    if (errors[i].empty()) continue;
+    ++result.n_failed;
+    result.errors.push_back(inputs[i] + ": " + errors[i]);
+  }
+  return result;
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <binary_format.hpp>
+#include <cmath>
+#include <cstring>
+#include <trace.hpp>
+
+namespace {
+template <typename V>
+void append(const V &value, std::string *out) {
+  out->append(reinterpret_cast<const char *>(&value), sizeof(V));
+}
+
+// Reads a value and advances the cursor, false when past the end
+template <typename V>
+bool read(const char **cursor, const char *end, V *value) {
+  if (end - *cursor < static_cast<ptrdiff_t>(sizeof(V))) return false;
+  std::memcpy(value, *cursor, sizeof(V));
+  *cursor += sizeof(V);
+  return true;
+}
+
+const int kDescriptorValues = 9;
+
+void appendDescriptors(const HullDescriptors &descriptors, std::string *out) {
+  const double values[kDescriptorValues] = {
+      descriptors.diameter,      descriptors.min_width,
+      descriptors.centroid.x,    descriptors.centroid.y,
+      descriptors.rect_center.x, descriptors.rect_center.y,
+      descriptors.rect_half_x,   descriptors.rect_half_y,
+      descriptors.rect_yaw};
+  out->append(reinterpret_cast<const char *>(values), sizeof(values));
+}
+
+// Reads the descriptors and advances the cursor, false when past the end
+bool readDescriptors(const char **cursor, const char *end,
+                     HullDescriptors *descriptors) {
+  double values[kDescriptorValues];
+  if (end - *cursor < static_cast<ptrdiff_t>(sizeof(values))) return false;
+  std::memcpy(values, *cursor, sizeof(values));
+  *cursor += sizeof(values);
+  descriptors->diameter = values[0];
+  descriptors->min_width = values[1];
+  descriptors->centroid = Point(values[2], values[3]);
+  descriptors->rect_center = Point(values[4], values[5]);
+  descriptors->rect_half_x = values[6];
+  descriptors->rect_half_y = values[7];
+  descriptors->rect_yaw = values[8];
+  return true;
+}
+}  // namespace
+
+void encodeHulls(const std::vector<ConvexHull> &hulls, std::string *out) {
+  CH_TRACE_SPAN("encodeHulls", hulls.size());
+  // Version 1 unless some hull carries descriptors
+  bool v2 = std::any_of(hulls.begin(), hulls.end(), [](const ConvexHull &c) {
+    return c.getCachedDescriptors() != nullptr;
+  });
+  size_t size = 2 * sizeof(uint32_t);
+  for (const ConvexHull &hull : hulls) {
+    size += 2 * sizeof(uint32_t) + hull.apex.size() * 2 * sizeof(double);
+    if (v2) size += sizeof(uint32_t);
+    if (hull.getCachedDescriptors())
+      size += kDescriptorValues * sizeof(double);
+  }
+  out->clear();
+  out->reserve(size);
+  append(v2 ? kBinaryHullsMagicV2 : kBinaryHullsMagic, out);
+  append(static_cast<uint32_t>(hulls.size()), out);
+  for (const ConvexHull &hull : hulls) {
+    append(static_cast<int32_t>(hull.id), out);
+    append(static_cast<uint32_t>(hull.apex.size()), out);
+    const HullDescriptors *descriptors = hull.getCachedDescriptors();
+    if (v2) append(descriptors ? kBinaryHullHasDescriptors : 0u, out);
+    for (const Point &p : hull.apex) {
+      append(p.x, out);
+      append(p.y, out);
+    }
+    if (descriptors) appendDescriptors(*descriptors, out);
+  }
+}
+
+bool decodeHulls(const char *data, size_t size,
+                 std::vector<ConvexHull> *hulls) {
+  CH_TRACE_SPAN("decodeHulls", size);
+  const char *cursor = data, *end = data + size;
+  uint32_t magic, n_hulls;
+  if (!read(&cursor, end, &magic)) return false;
+  if (magic != kBinaryHullsMagic && magic != kBinaryHullsMagicV2)
+    return false;
+  bool v2 = magic == kBinaryHullsMagicV2;
+  if (!read(&cursor, end, &n_hulls)) return false;
+  // Every hull takes at least 8 bytes: a corrupted count can not make the
+  // reserve below allocate more than the message
+  if (n_hulls > static_cast<size_t>(end - cursor) / 8) return false;
+  hulls->clear();
+  hulls->reserve(n_hulls);
+
+  ConvexHull::ApexVector apexes;
+  for (uint32_t n = 0; n < n_hulls; ++n) {
+    int32_t id;
+    uint32_t n_apexes, flags = 0;
+    if (!read(&cursor, end, &id) || !read(&cursor, end, &n_apexes))
+      return false;
+    if (v2 && !read(&cursor, end, &flags)) return false;
+    if (n_apexes < 3 ||
+        n_apexes > static_cast<size_t>(end - cursor) / (2 * sizeof(double)))
+      return false;
+    apexes.clear();
+    for (uint32_t a = 0; a < n_apexes; ++a) {
+      double x, y;
+      read(&cursor, end, &x);
+      read(&cursor, end, &y);
+      if (!std::isfinite(x) || !std::isfinite(y)) return false;
+      apexes.push_back(Point(x, y));
+    }
+    hulls->emplace_back(apexes.data(), apexes.size(), id);
+    if (flags & kBinaryHullHasDescriptors) {
+      HullDescriptors descriptors;
+      if (!readDescriptors(&cursor, end, &descriptors)) return false;
+      hulls->back().setDescriptors(descriptors);
+    }
+  }
+  return cursor == end;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <clustering.hpp>
+#include <instrumentation.hpp>
+#include <spatial_index.hpp>
+#include <trace.hpp>
+
+namespace {
+// Rows per parallel chunk
+const int kRowGrain = 64;
+}  // namespace
+
+ConcurrentUnionFind::ConcurrentUnionFind(int n)
+    : n_(n), parent_(new std::atomic<int>[n]) {
+  for (int i = 0; i < n; ++i) parent_[i].store(i, std::memory_order_relaxed);
+}
+
+int ConcurrentUnionFind::find(int i) {
+  while (true) {
+    int parent = parent_[i].load(std::memory_order_acquire);
+    if (parent == i) return i;
+    int grandparent = parent_[parent].load(std::memory_order_acquire);
+    // Path halving. Losing the race is harmless: another thread has already
+    // moved i closer to the root.
+    if (grandparent != parent)
+      parent_[i].compare_exchange_weak(parent, grandparent,
+                                       std::memory_order_acq_rel);
+    i = grandparent;
+  }
+}
+
+bool ConcurrentUnionFind::unite(int i, int j) {
+  while (true) {
+    i = find(i);
+    j = find(j);
+    if (i == j) return false;
+    if (j < i) std::swap(i, j);
+    // Link the larger root j under i, only if j is still a root
+    int expected = j;
+    if (parent_[j].compare_exchange_strong(expected, i,
+                                           std::memory_order_acq_rel))
+      return true;
+  }
+}
+
+HullClusters clusterOverlappingCHulls(std::vector<ConvexHull> *hulls,
+                                      double min_intersection_area,
+                                      ThreadPool *pool, double cell_size) {
+  CH_TRACE_SPAN("clusterOverlappingCHulls", hulls->size());
+  int n_hulls = hulls->size();
+  HullClusters clusters;
+  if (n_hulls == 0) return clusters;
+
+  // Candidates j > i of every hull, in CSR layout
+  SpatialHashGrid grid(cell_size);
+  std::vector<BoundingBox> boxes;
+  boxes.reserve(n_hulls);
+  for (const ConvexHull &c : *hulls) {
+    boxes.push_back(computeBoundingBox(c.apex));
+    grid.insert(boxes.back());
+  }
+  std::vector<int> offsets(n_hulls + 1, 0), candidates, found;
+  for (int i = 0; i < n_hulls; ++i) {
+    grid.query(boxes[i], &found);
+    for (int j : found) {
+      if (j > i) candidates.push_back(j);
+    }
+    offsets[i + 1] = candidates.size();
+  }
+  CH_STATS_COUNT(kPairsConsidered, candidates.size());
+
+  ConcurrentUnionFind components(n_hulls);
+  auto unite_rows = [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+        int j = candidates[k];
+        // Already connected through other pairs: skip the intersection
+        if (components.find(i) == components.find(j)) continue;
+        double intersection_area = intersectionArea(&hulls->at(i),
+                                                    &hulls->at(j));
+        if (intersection_area <= 0) continue;
+        CH_STATS_COUNT(kPairsIntersected, 1);
+        if (intersection_area > min_intersection_area) components.unite(i, j);
+      }
+    }
+  };
+  if (pool != nullptr)
+    pool->parallelFor(n_hulls, kRowGrain, unite_rows);
+  else
+    unite_rows(0, n_hulls);
+
+  // The root of every set is its first member, so it is labeled before the
+  // other members
+  clusters.labels.resize(n_hulls);
+  for (int i = 0; i < n_hulls; ++i) {
+    int root = components.find(i);
+    clusters.labels[i] =
+        root == i ? clusters.n_clusters++ : clusters.labels[root];
+  }
+  return clusters;
+}
@@ -1,27 +1,55 @@
 #include <convex_hull.hpp>
+#include <hull_kernels.hpp>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
+#include <predicates.hpp>
+#include <shape_descriptors.hpp>
+#include <spatial_index.hpp>
+#include <stdexcept>
+#include <string>
+#include <trace.hpp>
+
+template <typename T>
+ConvexHullT<T>::ConvexHullT(std::vector<PointT<T>> const &apex_, int id_)
+    : apex(apex_), id(id_), has_descriptors_(false) {
+  assert(apex.size() >= 3);
+  computeArea();
+}
 
-ConvexHull::ConvexHull(std::vector<Point> const &apex_, int id_)
-    : apex(apex_), id(id_) {
+template <typename T>
+ConvexHullT<T>::ConvexHullT(const PointT<T> *apex_, int n_apexes, int id_)
+    : apex(apex_, apex_ + n_apexes), id(id_), has_descriptors_(false) {
   assert(apex.size() >= 3);
   computeArea();
-  computeLineSegments();
 }
 
-ConvexHull::ConvexHull() {}
+template <typename T>
+ConvexHullT<T>::ConvexHullT() : has_descriptors_(false) {}
 
-void ConvexHull::computeArea() {  // The inner triangles of the Polygon are
-                                  // added to get the areaof the polygon
+template <typename T>
+void ConvexHullT<T>::computeArea() {  // The inner triangles of the Polygon
+                                      // are added to get the area of the
+                                      // polygon
   // A formula for this is:
   // area = 0.5 * det{([x1,x2],[y1,y2]) + ([x2,x3],[y2,y3]) + ... +
   // ([xn,x1],[yn,y1])}
+  // Triangles and quadrilaterals use the unrolled kernels
+  if (apex.size() == 3) {
+    area = PolygonKernel<T, 3>::area(apex.data());
+    return;
+  }
+  if (apex.size() == 4) {
+    area = PolygonKernel<T, 4>::area(apex.data());
+    return;
+  }
   area = 0;
-  Matrix apexMatrix;
+  MatrixT<T> apexMatrix;
   // The loop below ignores the Matrix ([xn,x1],[yn,y1]), so we add it manually
   // to the sum
-  apexMatrix = Matrix(apex[apex.size() - 1], apex[0]);
+  apexMatrix = MatrixT<T>(apex[apex.size() - 1], apex[0]);
   area = apexMatrix.getDeterminant();
   for (int i = 0; i < apex.size() - 1; ++i) {
-    Matrix temp(apex[i], apex[i + 1]);
+    MatrixT<T> temp(apex[i], apex[i + 1]);
     area += temp.getDeterminant();
   }
 
@@ -29,56 +57,119 @@ void ConvexHull::computeArea() {  // The inner triangles of the Polygon are
   if (area < 0) area *= -1.;
 }
 
-void ConvexHull::computeLineSegments() {
-  line_segments.reserve(apex.size());
+template <typename T>
+T ConvexHullT<T>::getArea() {
+  computeArea();
+  return area;
+}
+template <typename T>
+int ConvexHullT<T>::getNvertices() {
+  return apex.size();
+}
+template <typename T>
+int ConvexHullT<T>::getNSegments() {
+  return apex.size();
+}
 
-  for (int i = 0; i < apex.size() - 1; ++i) {
-    Line segment(apex[i], apex[i + 1]);
-    line_segments.push_back(segment);
+template <typename T>
+const HullDescriptorsT<T> &ConvexHullT<T>::getDescriptors() {
+  if (!has_descriptors_) {
+    descriptors_ = computeHullDescriptors(apex.data(), apex.size());
+    has_descriptors_ = true;
   }
-  Line segment(apex[apex.size() - 1], apex[0]);
-  line_segments.push_back(segment);
+  return descriptors_;
 }
 
-double ConvexHull::getArea() {
-  computeArea();
-  return area;
+namespace {
+template <typename T>
+json pointToJson(const PointT<T> &P) {
+  json point;
+  point["x"] = P.x;
+  point["y"] = P.y;
+  return point;
+}
+
+template <typename T>
+json descriptorsToJson(const HullDescriptorsT<T> &descriptors) {
+  json data, rectangle;
+  data["diameter"] = descriptors.diameter;
+  data["min_width"] = descriptors.min_width;
+  data["centroid"] = pointToJson(descriptors.centroid);
+  rectangle["center"] = pointToJson(descriptors.rect_center);
+  rectangle["half_x"] = descriptors.rect_half_x;
+  rectangle["half_y"] = descriptors.rect_half_y;
+  rectangle["yaw"] = descriptors.rect_yaw;
+  data["min_area_rectangle"] = rectangle;
+  return data;
 }
-int ConvexHull::getNvertices() { return apex.size(); }
-int ConvexHull::getNSegments() { return line_segments.size(); }
 
-std::vector<ConvexHull> convexHullsFromJson(const json &data) {
+template <typename T>
+PointT<T> pointFromJson(const json &data) {
+  return PointT<T>(data["x"].get<T>(), data["y"].get<T>());
+}
+
+template <typename T>
+HullDescriptorsT<T> descriptorsFromJson(const json &data) {
+  HullDescriptorsT<T> descriptors;
+  const json &rectangle = data["min_area_rectangle"];
+  descriptors.diameter = data["diameter"];
+  descriptors.min_width = data["min_width"];
+  descriptors.centroid = pointFromJson<T>(data["centroid"]);
+  descriptors.rect_center = pointFromJson<T>(rectangle["center"]);
+  descriptors.rect_half_x = rectangle["half_x"];
+  descriptors.rect_half_y = rectangle["half_y"];
+  descriptors.rect_yaw = rectangle["yaw"];
+  return descriptors;
+}
+}  // namespace
+
+template <typename T>
+std::vector<ConvexHullT<T>> convexHullsFromJson(const json &data) {
+  CH_TRACE_SPAN("convexHullsFromJson");
   int n_hulls = data["convex hulls"].size();
-  std::vector<ConvexHull> convex_hull_v;
+  std::vector<ConvexHullT<T>> convex_hull_v;
   convex_hull_v.reserve(n_hulls);
   for (int n = 0; n < n_hulls; ++n) {
     int n_apexes = data["convex hulls"][n]["apexes"].size();
-    std::vector<Point> apexes;
+    // The constructors assert on fewer than 3 apexes: malformed input is
+    // rejected before them with an exception the callers can report
+    if (n_apexes < 3)
+      throw std::invalid_argument("convex hull " + std::to_string(n) +
+                                  " has fewer than 3 apexes");
+    // Built in inline storage, so small hulls are loaded without allocating
+    typename ConvexHullT<T>::ApexVector apexes;
     apexes.reserve(n_apexes);
     for (int a = 0; a < n_apexes; ++a) {
-      double x, y;
+      T x, y;
       x = data["convex hulls"][n]["apexes"][a]["x"];
       y = data["convex hulls"][n]["apexes"][a]["y"];
-      Point p(x, y);
+      if (!std::isfinite(x) || !std::isfinite(y))
+        throw std::invalid_argument("convex hull " + std::to_string(n) +
+                                    " has a non-finite apex");
+      PointT<T> p(x, y);
       apexes.push_back(p);
     }
 
     int id = data["convex hulls"][n]["ID"];
-    ConvexHull c(apexes, id);
-    convex_hull_v.push_back(c);
+    convex_hull_v.emplace_back(apexes.data(), apexes.size(), id);
+    if (data["convex hulls"][n].count("descriptors"))
+      convex_hull_v.back().setDescriptors(
+          descriptorsFromJson<T>(data["convex hulls"][n]["descriptors"]));
   }
   return convex_hull_v;
 }
 
-json convexHullsToJson(const std::vector<ConvexHull> &c_hull_vector) {
+template <typename T>
+json convexHullsToJson(const std::vector<ConvexHullT<T>> &c_hull_vector) {
+  CH_TRACE_SPAN("convexHullsToJson");
   // Create an array-like structure to hold all convex hulls data
   json convex_hull_array = json::array();
-  for (auto convex_hull :
+  for (const auto &convex_hull :
        c_hull_vector) {  // To store all the data of a single c. Hull
     json single_c_hull_data;
     // For each convex hull there is an array of points
     json apex_array = json::array();
-    for (auto Point : convex_hull.apex) {
+    for (const auto &Point : convex_hull.apex) {
       json point_pair;
       point_pair["x"] = Point.x;
       point_pair["y"] = Point.y;
@@ -86,6 +177,9 @@ json convexHullsToJson(const std::vector<ConvexHull> &c_hull_vector) {
     }
     single_c_hull_data["ID"] = convex_hull.id;
     single_c_hull_data["apexes"] = apex_array;
+    if (convex_hull.getCachedDescriptors())
+      single_c_hull_data["descriptors"] =
+          descriptorsToJson(*convex_hull.getCachedDescriptors());
     convex_hull_array.push_back(single_c_hull_data);
   }
 
@@ -94,30 +188,40 @@ json convexHullsToJson(const std::vector<ConvexHull> &c_hull_vector) {
   return output;
 }
 
-bool ConvexHull::isPointInside(const Point &P) {
-  return pointInPolygon(apex, P);
+template <typename T>
+bool ConvexHullT<T>::isPointInside(const PointT<T> &P) {
+  if (apex.size() == 3) return PolygonKernel<T, 3>::contains(apex.data(), P);
+  if (apex.size() == 4) return PolygonKernel<T, 4>::contains(apex.data(), P);
+  return pointInPolygon(apex.data(), apex.size(), P);
 }
 
-void ConvexHull::set_apexes(std::vector<Point> const &apex_) {
-  apex = apex_;
+template <typename T>
+void ConvexHullT<T>::set_apexes(std::vector<PointT<T>> const &apex_) {
+  apex.assign(apex_.data(), apex_.data() + apex_.size());
   assert(apex.size() >= 3);
+  has_descriptors_ = false;
   computeArea();
-  computeLineSegments();
 }
 
-bool pointInPolygon(std::vector<Point> const &vertices, const Point P) {
-  int n_vertices = vertices.size();
-  int i, j;
+template <typename T>
+bool pointInPolygon(std::vector<PointT<T>> const &vertices, const PointT<T> P) {
+  return pointInPolygon(vertices.data(), vertices.size(), P);
+}
+
+template <typename T>
+bool pointInPolygon(const PointT<T> *vertices, int n_vertices,
+                    const PointT<T> P) {
+  int i;
   bool inside = false;
   // looping for all the edges
   for (i = 0; i < n_vertices; ++i) {
     int j = (i + 1) % n_vertices;
 
     // The vertices of the edge we are checking.
-    double xp0 = vertices[i].x;
-    double yp0 = vertices[i].y;
-    double xp1 = vertices[j].x;
-    double yp1 = vertices[j].y;
+    T xp0 = vertices[i].x;
+    T yp0 = vertices[i].y;
+    T xp1 = vertices[j].x;
+    T yp1 = vertices[j].y;
 
     // Check whether the edge intersects a line from (-inf,P.y) to (P.x,P.y).
 
@@ -127,7 +231,7 @@ bool pointInPolygon(std::vector<Point> const &vertices, const Point P) {
       // If so, get the point where it crosses that line. Note that we can't get
       // a division by zero here - if yp1 == yp0 then the above condition is
       // false.
-      double cross = (xp1 - xp0) * (P.y - yp0) / (yp1 - yp0) + xp0;
+      T cross = (xp1 - xp0) * (P.y - yp0) / (yp1 - yp0) + xp0;
 
       // Finally check if it crosses to the left of our test point.
       if (cross < P.x) inside = !inside;
@@ -136,42 +240,30 @@ bool pointInPolygon(std::vector<Point> const &vertices, const Point P) {
   return inside;
 }
 
-bool segmentsIntersect(Line *L1, Line *L2, Point *intersect_point,
-                       const double &epsilon) {
-  float ax = L1->p2.x - L1->p1.x;  // direction of line a
-  float ay = L1->p2.y - L1->p1.y;  // ax and ay as above
-
-  float bx = L2->p1.x - L2->p2.x;  // direction of line b, reversed
-  float by = L2->p1.y - L2->p2.y;
-
-  float dx = L2->p1.x - L1->p1.x;  // right-hand side
-  float dy = L2->p1.y - L1->p1.y;
-
-  double det = ax * by - ay * bx;
-
-  // floating point error forces us to use a non zero, small epsilon
-  // lines are parallel, they could be collinear, but in that
-  // case,  we dont care since the points will be detected when
-  // we check if other lines of the polygon intersect
-  if (std::abs(det) < epsilon) return false;
-
-  double t = (dx * by - dy * bx) / det;
-  double u = (ax * dy - ay * dx) / det;
-  // if both t and u between 0 and 1, the segements intersect
-  bool intersect = !(t < 0 || t > 1 || u < 0 || u > 1);
-
-  if (intersect) {
-    // If both lines intersect, we have the point by the equation P = P1 +
-    // (P2-P1)*t or P = P3 + (P4-P3) * u
-    *intersect_point = L1->p1 + (L1->p2 - L1->p1) * t;
-  }
+template <typename T>
+bool segmentsIntersect(LineT<T> *L1, LineT<T> *L2,
+                       PointT<T> *intersect_point) {
+  // The orientation signs are exact, so touching or nearly parallel segments
+  // are classified consistently whatever their size
+  double t;
+  if (!predicates::segmentsCross(L1->p1, L1->p2, L2->p1, L2->p2, &t))
+    return false;
+  // If both lines intersect, we have the point by the equation P = P1 +
+  // (P2-P1)*t
+  *intersect_point = L1->p1 + (L1->p2 - L1->p1) * static_cast<T>(t);
+  return true;
+}
 
-  return intersect;
+template <typename T>
+bool segmentsIntersect(LineT<T> *L1, LineT<T> *L2, PointT<T> *intersect_point,
+                       const double & /*epsilon*/) {
+  return segmentsIntersect(L1, L2, intersect_point);
 }
 
-std::vector<Point> getIntersectionPolygonVertices(ConvexHull *C1,
-                                                  ConvexHull *C2) {
-  std::vector<Point> intersectionVertices;
+template <typename T>
+std::vector<PointT<T>> getIntersectionPolygonVertices(ConvexHullT<T> *C1,
+                                                      ConvexHullT<T> *C2) {
+  std::vector<PointT<T>> intersectionVertices;
   int n_vert_C1 = C1->getNvertices();
   int n_vert_C2 = C2->getNvertices();
   int n_segment_C1 = C1->getNSegments();
@@ -193,12 +285,12 @@ std::vector<Point> getIntersectionPolygonVertices(ConvexHull *C1,
   // Check if the line segments connecting each apex of each convexhull, happen
   // to intersect
   for (int i = 0; i < n_segment_C1; ++i) {
+    LineT<T> segment_C1 = C1->getSegment(i);
     for (int j = 0; j < n_segment_C2; ++j) {
-      Point Intersection;
-      double eps = 0.00001;
-
-      bool segments_intersect = segmentsIntersect(
-          &C1->line_segments[i], &C2->line_segments[j], &Intersection, eps);
+      LineT<T> segment_C2 = C2->getSegment(j);
+      PointT<T> Intersection;
+      bool segments_intersect =
+          segmentsIntersect(&segment_C1, &segment_C2, &Intersection);
       if (segments_intersect) {
         // If the segments intersect, they create a Vertex for the intersection
         // polygon
@@ -206,17 +298,24 @@ std::vector<Point> getIntersectionPolygonVertices(ConvexHull *C1,
       }
     }
   }
+  CH_STATS_COUNT(kIntersectionVertices, intersectionVertices.size());
   return intersectionVertices;
 }
 
-void sortPointsCCW(std::vector<Point> *point_vector) {
-  Point center =
-      point_vector->at(0);  //  We make a pivot to check angles against
+template <typename T>
+void sortPointsCCW(std::vector<PointT<T>> *point_vector) {
+  //  We make a pivot to check angles against: the centroid of the points
+  T cx = 0, cy = 0;
+  for (const PointT<T> &p : *point_vector) {
+    cx += p.x;
+    cy += p.y;
+  }
+  cx /= point_vector->size();
+  cy /= point_vector->size();
 
   // sort all points by polar angle
-  for (Point &p : *point_vector) {
-    double angle = center.get_angle(p);
-    p.set_angle(angle);
+  for (PointT<T> &p : *point_vector) {
+    p.set_angle(std::atan2(p.y - cy, p.x - cx));
   }
 
   // sort the points using overloaded < operator from the Point struct
@@ -224,9 +323,10 @@ void sortPointsCCW(std::vector<Point> *point_vector) {
   std::sort(point_vector->begin(), point_vector->end());
 }
 
-bool getIntersectingPolygon(ConvexHull *C1, ConvexHull *C2,
-                            ConvexHull *Intersection) {
-  std::vector<Point> intersectionVertices =
+template <typename T>
+bool getIntersectingPolygon(ConvexHullT<T> *C1, ConvexHullT<T> *C2,
+                            ConvexHullT<T> *Intersection) {
+  std::vector<PointT<T>> intersectionVertices =
       getIntersectionPolygonVertices(C1, C2);
 
   if (intersectionVertices.size() < 3)
@@ -240,33 +340,47 @@ bool getIntersectingPolygon(ConvexHull *C1, ConvexHull *C2,
   return true;
 }
 
-std::vector<ConvexHull> eliminateOverlappingCHulls(
-    std::vector<ConvexHull> *input, double overlapping_percent) {
-  // Use a vector to keep track of which C Hulls should remain
-  std::vector<bool> remaining_convex_hulls(input->size(), true);
-  std::vector<ConvexHull> output;
-  output.reserve(input->size());
-  for (int i = 0; i < input->size() - 1; ++i) {
-    for (int j = i + 1; j < input->size(); ++j) {
-      ConvexHull intersection;
-      bool c_hulls_intersect =
-          getIntersectingPolygon(&input->at(i), &input->at(j), &intersection);
-      // For each C. Hull check for overlapping with the remaining C. Hulls
-      if (c_hulls_intersect) {
-        // If the overlapping area is larger that the desired percent, tag the
-        // index to be eliminated. this check is done for both C. Hulls
-        if (intersection.getArea() >
-            overlapping_percent * input->at(i).getArea())
-          remaining_convex_hulls[i] = false;
-        if (intersection.getArea() >
-            overlapping_percent * input->at(j).getArea())
-          remaining_convex_hulls[j] = false;
-      }
-    }
-  }
-  // Store the convex hulls that should remain, ignoring the rest.
-  for (int i = 0; i < remaining_convex_hulls.size(); ++i) {
-    if (remaining_convex_hulls[i]) output.push_back(input->at(i));
-  }
-  return output;
+template <typename T>
+T intersectionArea(ConvexHullT<T> *C1, ConvexHullT<T> *C2) {
+  int n1 = C1->getNvertices(), n2 = C2->getNvertices();
+  const PointT<T> *a = C1->apex.data();
+  const PointT<T> *b = C2->apex.data();
+  if (n1 == 3 && n2 == 3) return clipIntersectionArea<T, 3, 3>(a, b);
+  if (n1 == 3 && n2 == 4) return clipIntersectionArea<T, 3, 4>(a, b);
+  if (n1 == 4 && n2 == 3) return clipIntersectionArea<T, 4, 3>(a, b);
+  if (n1 == 4 && n2 == 4) return clipIntersectionArea<T, 4, 4>(a, b);
+
+  ConvexHullT<T> intersection;
+  if (!getIntersectingPolygon(C1, C2, &intersection)) return 0;
+  return intersection.getArea();
 }
+
+template <typename T>
+std::vector<ConvexHullT<T>> eliminateOverlappingCHulls(
+    std::vector<ConvexHullT<T>> *input, double overlapping_percent) {
+  return eliminateOverlappingCHullsWith(input, overlapping_percent,
+                                        AutoBackend());
+}
+
+// Explicit instantiation of the whole geometry engine for a scalar type
+#define INSTANTIATE_CONVEX_HULL(T)                                          \
+  template class ConvexHullT<T>;                                            \
+  template std::vector<ConvexHullT<T>> convexHullsFromJson<T>(const json &); \
+  template json convexHullsToJson<T>(const std::vector<ConvexHullT<T>> &);   \
+  template bool pointInPolygon<T>(std::vector<PointT<T>> const &,           \
+                                  const PointT<T>);                         \
+  template bool pointInPolygon<T>(const PointT<T> *, int, const PointT<T>); \
+  template bool segmentsIntersect<T>(LineT<T> *, LineT<T> *, PointT<T> *);  \
+  template bool segmentsIntersect<T>(LineT<T> *, LineT<T> *, PointT<T> *,   \
+                                     const double &);                       \
+  template void sortPointsCCW<T>(std::vector<PointT<T>> *);                 \
+  template std::vector<PointT<T>> getIntersectionPolygonVertices<T>(        \
+      ConvexHullT<T> *, ConvexHullT<T> *);                                  \
+  template bool getIntersectingPolygon<T>(ConvexHullT<T> *, ConvexHullT<T> *, \
+                                          ConvexHullT<T> *);                \
+  template T intersectionArea<T>(ConvexHullT<T> *, ConvexHullT<T> *);       \
+  template std::vector<ConvexHullT<T>> eliminateOverlappingCHulls<T>(       \
+      std::vector<ConvexHullT<T>> *, double);
+
+INSTANTIATE_CONVEX_HULL(float)
+INSTANTIATE_CONVEX_HULL(double)
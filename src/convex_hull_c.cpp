@@ -0,0 +1,192 @@
+#include <convex_hull_c.h>
+
+#include <algorithm>
+#include <cmath>
+#include <convex_hull_view.hpp>
+#include <hull_kernels.hpp>
+#include <intersection_backends.hpp>
+#include <new>
+#include <spatial_index.hpp>
+#include <trace.hpp>
+#include <vector>
+
+// The set only points to the caller's arrays; the per hull boxes and areas
+// are the only data it owns
+struct ch_hullset {
+  const double *xy;
+  const int32_t *offsets;
+  const int32_t *ids;
+  int32_t n_hulls;
+  std::vector<BoundingBox> boxes;
+  std::vector<double> areas;
+};
+
+namespace {
+const double *hullCoordinates(const ch_hullset *set, int32_t index) {
+  return set->xy + 2 * static_cast<ptrdiff_t>(set->offsets[index]);
+}
+
+int32_t hullNVertices(const ch_hullset *set, int32_t index) {
+  return set->offsets[index + 1] - set->offsets[index];
+}
+
+bool validIndex(const ch_hullset *set, int32_t index) {
+  return set != nullptr && index >= 0 && index < set->n_hulls;
+}
+
+double polygonArea(const double *xy, int n) {
+  double sum = xy[2 * (n - 1)] * xy[1] - xy[0] * xy[2 * (n - 1) + 1];
+  for (int i = 0; i < n - 1; ++i)
+    sum += xy[2 * i] * xy[2 * i + 3] - xy[2 * i + 2] * xy[2 * i + 1];
+  return std::abs(sum) / 2;
+}
+
+BoundingBox polygonBox(const double *xy, int n) {
+  BoundingBox box(xy[0], xy[1], xy[0], xy[1]);
+  for (int i = 1; i < n; ++i) {
+    box.min_x = std::min(box.min_x, xy[2 * i]);
+    box.max_x = std::max(box.max_x, xy[2 * i]);
+    box.min_y = std::min(box.min_y, xy[2 * i + 1]);
+    box.max_y = std::max(box.max_y, xy[2 * i + 1]);
+  }
+  return box;
+}
+
+double hullIntersectionArea(const ch_hullset *set, int32_t i, int32_t j) {
+  return clipIntersectionArea(hullCoordinates(set, i), hullNVertices(set, i),
+                              hullCoordinates(set, j), hullNVertices(set, j));
+}
+}  // namespace
+
+extern "C" {
+
+int32_t ch_api_version(void) { return CH_API_VERSION; }
+
+const char *ch_status_string(ch_status status) {
+  switch (status) {
+    case CH_OK:
+      return "ok";
+    case CH_ERROR_INVALID_ARGUMENT:
+      return "invalid argument";
+    case CH_ERROR_OUT_OF_MEMORY:
+      return "out of memory";
+  }
+  return "unknown status";
+}
+
+ch_status ch_hullset_create_from_buffers(const double *xy,
+                                         const int32_t *offsets,
+                                         const int32_t *ids, int32_t n_hulls,
+                                         ch_hullset **out_set) {
+  if (out_set == nullptr || offsets == nullptr || n_hulls < 0)
+    return CH_ERROR_INVALID_ARGUMENT;
+  *out_set = nullptr;
+  if (offsets[0] != 0 || (n_hulls > 0 && xy == nullptr))
+    return CH_ERROR_INVALID_ARGUMENT;
+  for (int32_t h = 0; h < n_hulls; ++h) {
+    if (offsets[h + 1] - offsets[h] < 3) return CH_ERROR_INVALID_ARGUMENT;
+  }
+
+  ch_hullset *set = new (std::nothrow) ch_hullset;
+  if (set == nullptr) return CH_ERROR_OUT_OF_MEMORY;
+  set->xy = xy;
+  set->offsets = offsets;
+  set->ids = ids;
+  set->n_hulls = n_hulls;
+  try {
+    set->boxes.reserve(n_hulls);
+    set->areas.reserve(n_hulls);
+  } catch (const std::bad_alloc &) {
+    delete set;
+    return CH_ERROR_OUT_OF_MEMORY;
+  }
+  for (int32_t h = 0; h < n_hulls; ++h) {
+    set->boxes.push_back(polygonBox(hullCoordinates(set, h),
+                                    hullNVertices(set, h)));
+    set->areas.push_back(polygonArea(hullCoordinates(set, h),
+                                     hullNVertices(set, h)));
+  }
+  *out_set = set;
+  return CH_OK;
+}
+
+void ch_hullset_destroy(ch_hullset *set) { delete set; }
+
+int32_t ch_hullset_size(const ch_hullset *set) {
+  return set == nullptr ? 0 : set->n_hulls;
+}
+
+ch_status ch_hull_id(const ch_hullset *set, int32_t index, int32_t *out_id) {
+  if (!validIndex(set, index) || out_id == nullptr)
+    return CH_ERROR_INVALID_ARGUMENT;
+  *out_id = set->ids == nullptr ? index : set->ids[index];
+  return CH_OK;
+}
+
+ch_status ch_hull_area(const ch_hullset *set, int32_t index,
+                       double *out_area) {
+  if (!validIndex(set, index) || out_area == nullptr)
+    return CH_ERROR_INVALID_ARGUMENT;
+  *out_area = set->areas[index];
+  return CH_OK;
+}
+
+ch_status ch_intersection_area(const ch_hullset *set, int32_t i, int32_t j,
+                               double *out_area) {
+  if (!validIndex(set, i) || !validIndex(set, j) || out_area == nullptr)
+    return CH_ERROR_INVALID_ARGUMENT;
+  try {
+    *out_area = set->boxes[i].overlaps(set->boxes[j])
+                    ? hullIntersectionArea(set, i, j)
+                    : 0.;
+  } catch (const std::bad_alloc &) {
+    return CH_ERROR_OUT_OF_MEMORY;
+  }
+  return CH_OK;
+}
+
+ch_status ch_polygon_intersection_area(const double *xy_a, int32_t n_a,
+                                       const double *xy_b, int32_t n_b,
+                                       double *out_area) {
+  if (xy_a == nullptr || xy_b == nullptr || n_a < 3 || n_b < 3 ||
+      out_area == nullptr)
+    return CH_ERROR_INVALID_ARGUMENT;
+  try {
+    *out_area = clipIntersectionArea(xy_a, n_a, xy_b, n_b);
+  } catch (const std::bad_alloc &) {
+    return CH_ERROR_OUT_OF_MEMORY;
+  }
+  return CH_OK;
+}
+
+ch_status ch_eliminate(const ch_hullset *set, double overlapping_percent,
+                       int32_t *out_kept, int32_t *out_n_kept) {
+  if (set == nullptr || out_n_kept == nullptr ||
+      (set->n_hulls > 0 && out_kept == nullptr))
+    return CH_ERROR_INVALID_ARGUMENT;
+  CH_TRACE_SPAN("ch_eliminate", set->n_hulls);
+  int32_t n_hulls = set->n_hulls;
+  try {
+    // The library works on Points, so the interleaved coordinates are
+    // copied once; the views over them are the same elimination as
+    // eliminateOverlappingCHulls
+    std::vector<Point> vertices;
+    vertices.reserve(set->offsets[n_hulls]);
+    for (int32_t v = 0; v < set->offsets[n_hulls]; ++v)
+      vertices.push_back(Point(set->xy[2 * v], set->xy[2 * v + 1]));
+    // Without the caller's IDs, the ID of every view is its index
+    std::vector<ConvexHullView> views =
+        makeConvexHullViews(vertices.data(), set->offsets, nullptr, n_hulls);
+    std::vector<ConvexHullView> remaining =
+        eliminateOverlappingCHullsWith(&views, overlapping_percent,
+                                       AutoBackend());
+    int32_t n_kept = 0;
+    for (const ConvexHullView &view : remaining) out_kept[n_kept++] = view.id;
+    *out_n_kept = n_kept;
+  } catch (const std::bad_alloc &) {
+    return CH_ERROR_OUT_OF_MEMORY;
+  }
+  return CH_OK;
+}
+
+}  // extern "C"
@@ -0,0 +1,148 @@
+#include <convex_hull_view.hpp>
+#include <hull_kernels.hpp>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
+#include <predicates.hpp>
+
+namespace {
+// Same sum (and rounding) as ConvexHullT::computeArea
+template <typename T>
+T polygonArea(const PointT<T> *v, int n) {
+  if (n == 3) return PolygonKernel<T, 3>::area(v);
+  if (n == 4) return PolygonKernel<T, 4>::area(v);
+  T area = v[n - 1].x * v[0].y - v[0].x * v[n - 1].y;
+  for (int i = 0; i < n - 1; ++i)
+    area += v[i].x * v[i + 1].y - v[i + 1].x * v[i].y;
+  area = 0.5 * area;
+  if (area < 0) area *= -1.;
+  return area;
+}
+
+template <typename T>
+BoundingBox polygonBounds(const PointT<T> *v, int n) {
+  BoundingBox box(v[0].x, v[0].y, v[0].x, v[0].y);
+  for (int i = 1; i < n; ++i) {
+    box.min_x = std::min<double>(box.min_x, v[i].x);
+    box.min_y = std::min<double>(box.min_y, v[i].y);
+    box.max_x = std::max<double>(box.max_x, v[i].x);
+    box.max_y = std::max<double>(box.max_y, v[i].y);
+  }
+  return box;
+}
+}  // namespace
+
+template <typename T>
+ConvexHullViewT<T>::ConvexHullViewT(const PointT<T> *apex_, int n_apexes_,
+                                    int id_)
+    : apex(apex_), n_apexes(n_apexes_), id(id_) {
+  assert(n_apexes >= 3);
+  area = polygonArea(apex, n_apexes);
+  bounds = polygonBounds(apex, n_apexes);
+}
+
+template <typename T>
+ConvexHullViewT<T>::ConvexHullViewT(const ConvexHullT<T> &hull)
+    : ConvexHullViewT(hull.apex.data(), hull.apex.size(), hull.id) {}
+
+template <typename T>
+bool ConvexHullViewT<T>::isPointInside(const PointT<T> &P) const {
+  if (n_apexes == 3) return PolygonKernel<T, 3>::contains(apex, P);
+  if (n_apexes == 4) return PolygonKernel<T, 4>::contains(apex, P);
+  return pointInPolygon(apex, n_apexes, P);
+}
+
+template <typename T>
+std::vector<ConvexHullViewT<T>> makeConvexHullViews(const PointT<T> *vertices,
+                                                    const int *offsets,
+                                                    const int *ids,
+                                                    int n_hulls) {
+  std::vector<ConvexHullViewT<T>> views;
+  views.reserve(n_hulls);
+  for (int h = 0; h < n_hulls; ++h) {
+    views.emplace_back(vertices + offsets[h], offsets[h + 1] - offsets[h],
+                       ids == nullptr ? h : ids[h]);
+  }
+  return views;
+}
+
+template <typename T>
+std::vector<ConvexHullViewT<T>> makeConvexHullViews(
+    const std::vector<ConvexHullT<T>> &hulls) {
+  std::vector<ConvexHullViewT<T>> views;
+  views.reserve(hulls.size());
+  for (const ConvexHullT<T> &hull : hulls) views.emplace_back(hull);
+  return views;
+}
+
+template <typename T>
+std::vector<PointT<T>> getIntersectionPolygonVertices(
+    const ConvexHullViewT<T> *C1, const ConvexHullViewT<T> *C2) {
+  std::vector<PointT<T>> intersectionVertices;
+  int n1 = C1->getNvertices(), n2 = C2->getNvertices();
+  intersectionVertices.reserve(n1 + n2);
+  for (int i = 0; i < n1; ++i) {
+    if (C2->isPointInside(C1->apex[i]))
+      intersectionVertices.push_back(C1->apex[i]);
+  }
+  for (int i = 0; i < n2; ++i) {
+    if (C1->isPointInside(C2->apex[i]))
+      intersectionVertices.push_back(C2->apex[i]);
+  }
+  // Edges i -> i + 1 of both hulls, in the order of ConvexHull::getSegment
+  for (int i = 0; i < n1; ++i) {
+    const PointT<T> &a1 = C1->apex[i], &a2 = C1->apex[i + 1 == n1 ? 0 : i + 1];
+    for (int j = 0; j < n2; ++j) {
+      const PointT<T> &b1 = C2->apex[j];
+      const PointT<T> &b2 = C2->apex[j + 1 == n2 ? 0 : j + 1];
+      double t;
+      if (!predicates::segmentsCross(a1, a2, b1, b2, &t)) continue;
+      // Same point as segmentsIntersect, without computing its angle
+      PointT<T> intersection;
+      intersection.x = a1.x + (a2.x - a1.x) * static_cast<T>(t);
+      intersection.y = a1.y + (a2.y - a1.y) * static_cast<T>(t);
+      intersectionVertices.push_back(intersection);
+    }
+  }
+  CH_STATS_COUNT(kIntersectionVertices, intersectionVertices.size());
+  return intersectionVertices;
+}
+
+template <typename T>
+T intersectionArea(const ConvexHullViewT<T> *C1,
+                   const ConvexHullViewT<T> *C2) {
+  if (!C1->bounds.overlaps(C2->bounds)) return 0;
+  int n1 = C1->getNvertices(), n2 = C2->getNvertices();
+  const PointT<T> *a = C1->apex, *b = C2->apex;
+  if (n1 == 3 && n2 == 3) return clipIntersectionArea<T, 3, 3>(a, b);
+  if (n1 == 3 && n2 == 4) return clipIntersectionArea<T, 3, 4>(a, b);
+  if (n1 == 4 && n2 == 3) return clipIntersectionArea<T, 4, 3>(a, b);
+  if (n1 == 4 && n2 == 4) return clipIntersectionArea<T, 4, 4>(a, b);
+
+  std::vector<PointT<T>> vertices = getIntersectionPolygonVertices(C1, C2);
+  if (vertices.size() < 3) return 0;
+  sortPointsCCW(&vertices);
+  return polygonArea(vertices.data(), vertices.size());
+}
+
+template <typename T>
+std::vector<ConvexHullViewT<T>> eliminateOverlappingCHulls(
+    std::vector<ConvexHullViewT<T>> *input, double overlapping_percent) {
+  return eliminateOverlappingCHullsWith(input, overlapping_percent,
+                                        AutoBackend());
+}
+
+#define INSTANTIATE_CONVEX_HULL_VIEW(T)                                     \
+  template struct ConvexHullViewT<T>;                                       \
+  template std::vector<ConvexHullViewT<T>> makeConvexHullViews<T>(          \
+      const PointT<T> *, const int *, const int *, int);                    \
+  template std::vector<ConvexHullViewT<T>> makeConvexHullViews<T>(          \
+      const std::vector<ConvexHullT<T>> &);                                 \
+  template std::vector<PointT<T>> getIntersectionPolygonVertices<T>(        \
+      const ConvexHullViewT<T> *, const ConvexHullViewT<T> *);              \
+  template T intersectionArea<T>(const ConvexHullViewT<T> *,                \
+                                 const ConvexHullViewT<T> *);               \
+  template std::vector<ConvexHullViewT<T>> eliminateOverlappingCHulls<T>(   \
+      std::vector<ConvexHullViewT<T>> *, double);
+
+INSTANTIATE_CONVEX_HULL_VIEW(float)
+INSTANTIATE_CONVEX_HULL_VIEW(double)
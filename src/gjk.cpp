@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <cmath>
+#include <gjk.hpp>
+#include <instrumentation.hpp>
+#include <small_vector.hpp>
+#include <spatial_index.hpp>
+#include <trace.hpp>
+
+namespace {
+// Iteration budget on top of the vertex counts (each GJK or EPA iteration
+// adds a new vertex of A - B, so they are a safe upper bound)
+const int kMaxIterations = 64;
+// GJK stops when the distance estimate improves by less than this (relative)
+const double kRelativeTolerance = 1e-12;
+// Squared distances below this (relative to the squared coordinate scale)
+// are contact
+const double kContactTolerance = 1e-24;
+// EPA stops when the polytope grows by less than this (relative to the scale)
+const double kEpaTolerance = 1e-10;
+// Rows per parallel chunk
+const int kRowGrain = 64;
+
+struct Vec {
+  double x, y;
+};
+
+inline Vec operator-(Vec a, Vec b) { return {a.x - b.x, a.y - b.y}; }
+inline double dot(Vec a, Vec b) { return a.x * b.x + a.y * b.y; }
+inline double cross(Vec a, Vec b) { return a.x * b.y - a.y * b.x; }
+
+// Vertex of the Minkowski difference, w = a - b, with the vertices of A and
+// B it comes from (to recover the closest points)
+struct SupportPoint {
+  Vec w, a, b;
+};
+
+/**
+ * Support vertex of a convex polygon by hill climbing. The dot product of
+ * the vertices with a direction has a single maximum along the (cyclic)
+ * apex list, so walking towards the larger neighbour finds it.
+ */
+template <typename T>
+class SupportSearch {
+ public:
+  SupportSearch(const PointT<T> *v, int n) : v_(v), n_(n), hint_(-1) {}
+
+  Vec find(Vec d) {
+    if (hint_ < 0) hint_ = sampledStart(d);
+    hint_ = climb(hint_, d);
+    return {static_cast<double>(v_[hint_].x),
+            static_cast<double>(v_[hint_].y)};
+  }
+
+ private:
+  double dotAt(int i, Vec d) const { return v_[i].x * d.x + v_[i].y * d.y; }
+  int next(int i) const { return i + 1 == n_ ? 0 : i + 1; }
+  int prev(int i) const { return i == 0 ? n_ - 1 : i - 1; }
+
+  // Best of about sqrt(n) evenly spaced vertices: the maximum is less than
+  // one stride away
+  int sampledStart(Vec d) const {
+    int stride = std::max(1, static_cast<int>(std::sqrt(n_)));
+    int best = 0;
+    double best_dot = dotAt(0, d);
+    for (int i = stride; i < n_; i += stride) {
+      double value = dotAt(i, d);
+      if (value > best_dot) {
+        best = i;
+        best_dot = value;
+      }
+    }
+    return best;
+  }
+
+  int climb(int i, Vec d) const {
+    double best = dotAt(i, d);
+    double next_dot = dotAt(next(i), d), prev_dot = dotAt(prev(i), d);
+    bool forward;
+    if (next_dot > best) {
+      forward = true;
+    } else if (prev_dot > best) {
+      forward = false;
+    } else if (next_dot < best || prev_dot < best) {
+      return i;
+    } else {
+      return linearSearch(d);  // flat neighbourhood (collinear vertices)
+    }
+    for (int k = 0; k < n_; ++k) {
+      int j = forward ? next(i) : prev(i);
+      double value = dotAt(j, d);
+      if (value <= best) break;
+      i = j;
+      best = value;
+    }
+    return i;
+  }
+
+  int linearSearch(Vec d) const {
+    int best = 0;
+    for (int i = 1; i < n_; ++i) {
+      if (dotAt(i, d) > dotAt(best, d)) best = i;
+    }
+    return best;
+  }
+
+  const PointT<T> *v_;
+  int n_;
+  int hint_;
+};
+
+// Support of A - B in direction d: support of A in d minus support of B in -d
+template <typename T>
+struct MinkowskiDifference {
+  SupportSearch<T> A, B;
+  double max_norm2;  // squared scale of the points seen, for tolerances
+
+  MinkowskiDifference(const PointT<T> *a, int n, const PointT<T> *b, int m)
+      : A(a, n), B(b, m), max_norm2(0) {}
+
+  SupportPoint support(Vec d) {
+    SupportPoint p;
+    p.a = A.find(d);
+    p.b = B.find({-d.x, -d.y});
+    p.w = p.a - p.b;
+    max_norm2 = std::max(max_norm2, dot(p.w, p.w));
+    return p;
+  }
+};
+
+// GJK simplex (1 to 3 points) with the barycentric weights of its closest
+// point to the origin
+struct Simplex {
+  SupportPoint p[3];
+  double lambda[3];
+  int size;
+  Vec v;  // closest point to the origin
+
+  // Keeps only the segment p[i] p[j], or the nearest of its endpoints
+  void reduceToSegment(int i, int j) {
+    SupportPoint a = p[i], b = p[j];
+    Vec ab = b.w - a.w;
+    double length2 = dot(ab, ab);
+    double t = length2 > 0 ? -dot(a.w, ab) / length2 : 0;
+    if (t <= 0) {
+      p[0] = a;
+      lambda[0] = 1;
+      size = 1;
+      v = a.w;
+    } else if (t >= 1) {
+      p[0] = b;
+      lambda[0] = 1;
+      size = 1;
+      v = b.w;
+    } else {
+      p[0] = a;
+      p[1] = b;
+      lambda[0] = 1 - t;
+      lambda[1] = t;
+      size = 2;
+      v = {a.w.x + t * ab.x, a.w.y + t * ab.y};
+    }
+  }
+
+  double norm2() const { return dot(v, v); }
+
+  // Replaces the simplex by the smallest sub simplex holding its closest
+  // point to the origin. Returns true if the origin is inside the triangle.
+  bool reduce() {
+    if (size == 1) {
+      lambda[0] = 1;
+      v = p[0].w;
+      return false;
+    }
+    if (size == 2) {
+      reduceToSegment(0, 1);
+      return false;
+    }
+    Vec a = p[0].w, b = p[1].w, c = p[2].w;
+    double area2 = cross(b - a, c - a);
+    if (area2 != 0) {
+      double l0 = cross(b, c) / area2, l1 = cross(c, a) / area2;
+      double l2 = cross(a, b) / area2;
+      if (l0 >= 0 && l1 >= 0 && l2 >= 0) {
+        lambda[0] = l0;
+        lambda[1] = l1;
+        lambda[2] = l2;
+        v = {0, 0};
+        return true;
+      }
+    }
+    // Origin outside (or flat triangle): nearest edge
+    Simplex best = *this;
+    best.reduceToSegment(0, 1);
+    const int edges[2][2] = {{1, 2}, {2, 0}};
+    for (const auto &edge : edges) {
+      Simplex candidate = *this;
+      candidate.reduceToSegment(edge[0], edge[1]);
+      if (candidate.norm2() < best.norm2()) best = candidate;
+    }
+    *this = best;
+    return false;
+  }
+
+  Vec pointA() const {
+    Vec res = {0, 0};
+    for (int i = 0; i < size; ++i) {
+      res.x += lambda[i] * p[i].a.x;
+      res.y += lambda[i] * p[i].a.y;
+    }
+    return res;
+  }
+};
+
+// Twice the signed area of the polytope
+double signedArea2(const SmallVector<SupportPoint, 32> &poly) {
+  double sum = 0;
+  for (int i = 0; i < poly.size(); ++i)
+    sum += cross(poly[i].w, poly[i + 1 == poly.size() ? 0 : i + 1].w);
+  return sum;
+}
+
+/**
+ * EPA: grows a polygon inside A - B that contains the origin towards its
+ * edge closest to the origin, until the boundary of A - B is reached.
+ * @return false if A - B is flat around the origin (touching hulls)
+ */
+template <typename T>
+bool expandPolytope(const Simplex &simplex, MinkowskiDifference<T> *mink,
+                    int max_iterations, double *depth, Vec *normal,
+                    int *n_iterations) {
+  SmallVector<SupportPoint, 32> poly;
+  for (int i = 0; i < simplex.size; ++i) poly.push_back(simplex.p[i]);
+  if (poly.size() == 1) return false;  // the origin is a vertex of A - B
+  if (poly.size() == 2) {
+    // The origin is on a chord of A - B: add the vertex farthest from it
+    Vec e = poly[1].w - poly[0].w;
+    Vec n = {-e.y, e.x};
+    SupportPoint left = mink->support(n);
+    SupportPoint right = mink->support({-n.x, -n.y});
+    double left_dot = dot(n, left.w - poly[0].w);
+    double right_dot = -dot(n, right.w - poly[0].w);
+    double scale = std::sqrt(mink->max_norm2);
+    if (std::max(left_dot, right_dot) <= kEpaTolerance * scale * scale)
+      return false;
+    poly.push_back(left_dot >= right_dot ? left : right);
+  }
+  if (signedArea2(poly) < 0) std::reverse(poly.begin(), poly.end());
+
+  double scale = std::sqrt(mink->max_norm2);
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    ++*n_iterations;
+    // Edge closest to the origin, with its outward normal
+    int closest = -1;
+    double closest_distance = 0;
+    Vec closest_normal = {0, 0};
+    for (int i = 0; i < poly.size(); ++i) {
+      Vec e = poly[i + 1 == poly.size() ? 0 : i + 1].w - poly[i].w;
+      double length = std::sqrt(dot(e, e));
+      if (length == 0) continue;
+      Vec n = {e.y / length, -e.x / length};
+      double distance = dot(n, poly[i].w);
+      if (closest < 0 || distance < closest_distance) {
+        closest = i;
+        closest_distance = distance;
+        closest_normal = n;
+      }
+    }
+    if (closest < 0) return false;
+    *depth = std::max(0., closest_distance);
+    *normal = closest_normal;
+    SupportPoint w = mink->support(closest_normal);
+    if (dot(closest_normal, w.w) - closest_distance <=
+        kEpaTolerance * scale)
+      return true;
+    // Insert w between the vertices of the closest edge
+    poly.push_back(w);
+    for (int i = poly.size() - 1; i > closest + 1; --i) poly[i] = poly[i - 1];
+    poly[closest + 1] = w;
+  }
+  return true;
+}
+}  // namespace
+
+template <typename T>
+HullProximityT<T> polygonProximity(const PointT<T> *A, int n,
+                                   const PointT<T> *B, int m,
+                                   bool compute_penetration) {
+  HullProximityT<T> result;
+  MinkowskiDifference<T> mink(A, n, B, m);
+  int max_iterations = kMaxIterations + n + m;
+
+  Simplex simplex;
+  simplex.size = 0;
+  simplex.v = {static_cast<double>(A[0].x - B[0].x),
+               static_cast<double>(A[0].y - B[0].y)};
+  if (simplex.v.x == 0 && simplex.v.y == 0) simplex.v.x = 1;
+  bool overlapping = false;
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    ++result.n_iterations;
+    SupportPoint w = mink.support({-simplex.v.x, -simplex.v.y});
+    double v2 = simplex.norm2();
+    // No vertex of A - B is closer to the origin along v: converged
+    if (simplex.size > 0 && v2 - dot(simplex.v, w.w) <= kRelativeTolerance * v2)
+      break;
+    simplex.p[simplex.size++] = w;
+    if (simplex.reduce() ||
+        simplex.norm2() <= kContactTolerance * mink.max_norm2) {
+      overlapping = true;
+      break;
+    }
+  }
+
+  Vec point_a = simplex.pointA();
+  result.point_a.x = point_a.x;
+  result.point_a.y = point_a.y;
+  result.overlapping = overlapping;
+  if (!overlapping) {
+    // v = point_a - point_b
+    double distance = std::sqrt(simplex.norm2());
+    result.distance = distance;
+    result.point_b.x = point_a.x - simplex.v.x;
+    result.point_b.y = point_a.y - simplex.v.y;
+    result.normal.x = -simplex.v.x / distance;
+    result.normal.y = -simplex.v.y / distance;
+    return result;
+  }
+
+  result.point_b = result.point_a;
+  if (!compute_penetration) return result;
+  double depth = 0;
+  Vec normal = {0, 0};
+  if (expandPolytope(simplex, &mink, max_iterations, &depth, &normal,
+                     &result.n_iterations)) {
+    result.penetration = depth;
+    result.normal.x = normal.x;
+    result.normal.y = normal.y;
+  }
+  return result;
+}
+
+template <typename T>
+HullProximityT<T> hullProximity(const ConvexHullT<T> &A,
+                                const ConvexHullT<T> &B,
+                                bool compute_penetration) {
+  return polygonProximity(A.apex.data(), A.apex.size(), B.apex.data(),
+                          B.apex.size(), compute_penetration);
+}
+
+template <typename T>
+HullProximityT<T> hullProximity(const ConvexHullViewT<T> &A,
+                                const ConvexHullViewT<T> &B,
+                                bool compute_penetration) {
+  return polygonProximity(A.apex, A.n_apexes, B.apex, B.n_apexes,
+                          compute_penetration);
+}
+
+template <typename T>
+T hullDistance(const ConvexHullT<T> &A, const ConvexHullT<T> &B) {
+  return hullProximity(A, B, false).distance;
+}
+
+std::vector<ProximityEntry> findProximityPairs(
+    const std::vector<ConvexHull> &hulls, double max_distance,
+    ThreadPool *pool, double cell_size) {
+  CH_TRACE_SPAN("findProximityPairs", hulls.size());
+  int n_hulls = hulls.size();
+  std::vector<ProximityEntry> pairs;
+  if (n_hulls == 0) return pairs;
+
+  // Candidates j > i of every hull, in CSR layout: the boxes of the hulls
+  // closer than max_distance overlap the grown query box
+  SpatialHashGrid grid(cell_size);
+  std::vector<BoundingBox> boxes;
+  boxes.reserve(n_hulls);
+  for (const ConvexHull &c : hulls) {
+    boxes.push_back(computeBoundingBox(c.apex));
+    grid.insert(boxes.back());
+  }
+  std::vector<int> offsets(n_hulls + 1, 0), candidates, found;
+  for (int i = 0; i < n_hulls; ++i) {
+    BoundingBox query(boxes[i].min_x - max_distance,
+                      boxes[i].min_y - max_distance,
+                      boxes[i].max_x + max_distance,
+                      boxes[i].max_y + max_distance);
+    grid.query(query, &found);
+    for (int j : found) {
+      if (j > i) candidates.push_back(j);
+    }
+    offsets[i + 1] = candidates.size();
+  }
+  CH_STATS_COUNT(kPairsConsidered, candidates.size());
+
+  int n_chunks = (n_hulls + kRowGrain - 1) / kRowGrain;
+  std::vector<std::vector<ProximityEntry>> chunk_pairs(n_chunks);
+  auto compute_rows = [&](int begin, int end) {
+    std::vector<ProximityEntry> &entries = chunk_pairs[begin / kRowGrain];
+    for (int i = begin; i < end; ++i) {
+      for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+        int j = candidates[k];
+        HullProximity proximity = hullProximity(hulls[i], hulls[j]);
+        if (proximity.distance > max_distance) continue;
+        entries.push_back(
+            ProximityEntry(i, j, proximity.distance, proximity.penetration));
+      }
+    }
+  };
+  if (pool != nullptr)
+    pool->parallelFor(n_hulls, kRowGrain, compute_rows);
+  else
+    compute_rows(0, n_hulls);
+
+  for (const std::vector<ProximityEntry> &entries : chunk_pairs)
+    pairs.insert(pairs.end(), entries.begin(), entries.end());
+  return pairs;
+}
+
+#define INSTANTIATE_GJK(T)                                                  \
+  template HullProximityT<T> polygonProximity<T>(                           \
+      const PointT<T> *, int, const PointT<T> *, int, bool);                \
+  template HullProximityT<T> hullProximity<T>(const ConvexHullT<T> &,       \
+                                              const ConvexHullT<T> &, bool); \
+  template HullProximityT<T> hullProximity<T>(                              \
+      const ConvexHullViewT<T> &, const ConvexHullViewT<T> &, bool);        \
+  template T hullDistance<T>(const ConvexHullT<T> &, const ConvexHullT<T> &);
+
+INSTANTIATE_GJK(float)
+INSTANTIATE_GJK(double)
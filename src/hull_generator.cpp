@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <hull_generator.hpp>
+#include <limits>
+
+HullGenerator::HullGenerator(const HullGeneratorOptions &options)
+    : options_(options), gen_(options.seed), next_id_(0) {
+  assert(options_.min_vertices >= 3 &&
+         options_.max_vertices >= options_.min_vertices);
+  assert(options_.min_radius > 0 && options_.max_radius >= options_.min_radius);
+  assert(options_.overlap_density > 0);
+
+  // Two hulls of radius r may overlap when their centers are closer than 2r,
+  // so with count hulls in a world of side W the expected number of
+  // neighbours is count * pi * (2r)^2 / W^2
+  double mean_radius = 0.5 * (options_.min_radius + options_.max_radius);
+  world_size_ = std::sqrt(std::max(options_.count, 1) * M_PI * 4. *
+                          mean_radius * mean_radius /
+                          options_.overlap_density);
+
+  std::uniform_real_distribution<double> position(0., world_size_);
+  for (int c = 0; c < options_.n_clusters; ++c) {
+    double x = position(gen_);
+    double y = position(gen_);
+    cluster_centers_.push_back(Point(x, y));
+  }
+}
+
+Point HullGenerator::sampleCenter() {
+  if (cluster_centers_.empty()) {
+    std::uniform_real_distribution<double> position(0., world_size_);
+    double x = position(gen_);
+    double y = position(gen_);
+    return Point(x, y);
+  }
+  std::uniform_int_distribution<int> cluster(0, cluster_centers_.size() - 1);
+  std::normal_distribution<double> offset(
+      0., options_.cluster_spread * world_size_);
+  const Point &center = cluster_centers_[cluster(gen_)];
+  double x = center.x + offset(gen_);
+  double y = center.y + offset(gen_);
+  return Point(x, y);
+}
+
+ConvexHull HullGenerator::next() {
+  std::uniform_int_distribution<int> n_vertices_dist(options_.min_vertices,
+                                                     options_.max_vertices);
+  std::uniform_real_distribution<double> log_radius(
+      std::log(options_.min_radius), std::log(options_.max_radius));
+  std::uniform_real_distribution<double> unit(0., 1.);
+
+  Point center = sampleCenter();
+  int n_vertices = n_vertices_dist(gen_);
+  double radius = std::exp(log_radius(gen_));
+  double aspect = 0.4 + 0.6 * unit(gen_);
+  double yaw = M_PI * unit(gen_);
+
+  // Sorted angles on an ellipse give a convex, CCW ordered polygon. The
+  // angles are taken from jittered slots so no two vertices coincide.
+  std::vector<double> angles(n_vertices);
+  double slot = 2. * M_PI / n_vertices;
+  for (int i = 0; i < n_vertices; ++i)
+    angles[i] = slot * (i + 0.1 + 0.8 * unit(gen_));
+
+  double c = std::cos(yaw), s = std::sin(yaw);
+  std::vector<Point> apexes;
+  apexes.reserve(n_vertices);
+  for (double angle : angles) {
+    double x = radius * std::cos(angle);
+    double y = aspect * radius * std::sin(angle);
+    apexes.push_back(Point(center.x + c * x - s * y, center.y + s * x + c * y));
+  }
+  return ConvexHull(apexes, next_id_++);
+}
+
+std::vector<ConvexHull> generateConvexHulls(
+    const HullGeneratorOptions &options) {
+  HullGenerator generator(options);
+  std::vector<ConvexHull> convex_hull_v;
+  convex_hull_v.reserve(options.count);
+  for (int n = 0; n < options.count; ++n)
+    convex_hull_v.push_back(generator.next());
+  return convex_hull_v;
+}
+
+void writeGeneratedConvexHullsJson(const HullGeneratorOptions &options,
+                                   std::ostream &stream) {
+  HullGenerator generator(options);
+  stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+  stream << "{\"convex hulls\":[";
+  for (int n = 0; n < options.count; ++n) {
+    ConvexHull convex_hull = generator.next();
+    stream << (n == 0 ? "\n" : ",\n") << "{\"ID\":" << convex_hull.id
+           << ",\"apexes\":[";
+    for (int a = 0; a < convex_hull.getNvertices(); ++a) {
+      stream << (a == 0 ? "" : ",") << "{\"x\":" << convex_hull.apex[a].x
+             << ",\"y\":" << convex_hull.apex[a].y << "}";
+    }
+    stream << "]}";
+  }
+  stream << "\n]}\n";
+}
@@ -0,0 +1,278 @@
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <binary_format.hpp>
+#include <cerrno>
+#include <cstring>
+#include <hull_server.hpp>
+#include <json.hpp>
+#include <trace.hpp>
+
+using json = nlohmann::json;
+
+namespace {
+bool readFully(int fd, char *data, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::read(fd, data, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool writeFully(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    // MSG_NOSIGNAL: a closed peer is an error, not a SIGPIPE
+    ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+// The payload grows as its bytes arrive, so a header announcing a large
+// payload does not allocate it up front
+const size_t kReadChunkSize = 1 << 20;
+
+bool readMessage(int fd, uint32_t *kind, std::string *payload) {
+  uint32_t header[2];
+  if (!readFully(fd, reinterpret_cast<char *>(header), sizeof(header)))
+    return false;
+  if (header[1] > kMaxMessageSize) return false;
+  *kind = header[0];
+  payload->clear();
+  while (payload->size() < header[1]) {
+    size_t offset = payload->size();
+    size_t chunk = std::min(kReadChunkSize, header[1] - offset);
+    payload->resize(offset + chunk);
+    if (!readFully(fd, &(*payload)[offset], chunk)) return false;
+  }
+  return true;
+}
+
+bool writeMessage(int fd, uint32_t kind, const std::string &payload) {
+  uint32_t header[2] = {kind, static_cast<uint32_t>(payload.size())};
+  return writeFully(fd, reinterpret_cast<const char *>(header),
+                    sizeof(header)) &&
+         writeFully(fd, payload.data(), payload.size());
+}
+
+bool socketAddress(const std::string &path, sockaddr_un *address,
+                   std::string *error) {
+  std::memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address->sun_path)) {
+    *error = "socket path too long: " + path;
+    return false;
+  }
+  std::strcpy(address->sun_path, path.c_str());
+  return true;
+}
+
+std::string errnoMessage(const std::string &what) {
+  return what + ": " + std::strerror(errno);
+}
+}  // namespace
+
+HullServer::HullServer(const HullServerOptions &options)
+    : options_(options),
+      backend_(makeIntersectionBackend(options.backend)),
+      pool_(options.n_threads),
+      listen_fd_(-1),
+      stopping_(false),
+      n_requests_(0) {}
+
+HullServer::~HullServer() { stop(); }
+
+bool HullServer::start(std::string *error) {
+  if (!backend_) {
+    *error = "unknown intersection backend " + options_.backend;
+    return false;
+  }
+  sockaddr_un address;
+  if (!socketAddress(options_.socket_path, &address, error)) return false;
+  listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    *error = errnoMessage("socket");
+    return false;
+  }
+  ::unlink(options_.socket_path.c_str());
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listen_fd_, SOMAXCONN) != 0) {
+    *error = errnoMessage(options_.socket_path);
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+  stopping_ = false;
+  accept_thread_ = std::thread(&HullServer::acceptLoop, this);
+  return true;
+}
+
+void HullServer::stop() {
+  if (listen_fd_ < 0) return;
+  stopping_ = true;
+  // Wakes up the blocked accept and reads
+  ::shutdown(listen_fd_, SHUT_RDWR);
+  accept_thread_.join();
+  ::close(listen_fd_);
+  listen_fd_ = -1;
+  ::unlink(options_.socket_path.c_str());
+
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : connection_fds_) ::shutdown(fd, SHUT_RDWR);
+    threads.swap(connection_threads_);
+    finished_threads_.clear();
+  }
+  for (std::thread &thread : threads) thread.join();
+}
+
+void HullServer::acceptLoop() {
+  while (!stopping_) {
+    int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      return;  // the socket was shut down
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      ::close(fd);
+      return;
+    }
+    reapConnections();
+    if (connection_threads_.size() >= options_.max_connections) {
+      writeMessage(fd, kMessageError, "too many connections");
+      ::close(fd);
+      continue;
+    }
+    connection_fds_.push_back(fd);
+    connection_threads_.emplace_back(&HullServer::serveConnection, this, fd);
+  }
+}
+
+void HullServer::serveConnection(int fd) {
+  // Kept across the requests of the connection
+  std::string request, response;
+  std::vector<ConvexHull> hulls;
+
+  uint32_t kind;
+  while (!stopping_ && readMessage(fd, &kind, &request)) {
+    uint32_t response_kind = kind;
+    // The elimination runs on the pool, this thread waits for it
+    std::future<void> done = pool_.submit([&] {
+      CH_TRACE_SPAN("server request", request.size());
+      try {
+        if (kind == kMessageJson) {
+          hulls = convexHullsFromJson<double>(json::parse(request));
+        } else if (kind == kMessageBinary) {
+          if (!decodeHulls(request.data(), request.size(), &hulls)) {
+            response_kind = kMessageError;
+            response = "malformed binary hulls";
+            return;
+          }
+        } else {
+          response_kind = kMessageError;
+          response = "unknown message kind " + std::to_string(kind);
+          return;
+        }
+        std::vector<ConvexHull> remaining = eliminateOverlappingCHullsWith(
+            &hulls, options_.overlapping_percent, *backend_);
+        if (kind == kMessageJson)
+          response = convexHullsToJson(remaining).dump();
+        else
+          encodeHulls(remaining, &response);
+      } catch (const std::exception &e) {
+        response_kind = kMessageError;
+        response = e.what();
+      }
+    });
+    done.get();
+    ++n_requests_;
+    if (!writeMessage(fd, response_kind, response)) break;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < connection_fds_.size(); ++i) {
+    if (connection_fds_[i] != fd) continue;
+    connection_fds_.erase(connection_fds_.begin() + i);
+    break;
+  }
+  ::close(fd);
+  finished_threads_.push_back(std::this_thread::get_id());
+}
+
+void HullServer::reapConnections() {
+  // The finished threads only have to return, so joining them is immediate
+  for (std::thread::id id : finished_threads_) {
+    for (int i = 0; i < connection_threads_.size(); ++i) {
+      if (connection_threads_[i].get_id() != id) continue;
+      connection_threads_[i].join();
+      connection_threads_.erase(connection_threads_.begin() + i);
+      break;
+    }
+  }
+  finished_threads_.clear();
+}
+
+bool HullClient::connect(const std::string &socket_path, std::string *error) {
+  close();
+  sockaddr_un address;
+  if (!socketAddress(socket_path, &address, error)) return false;
+  fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ < 0) {
+    *error = errnoMessage("socket");
+    return false;
+  }
+  if (::connect(fd_, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) != 0) {
+    *error = errnoMessage(socket_path);
+    close();
+    return false;
+  }
+  return true;
+}
+
+void HullClient::close() {
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = -1;
+}
+
+bool HullClient::request(MessageKind kind, const std::string &payload,
+                         MessageKind *response_kind, std::string *response) {
+  if (fd_ < 0 || !writeMessage(fd_, kind, payload)) return false;
+  uint32_t received_kind;
+  if (!readMessage(fd_, &received_kind, response)) return false;
+  *response_kind = static_cast<MessageKind>(received_kind);
+  return true;
+}
+
+bool HullClient::eliminate(const std::vector<ConvexHull> &hulls,
+                           std::vector<ConvexHull> *remaining,
+                           std::string *error) {
+  encodeHulls(hulls, &request_buffer_);
+  MessageKind response_kind;
+  if (!request(kMessageBinary, request_buffer_, &response_kind,
+               &response_buffer_)) {
+    *error = "connection to the server failed";
+    return false;
+  }
+  if (response_kind == kMessageError) {
+    *error = response_buffer_;
+    return false;
+  }
+  if (!decodeHulls(response_buffer_.data(), response_buffer_.size(),
+                   remaining)) {
+    *error = "malformed response";
+    return false;
+  }
+  return true;
+}
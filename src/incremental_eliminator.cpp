@@ -0,0 +1,55 @@
+#include <incremental_eliminator.hpp>
+
+IncrementalEliminator::IncrementalEliminator(double overlapping_percent,
+                                             double cell_size)
+    : overlapping_percent_(overlapping_percent),
+      n_survivors_(0),
+      grid_(cell_size) {}
+
+void IncrementalEliminator::eliminate(int i) {
+  if (!remaining_convex_hulls_[i]) return;
+  remaining_convex_hulls_[i] = false;
+  --n_survivors_;
+}
+
+void IncrementalEliminator::insert(const ConvexHull &hull) {
+  int j = hulls_.size();
+  hulls_.push_back(hull);
+  remaining_convex_hulls_.push_back(true);
+  ++n_survivors_;
+
+  BoundingBox box = computeBoundingBox(hull.apex);
+  // Only the hulls whose box overlap the new one can intersect it. The
+  // candidates are sorted, so the pairs are checked in the same order (and
+  // with the same argument order) as in eliminateOverlappingCHulls
+  grid_.query(box, &candidates_);
+  grid_.insert(box);
+
+  for (int i : candidates_) {
+    double intersection_area = intersectionArea(&hulls_[i], &hulls_[j]);
+    if (intersection_area > 0) {
+      if (intersection_area > overlapping_percent_ * hulls_[i].getArea())
+        eliminate(i);
+      if (intersection_area > overlapping_percent_ * hulls_[j].getArea())
+        eliminate(j);
+    }
+  }
+}
+
+std::vector<ConvexHull> IncrementalEliminator::survivors() const {
+  std::vector<ConvexHull> output;
+  output.reserve(n_survivors_);
+  for (int i = 0; i < remaining_convex_hulls_.size(); ++i) {
+    if (remaining_convex_hulls_[i]) output.push_back(hulls_[i]);
+  }
+  return output;
+}
+
+std::vector<ConvexHull> IncrementalEliminator::finalize() {
+  std::vector<ConvexHull> output = survivors();
+  hulls_.clear();
+  remaining_convex_hulls_.clear();
+  n_survivors_ = 0;
+  grid_.clear();
+  return output;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <instrumentation.hpp>
+
+namespace stats {
+namespace {
+std::atomic<uint64_t> stage_times[kNStages];
+// Wall interval of every stage, in steady clock nanoseconds. The first start
+// is stored complemented, so both are raised with atomicMax and the zero
+// initialization is the empty interval.
+std::atomic<uint64_t> stage_first_start_complement[kNStages];
+std::atomic<uint64_t> stage_last_end[kNStages];
+
+// Counters of one thread, written by that thread only. The slots are static
+// and claimed without locking or allocating, as the allocation counter is
+// bumped from operator new. Threads past the last slot share it.
+const int kMaxCounterSlots = 256;
+struct alignas(64) CounterSlot {
+  std::atomic<uint64_t> counts[kNCounters];
+};
+CounterSlot counter_slots[kMaxCounterSlots];
+std::atomic<int> n_counter_slots(0);
+
+const char *stage_names[kNStages] = {"parse", "convexHullsFromJson",
+                                     "elimination", "convexHullsToJson",
+                                     "write"};
+const char *counter_names[kNCounters] = {
+    "pairs considered", "pairs broad-phase rejected", "pairs intersected",
+    "intersection vertices", "exact predicate fallbacks", "allocations"};
+
+uint64_t clockNanoseconds(std::chrono::steady_clock::time_point t) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             t.time_since_epoch())
+      .count();
+}
+
+// Raises value to bound, if it is not already above
+void atomicMax(std::atomic<uint64_t> *value, uint64_t bound) {
+  uint64_t current = value->load(std::memory_order_relaxed);
+  while (bound > current &&
+         !value->compare_exchange_weak(current, bound,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+// Wall time of the interval [~first_start_complement, last_end], 0 when empty
+uint64_t wallTime(uint64_t first_start_complement, uint64_t last_end) {
+  uint64_t first_start = ~first_start_complement;
+  return last_end > first_start ? last_end - first_start : 0;
+}
+}  // namespace
+
+bool isEnabled() {
+#ifdef CONVEX_HULL_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void addCount(Counter counter, uint64_t n) {
+  thread_local int slot = -1;
+  if (slot < 0) {
+    slot = std::min(n_counter_slots.fetch_add(1, std::memory_order_relaxed),
+                    kMaxCounterSlots - 1);
+  }
+  std::atomic<uint64_t> &count = counter_slots[slot].counts[counter];
+  if (slot == kMaxCounterSlots - 1)
+    count.fetch_add(n, std::memory_order_relaxed);
+  else  // no other writer: a plain add, without a locked instruction
+    count.store(count.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+void addStageTime(Stage stage, uint64_t nanoseconds) {
+  stage_times[stage].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void addStageInterval(Stage stage, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end) {
+  uint64_t start_ns = clockNanoseconds(start), end_ns = clockNanoseconds(end);
+  addStageTime(stage, end_ns - start_ns);
+  atomicMax(&stage_first_start_complement[stage], ~start_ns);
+  atomicMax(&stage_last_end[stage], end_ns);
+}
+
+uint64_t getCount(Counter counter) {
+  int n_slots = std::min(n_counter_slots.load(std::memory_order_relaxed),
+                         kMaxCounterSlots);
+  uint64_t total = 0;
+  for (int s = 0; s < n_slots; ++s)
+    total += counter_slots[s].counts[counter].load(std::memory_order_relaxed);
+  return total;
+}
+
+uint64_t getStageTime(Stage stage) {
+  return stage_times[stage].load(std::memory_order_relaxed);
+}
+
+uint64_t getStageWallTime(Stage stage) {
+  return wallTime(
+      stage_first_start_complement[stage].load(std::memory_order_relaxed),
+      stage_last_end[stage].load(std::memory_order_relaxed));
+}
+
+void reset() {
+  for (auto &t : stage_times) t.store(0, std::memory_order_relaxed);
+  for (auto &t : stage_first_start_complement)
+    t.store(0, std::memory_order_relaxed);
+  for (auto &t : stage_last_end) t.store(0, std::memory_order_relaxed);
+  for (CounterSlot &slot : counter_slots) {
+    for (auto &c : slot.counts) c.store(0, std::memory_order_relaxed);
+  }
+}
+
+void printReport(std::ostream &stream) {
+  if (!isEnabled()) {
+    stream << "Statistics were compiled out (build with CONVEX_HULL_STATS)\n";
+    return;
+  }
+  std::ios::fmtflags flags(stream.flags());
+  std::streamsize precision = stream.precision();
+  uint64_t total = 0, first_start_complement = 0, last_end = 0;
+  for (int s = 0; s < kNStages; ++s) {
+    total += getStageTime(Stage(s));
+    first_start_complement = std::max(
+        first_start_complement,
+        stage_first_start_complement[s].load(std::memory_order_relaxed));
+    last_end =
+        std::max(last_end, stage_last_end[s].load(std::memory_order_relaxed));
+  }
+
+  // Summed over the threads (CPU time when they run in parallel, as in the
+  // batch mode) next to the wall time of every stage
+  stream << "Stage timings:\n" << std::fixed << std::setprecision(3);
+  stream << "  " << std::left << std::setw(28) << "stage" << std::right
+         << std::setw(15) << "summed" << std::setw(10) << "" << std::setw(15)
+         << "wall" << "\n";
+  for (int s = 0; s < kNStages; ++s) {
+    double ms = getStageTime(Stage(s)) * 1e-6;
+    double percent = total == 0 ? 0. : 100. * getStageTime(Stage(s)) / total;
+    stream << "  " << std::left << std::setw(28) << stage_names[s]
+           << std::right << std::setw(12) << ms << " ms" << std::setw(8)
+           << std::setprecision(1) << percent << " %" << std::setprecision(3)
+           << std::setw(12) << getStageWallTime(Stage(s)) * 1e-6 << " ms\n";
+  }
+  stream << "  " << std::left << std::setw(28) << "total" << std::right
+         << std::setw(12) << total * 1e-6 << " ms" << std::setw(10) << ""
+         << std::setw(12) << wallTime(first_start_complement, last_end) * 1e-6
+         << " ms\n";
+
+  stream << "Counters:\n";
+  for (int c = 0; c < kNCounters; ++c) {
+    stream << "  " << std::left << std::setw(28) << counter_names[c]
+           << std::right << std::setw(12) << getCount(Counter(c)) << "\n";
+  }
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+}  // namespace stats
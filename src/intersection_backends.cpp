@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <intersection_backends.hpp>
+#include <predicates.hpp>
+
+namespace {
+enum InFlag { kUnknown, kPInside, kQInside };
+
+inline int sign(double value) { return (value > 0) - (value < 0); }
+
+// Relation of the segments a -> b and c -> d
+enum SegmentCode {
+  kNoCrossing,  // disjoint (or parallel, not collinear)
+  kProper,      // cross at an interior point of both
+  kVertex,      // an endpoint lies on the other segment
+  kCollinear    // collinear and overlapping
+};
+
+/**
+ * Classifies the segments a -> b and c -> d from the orientations of each
+ * endpoint relative to the other segment, computing the crossing point
+ * (px, py).
+ */
+template <typename T>
+SegmentCode segmentIntersection(const PointT<T> &a, const PointT<T> &b,
+                                const PointT<T> &c, const PointT<T> &d,
+                                double a_side, double b_side, double c_side,
+                                double d_side, T *px, T *py) {
+  if ((c_side > 0 && d_side > 0) || (c_side < 0 && d_side < 0))
+    return kNoCrossing;
+  if ((a_side > 0 && b_side > 0) || (a_side < 0 && b_side < 0))
+    return kNoCrossing;
+
+  if (c_side == 0 && d_side == 0) {
+    // Collinear: overlapping if the projections on a -> b overlap
+    T ux = b.x - a.x, uy = b.y - a.y;
+    T tc = (c.x - a.x) * ux + (c.y - a.y) * uy;
+    T td = (d.x - a.x) * ux + (d.y - a.y) * uy;
+    T length2 = ux * ux + uy * uy;
+    if (std::max(tc, td) < 0 || std::min(tc, td) > length2)
+      return kNoCrossing;
+    return kCollinear;
+  }
+  double t = a_side / (a_side - b_side);
+  *px = a.x + static_cast<T>(t) * (b.x - a.x);
+  *py = a.y + static_cast<T>(t) * (b.y - a.y);
+  if (a_side == 0 || b_side == 0 || c_side == 0 || d_side == 0)
+    return kVertex;
+  return kProper;
+}
+
+/**
+ * True if the vertex average of P (an interior point) is strictly inside the
+ * CCW polygon Q.
+ */
+template <typename T>
+bool interiorInside(const PointT<T> *P, int n, const PointT<T> *Q, int m) {
+  T cx = 0, cy = 0;
+  for (int i = 0; i < n; ++i) {
+    cx += P[i].x;
+    cy += P[i].y;
+  }
+  cx /= n;
+  cy /= n;
+  for (int j = 0; j < m; ++j) {
+    const PointT<T> &q1 = Q[j], &q2 = Q[j + 1 == m ? 0 : j + 1];
+    if (predicates::orient2d(q1.x, q1.y, q2.x, q2.y, cx, cy) <= 0)
+      return false;
+  }
+  return true;
+}
+
+// Twice the signed area (shoelace), positive for CCW polygons
+template <typename T>
+T signedArea2(const PointT<T> *v, int n) {
+  T sum = v[n - 1].x * v[0].y - v[0].x * v[n - 1].y;
+  for (int i = 0; i < n - 1; ++i)
+    sum += v[i].x * v[i + 1].y - v[i + 1].x * v[i].y;
+  return sum;
+}
+
+template <typename T>
+T shoelaceArea(const PointT<T> *v, int n) {
+  return std::abs(signedArea2(v, n)) / 2;
+}
+
+// Copies the vertices, reversed if they are CW
+template <typename T>
+void counterClockwise(const PointT<T> *v, int n,
+                      SmallVector<PointT<T>, kInlineApexes> *out) {
+  out->assign(v, v + n);
+  if (signedArea2(v, n) < 0) std::reverse(out->begin(), out->end());
+}
+}  // namespace
+
+template <typename T>
+T edgeAdvancingIntersectionArea(const PointT<T> *P_, int n,
+                                const PointT<T> *Q_, int m) {
+  SmallVector<PointT<T>, kInlineApexes> P_ccw, Q_ccw;
+  counterClockwise(P_, n, &P_ccw);
+  counterClockwise(Q_, m, &Q_ccw);
+  const PointT<T> *P = P_ccw.data(), *Q = Q_ccw.data();
+
+  // Vertices of the intersection, as coordinates: constructing a PointT
+  // computes its angle
+  SmallVector<T, 4 * kInlineApexes> xs, ys;
+  InFlag inflag = kUnknown;
+  int a = 0, b = 0;    // current edges: P[a - 1] -> P[a] and Q[b - 1] -> Q[b]
+  int aa = 0, ba = 0;  // number of advances on each polygon
+  // Moves to the next edge, emitting its head if it is on the inner chain
+  auto advance = [&xs, &ys](int *index, int *n_advances, int size,
+                            bool inside, const PointT<T> &head) {
+    if (inside) {
+      xs.push_back(head.x);
+      ys.push_back(head.y);
+    }
+    ++*n_advances;
+    *index = *index + 1 == size ? 0 : *index + 1;
+  };
+
+  do {
+    int a1 = a == 0 ? n - 1 : a - 1;
+    int b1 = b == 0 ? m - 1 : b - 1;
+    T ax = P[a].x - P[a1].x, ay = P[a].y - P[a1].y;
+    T bx = Q[b].x - Q[b1].x, by = Q[b].y - Q[b1].y;
+
+    int cross = sign(predicates::orient2d(0., 0., ax, ay, bx, by));
+    // Sides of the endpoints of each edge relative to the other edge
+    double a1_side = predicates::orient2d(Q[b1], Q[b], P[a1]);
+    double a_side = predicates::orient2d(Q[b1], Q[b], P[a]);
+    double b1_side = predicates::orient2d(P[a1], P[a], Q[b1]);
+    double b_side = predicates::orient2d(P[a1], P[a], Q[b]);
+    int a_hb = sign(a_side);  // P[a] in the half plane of edge b
+    int b_ha = sign(b_side);  // Q[b] in the half plane of edge a
+
+    T px, py;
+    SegmentCode code = segmentIntersection(P[a1], P[a], Q[b1], Q[b], a1_side,
+                                           a_side, b1_side, b_side, &px, &py);
+    if (code == kProper || code == kVertex) {
+      if (inflag == kUnknown) aa = ba = 0;  // restart the count
+      xs.push_back(px);
+      ys.push_back(py);
+      if (a_hb > 0)
+        inflag = kPInside;
+      else if (b_ha > 0)
+        inflag = kQInside;
+    }
+
+    // Edges on the same line in opposite directions: the polygons only touch
+    if (code == kCollinear && ax * bx + ay * by < 0) return 0;
+    // Parallel edges with each polygon on the outside of the other one
+    if (cross == 0 && a_hb < 0 && b_ha < 0) return 0;
+
+    if (cross == 0 && a_hb == 0 && b_ha == 0) {
+      // Collinear edges: advance the one that is not on the inner chain
+      if (inflag == kPInside)
+        advance(&b, &ba, m, false, Q[b]);
+      else
+        advance(&a, &aa, n, false, P[a]);
+    } else if (cross >= 0) {
+      if (b_ha > 0)
+        advance(&a, &aa, n, inflag == kPInside, P[a]);
+      else
+        advance(&b, &ba, m, inflag == kQInside, Q[b]);
+    } else {
+      if (a_hb > 0)
+        advance(&b, &ba, m, inflag == kQInside, Q[b]);
+      else
+        advance(&a, &aa, n, inflag == kPInside, P[a]);
+    }
+  } while ((aa < n || ba < m) && aa < 2 * n && ba < 2 * m);
+
+  if (inflag == kUnknown) {
+    // The boundaries do not cross: the smaller polygon is inside the larger
+    // one, or they are disjoint (or only touch). The interior of the smaller
+    // one is then either inside the larger one or outside of it, so testing
+    // a single interior point is enough, O(n + m)
+    T area_p = shoelaceArea(P, n), area_q = shoelaceArea(Q, m);
+    if (area_p <= area_q) return interiorInside(P, n, Q, m) ? area_p : 0;
+    return interiorInside(Q, m, P, n) ? area_q : 0;
+  }
+  int n_vertices = xs.size();
+  if (n_vertices < 3) return 0;
+  T sum = xs[n_vertices - 1] * ys[0] - xs[0] * ys[n_vertices - 1];
+  for (int i = 0; i < n_vertices - 1; ++i)
+    sum += xs[i] * ys[i + 1] - xs[i + 1] * ys[i];
+  return std::abs(sum) / 2;
+}
+
+std::unique_ptr<IntersectionBackend> makeIntersectionBackend(
+    const std::string &name) {
+  std::unique_ptr<IntersectionBackend> backend;
+  if (name == AutoBackend::getName())
+    backend.reset(new IntersectionBackendAdapter<AutoBackend>());
+  else if (name == VertexCollectionBackend::getName())
+    backend.reset(new IntersectionBackendAdapter<VertexCollectionBackend>());
+  else if (name == SutherlandHodgmanBackend::getName())
+    backend.reset(new IntersectionBackendAdapter<SutherlandHodgmanBackend>());
+  else if (name == EdgeAdvancingBackend::getName())
+    backend.reset(new IntersectionBackendAdapter<EdgeAdvancingBackend>());
+  return backend;
+}
+
+std::vector<std::string> getIntersectionBackendNames() {
+  return {AutoBackend::getName(), VertexCollectionBackend::getName(),
+          SutherlandHodgmanBackend::getName(), EdgeAdvancingBackend::getName()};
+}
+
+template float edgeAdvancingIntersectionArea<float>(const PointF *, int,
+                                                    const PointF *, int);
+template double edgeAdvancingIntersectionArea<double>(const Point *, int,
+                                                      const Point *, int);
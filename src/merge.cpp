@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
+#include <merge.hpp>
+#include <numeric>
+#include <predicates.hpp>
+#include <spatial_index.hpp>
+#include <trace.hpp>
+
+namespace {
+// Components per parallel chunk
+const int kComponentGrain = 16;
+
+bool lexLess(const Point &a, const Point &b) {
+  return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+/**
+ * Vertices of a convex polygon sorted by (x, y). Walking CCW, the lower
+ * chain goes from the lowest to the highest vertex and the upper chain
+ * comes back, so both are already sorted and only have to be merged.
+ * Non convex input falls back to a sort.
+ */
+void sortedVertices(const ConvexHull &hull, std::vector<Point> *sorted) {
+  int n = hull.apex.size();
+  const Point *v = hull.apex.data();
+  double area2 = 0;
+  for (int i = 0; i < n; ++i) {
+    const Point &q = v[i + 1 == n ? 0 : i + 1];
+    area2 += v[i].x * q.y - q.x * v[i].y;
+  }
+  bool ccw = area2 >= 0;
+  // k-th vertex in CCW order
+  auto at = [&](int k) -> const Point & { return ccw ? v[k] : v[n - 1 - k]; };
+  int lowest = 0, highest = 0;
+  for (int k = 1; k < n; ++k) {
+    if (lexLess(at(k), at(lowest))) lowest = k;
+    if (lexLess(at(highest), at(k))) highest = k;
+  }
+  std::vector<Point> lower, upper;
+  lower.reserve(n);
+  upper.reserve(n);
+  for (int k = lowest;; k = k + 1 == n ? 0 : k + 1) {
+    lower.push_back(at(k));
+    if (k == highest) break;
+  }
+  // The upper chain walked backwards, without its endpoints
+  for (int k = lowest == 0 ? n - 1 : lowest - 1; k != highest;
+       k = k == 0 ? n - 1 : k - 1)
+    upper.push_back(at(k));
+
+  sorted->resize(n);
+  std::merge(lower.begin(), lower.end(), upper.begin(), upper.end(),
+             sorted->begin(), lexLess);
+  if (!std::is_sorted(sorted->begin(), sorted->end(), lexLess))
+    std::sort(sorted->begin(), sorted->end(), lexLess);
+}
+
+// Andrew's monotone chain over points sorted by (x, y), CCW output
+std::vector<Point> monotoneChain(const std::vector<Point> &points) {
+  int n = points.size();
+  std::vector<Point> hull(2 * n);
+  int k = 0;
+  for (int i = 0; i < n; ++i) {
+    while (k >= 2 &&
+           predicates::orient2d(hull[k - 2], hull[k - 1], points[i]) <= 0)
+      --k;
+    hull[k++] = points[i];
+  }
+  for (int i = n - 2, lower_size = k + 1; i >= 0; --i) {
+    while (k >= lower_size &&
+           predicates::orient2d(hull[k - 2], hull[k - 1], points[i]) <= 0)
+      --k;
+    hull[k++] = points[i];
+  }
+  hull.resize(std::max(k - 1, 0));
+  return hull;
+}
+
+// Disjoint sets of hull indices, with path halving and union by index (the
+// root of a set is its smallest member)
+class DisjointSets {
+ public:
+  explicit DisjointSets(int n) : parent_(n) {
+    std::iota(parent_.begin(), parent_.end(), 0);
+  }
+
+  int find(int i) {
+    while (parent_[i] != i) {
+      parent_[i] = parent_[parent_[i]];
+      i = parent_[i];
+    }
+    return i;
+  }
+
+  void unite(int i, int j) {
+    i = find(i);
+    j = find(j);
+    if (i < j)
+      parent_[j] = i;
+    else if (j < i)
+      parent_[i] = j;
+  }
+
+ private:
+  std::vector<int> parent_;
+};
+}  // namespace
+
+ConvexHull mergeConvexHulls(const ConvexHull *const *hulls, int n_hulls,
+                            int id) {
+  assert(n_hulls > 0);
+  std::vector<std::vector<Point>> lists(n_hulls);
+  for (int h = 0; h < n_hulls; ++h) sortedVertices(*hulls[h], &lists[h]);
+  // Pairwise merges, as in a bottom up merge sort
+  std::vector<Point> merged;
+  for (int step = 1; step < n_hulls; step *= 2) {
+    for (int h = 0; h + step < n_hulls; h += 2 * step) {
+      merged.resize(lists[h].size() + lists[h + step].size());
+      std::merge(lists[h].begin(), lists[h].end(), lists[h + step].begin(),
+                 lists[h + step].end(), merged.begin(), lexLess);
+      lists[h].swap(merged);
+      std::vector<Point>().swap(lists[h + step]);
+    }
+  }
+  std::vector<Point> vertices = monotoneChain(lists[0]);
+  // Only possible if every input hull is degenerate
+  if (vertices.size() < 3)
+    return ConvexHull(hulls[0]->apex.data(), hulls[0]->apex.size(), id);
+  return ConvexHull(vertices, id);
+}
+
+std::vector<ConvexHull> mergeOverlappingCHulls(
+    std::vector<ConvexHull> *input, double overlapping_percent,
+    ThreadPool *pool, const IntersectionBackend *backend) {
+  CH_TRACE_SPAN("mergeOverlappingCHulls", input->size());
+  int n_hulls = input->size();
+  std::vector<BoundingBox> boxes;
+  boxes.reserve(n_hulls);
+  for (const ConvexHull &c : *input)
+    boxes.push_back(computeBoundingBox(c.apex));
+
+  // Overlap graph, with the pair rule of eliminateOverlappingCHulls
+  DisjointSets components(n_hulls);
+  for (int i = 0; i + 1 < n_hulls; ++i) {
+    for (int j = i + 1; j < n_hulls; ++j) {
+      CH_STATS_COUNT(kPairsConsidered, 1);
+      if (!boxes[i].overlaps(boxes[j])) {
+        CH_STATS_COUNT(kPairsBroadPhaseRejected, 1);
+        continue;
+      }
+      double intersection_area =
+          backend ? backend->intersectionArea(&input->at(i), &input->at(j))
+                  : intersectionArea(&input->at(i), &input->at(j));
+      if (intersection_area <= 0) continue;
+      CH_STATS_COUNT(kPairsIntersected, 1);
+      if (intersection_area > overlapping_percent * input->at(i).getArea() ||
+          intersection_area > overlapping_percent * input->at(j).getArea())
+        components.unite(i, j);
+    }
+  }
+
+  // Members of every component, components ordered by their first member
+  std::vector<int> component_of(n_hulls, -1);
+  std::vector<std::vector<const ConvexHull *>> members;
+  for (int i = 0; i < n_hulls; ++i) {
+    int root = components.find(i);
+    if (component_of[root] < 0) {
+      component_of[root] = members.size();
+      members.emplace_back();
+    }
+    members[component_of[root]].push_back(&input->at(i));
+  }
+
+  std::vector<ConvexHull> output(members.size());
+  auto merge_components = [&](int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      const std::vector<const ConvexHull *> &hulls = members[c];
+      if (hulls.size() == 1) {
+        output[c] = *hulls[0];
+      } else {
+        CH_TRACE_SPAN("merge component", hulls.size());
+        output[c] =
+            mergeConvexHulls(hulls.data(), hulls.size(), hulls[0]->id);
+      }
+    }
+  };
+  if (pool != nullptr)
+    pool->parallelFor(members.size(), kComponentGrain, merge_components);
+  else
+    merge_components(0, members.size());
+  return output;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cmath>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
+#include <nms.hpp>
+#include <numeric>
+#include <queue>
+#include <spatial_index.hpp>
+#include <stdexcept>
+#include <trace.hpp>
+
+namespace {
+double iou(ConvexHull *C1, ConvexHull *C2, const NmsOptions &options) {
+  double intersection_area = options.backend
+                                 ? options.backend->intersectionArea(C1, C2)
+                                 : intersectionArea(C1, C2);
+  if (intersection_area <= 0) return 0;
+  CH_STATS_COUNT(kPairsIntersected, 1);
+  // The cached areas: getArea() writes them, which would race if the pairs
+  // were ever compared in parallel
+  return intersection_area / (C1->area + C2->area - intersection_area);
+}
+
+std::vector<int> hardNms(std::vector<ConvexHull> *input,
+                         const std::vector<double> &scores,
+                         const NmsOptions &options) {
+  std::vector<int> order(input->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return scores[a] > scores[b]; });
+
+  // Grid ids are positions in kept, so the candidates found by a query are
+  // visited from the highest score down
+  SpatialHashGrid grid(options.cell_size);
+  std::vector<int> kept, neighbours;
+  for (int i : order) {
+    if (scores[i] < options.score_threshold) break;
+    if (options.max_output > 0 && kept.size() == options.max_output) break;
+
+    ConvexHull &candidate = input->at(i);
+    BoundingBox box = computeBoundingBox(candidate.apex);
+    grid.query(box, &neighbours);
+    bool suppressed = false;
+    for (int k : neighbours) {
+      CH_STATS_COUNT(kPairsConsidered, 1);
+      ConvexHull &other = input->at(kept[k]);
+      if (iou(&candidate, &other, options) > options.iou_threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (suppressed) continue;
+    grid.insert(box);
+    kept.push_back(i);
+  }
+  return kept;
+}
+
+// Score multiplier of a hull overlapping a kept hull by the given IoU
+double softNmsWeight(double overlap, const NmsOptions &options) {
+  if (options.method == kNmsLinear)
+    return overlap > options.iou_threshold ? 1. - overlap : 1.;
+  return std::exp(-overlap * overlap / options.sigma);
+}
+
+std::vector<int> softNms(std::vector<ConvexHull> *input,
+                         std::vector<double> *scores,
+                         const NmsOptions &options) {
+  int n_hulls = input->size();
+  SpatialHashGrid grid(options.cell_size);
+  for (const ConvexHull &c : *input) grid.insert(computeBoundingBox(c.apex));
+
+  // Max-heap of (score, -index): ties go to the first hull. A hull whose
+  // score changed is pushed again, and the stale entries are skipped.
+  typedef std::pair<double, int> Entry;
+  std::priority_queue<Entry> heap;
+  std::vector<bool> done(n_hulls, false);
+  for (int i = 0; i < n_hulls; ++i) {
+    if (scores->at(i) < options.score_threshold)
+      done[i] = true;
+    else
+      heap.push(Entry(scores->at(i), -i));
+  }
+
+  std::vector<int> kept, neighbours;
+  while (!heap.empty()) {
+    Entry top = heap.top();
+    heap.pop();
+    int i = -top.second;
+    if (done[i] || top.first != scores->at(i)) continue;
+    done[i] = true;
+    kept.push_back(i);
+    if (options.max_output > 0 && kept.size() == options.max_output) break;
+
+    grid.query(grid.getBox(i), &neighbours);
+    for (int j : neighbours) {
+      if (done[j]) continue;
+      CH_STATS_COUNT(kPairsConsidered, 1);
+      double weight =
+          softNmsWeight(iou(&input->at(i), &input->at(j), options), options);
+      if (weight == 1.) continue;
+      double &score = scores->at(j);
+      score *= weight;
+      if (score < options.score_threshold)
+        done[j] = true;
+      else
+        heap.push(Entry(score, -j));
+    }
+  }
+  return kept;
+}
+}  // namespace
+
+std::vector<int> nonMaximumSuppression(std::vector<ConvexHull> *input,
+                                       const std::vector<double> &scores,
+                                       const NmsOptions &options,
+                                       std::vector<double> *kept_scores) {
+  CH_TRACE_SPAN("nonMaximumSuppression", input->size(), options.method);
+  assert(scores.size() == input->size());
+  std::vector<int> kept;
+  std::vector<double> decayed;
+  if (options.method == kNmsHard) {
+    kept = hardNms(input, scores, options);
+  } else {
+    decayed = scores;
+    kept = softNms(input, &decayed, options);
+  }
+  if (kept_scores != nullptr) {
+    const std::vector<double> &final_scores =
+        options.method == kNmsHard ? scores : decayed;
+    kept_scores->clear();
+    for (int i : kept) kept_scores->push_back(final_scores[i]);
+  }
+  return kept;
+}
+
+NmsMethod nmsMethodFromName(const std::string &name) {
+  if (name == "linear") return kNmsLinear;
+  if (name == "gaussian") return kNmsGaussian;
+  if (name == "hard") return kNmsHard;
+  throw std::invalid_argument("unknown NMS method " + name +
+                              ", expected hard, linear or gaussian");
+}
+
+std::vector<double> scoresFromJson(const json &data, double default_score) {
+  const json &hulls = data["convex hulls"];
+  std::vector<double> scores;
+  scores.reserve(hulls.size());
+  for (const json &hull : hulls)
+    scores.push_back(hull.value("score", default_score));
+  return scores;
+}
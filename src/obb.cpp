@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <cmath>
+#include <intersection_backends.hpp>
+#include <limits>
+#include <obb.hpp>
+#include <trace.hpp>
+
+namespace {
+/**
+ * Clips a polygon given in the frame of a box against the four sides of the
+ * box, [-hx, hx] x [-hy, hy]. xs/ys and tmp_x/tmp_y have room for capacity
+ * vertices. A side adds one vertex in exact arithmetic, but rounding can add
+ * one per vertex lying on it, so the writes are bounded by capacity.
+ * @returns the area of the clipped polygon
+ */
+template <typename T>
+T clipToBoxArea(T *xs, T *ys, int n, T hx, T hy, T *tmp_x, T *tmp_y,
+                int capacity) {
+  // Each side is the half plane sign * coordinate <= limit
+  const int axis[4] = {0, 0, 1, 1};
+  const T sign[4] = {1, -1, 1, -1};
+  const T limit[4] = {hx, hx, hy, hy};
+
+  T *x = xs, *y = ys, *out_x = tmp_x, *out_y = tmp_y;
+  for (int side = 0; side < 4; ++side) {
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+      int j = i + 1 == n ? 0 : i + 1;
+      T ci = axis[side] == 0 ? x[i] : y[i];
+      T cj = axis[side] == 0 ? x[j] : y[j];
+      T di = limit[side] - sign[side] * ci;  // >= 0 inside
+      T dj = limit[side] - sign[side] * cj;
+      if (di >= 0 && m < capacity) {
+        out_x[m] = x[i];
+        out_y[m] = y[i];
+        ++m;
+      }
+      if ((di >= 0) != (dj >= 0) && m < capacity) {
+        T t = di / (di - dj);
+        out_x[m] = x[i] + t * (x[j] - x[i]);
+        out_y[m] = y[i] + t * (y[j] - y[i]);
+        ++m;
+      }
+    }
+    n = m;
+    std::swap(x, out_x);
+    std::swap(y, out_y);
+    if (n < 3) return 0;
+  }
+
+  T sum = x[n - 1] * y[0] - x[0] * y[n - 1];
+  for (int i = 0; i < n - 1; ++i) sum += x[i] * y[i + 1] - x[i + 1] * y[i];
+  return std::abs(sum) / 2;
+}
+}  // namespace
+
+template <typename T>
+void OrientedBoxT<T>::getCorners(PointT<T> corners[4]) const {
+  T c = std::cos(yaw), s = std::sin(yaw);
+  const T dx[4] = {-half_x, half_x, half_x, -half_x};
+  const T dy[4] = {-half_y, -half_y, half_y, half_y};
+  for (int i = 0; i < 4; ++i) {
+    corners[i] = PointT<T>(center.x + c * dx[i] - s * dy[i],
+                           center.y + s * dx[i] + c * dy[i]);
+  }
+}
+
+template <typename T>
+BoundingBox OrientedBoxT<T>::getBoundingBox() const {
+  T c = std::abs(std::cos(yaw)), s = std::abs(std::sin(yaw));
+  T ex = c * half_x + s * half_y;
+  T ey = s * half_x + c * half_y;
+  return BoundingBox(center.x - ex, center.y - ey, center.x + ex,
+                     center.y + ey);
+}
+
+template <typename T>
+ConvexHullT<T> OrientedBoxT<T>::toConvexHull() const {
+  PointT<T> corners[4];
+  getCorners(corners);
+  return ConvexHullT<T>(corners, 4, id);
+}
+
+namespace {
+/**
+ * Pose of box B in the frame of box A: center of B (tx, ty) and rotation of
+ * B relative to A (c, s). Only the two yaws go through cos/sin.
+ */
+template <typename T>
+struct RelativePose {
+  T tx, ty, c, s;
+  RelativePose(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B) {
+    T ca = std::cos(A.yaw), sa = std::sin(A.yaw);
+    T cb = std::cos(B.yaw), sb = std::sin(B.yaw);
+    T dx = B.center.x - A.center.x, dy = B.center.y - A.center.y;
+    tx = ca * dx + sa * dy;
+    ty = -sa * dx + ca * dy;
+    c = ca * cb + sa * sb;
+    s = ca * sb - sa * cb;
+  }
+};
+
+// Separating axis test on the 4 box axes, in the frame of A
+template <typename T>
+bool separated(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B,
+               const RelativePose<T> &pose) {
+  T c = std::abs(pose.c), s = std::abs(pose.s);
+  // Axes of A
+  if (std::abs(pose.tx) > A.half_x + c * B.half_x + s * B.half_y) return true;
+  if (std::abs(pose.ty) > A.half_y + s * B.half_x + c * B.half_y) return true;
+  // Axes of B
+  T bx = std::abs(pose.c * pose.tx + pose.s * pose.ty);
+  T by = std::abs(-pose.s * pose.tx + pose.c * pose.ty);
+  if (bx > B.half_x + c * A.half_x + s * A.half_y) return true;
+  if (by > B.half_y + s * A.half_x + c * A.half_y) return true;
+  return false;
+}
+}  // namespace
+
+template <typename T>
+bool obbsOverlap(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B) {
+  return !separated(A, B, RelativePose<T>(A, B));
+}
+
+template <typename T>
+T obbIntersectionArea(const OrientedBoxT<T> &A, const OrientedBoxT<T> &B) {
+  RelativePose<T> pose(A, B);
+  if (separated(A, B, pose)) return 0;
+  // Corners of B in the frame of A
+  const T dx[4] = {-B.half_x, B.half_x, B.half_x, -B.half_x};
+  const T dy[4] = {-B.half_y, -B.half_y, B.half_y, B.half_y};
+  T xs[8], ys[8], tmp_x[8], tmp_y[8];
+  for (int i = 0; i < 4; ++i) {
+    xs[i] = pose.tx + pose.c * dx[i] - pose.s * dy[i];
+    ys[i] = pose.ty + pose.s * dx[i] + pose.c * dy[i];
+  }
+  return clipToBoxArea(xs, ys, 4, A.half_x, A.half_y, tmp_x, tmp_y, 8);
+}
+
+namespace {
+// Area of the intersection of a box and the convex polygon v[0 .. n - 1]
+template <typename T>
+T boxPolygonIntersectionArea(const OrientedBoxT<T> &A, const PointT<T> *v,
+                             int n) {
+  // Up to kInlineApexes vertices the buffers stay on the stack
+  const int capacity = 2 * (n + 4);
+  SmallVector<T, 8 * (kInlineApexes + 4)> buffer;
+  buffer.resize(4 * capacity);
+  T *xs = buffer.data(), *ys = xs + capacity;
+  T *tmp_x = ys + capacity, *tmp_y = tmp_x + capacity;
+
+  T c = std::cos(A.yaw), s = std::sin(A.yaw);
+  for (int i = 0; i < n; ++i) {
+    T dx = v[i].x - A.center.x, dy = v[i].y - A.center.y;
+    xs[i] = c * dx + s * dy;
+    ys[i] = -s * dx + c * dy;
+  }
+  return clipToBoxArea(xs, ys, n, A.half_x, A.half_y, tmp_x, tmp_y,
+                       capacity);
+}
+}  // namespace
+
+template <typename T>
+T obbHullIntersectionArea(const OrientedBoxT<T> &A, const ConvexHullT<T> &C) {
+  return boxPolygonIntersectionArea(A, C.apex.data(), C.apex.size());
+}
+
+template <typename T>
+T obbHullIntersectionArea(const OrientedBoxT<T> &A,
+                          const ConvexHullViewT<T> &C) {
+  return boxPolygonIntersectionArea(A, C.apex, C.n_apexes);
+}
+
+template <typename T>
+bool isPointInsideOBB(const OrientedBoxT<T> &A, const PointT<T> &P) {
+  T c = std::cos(A.yaw), s = std::sin(A.yaw);
+  T dx = P.x - A.center.x, dy = P.y - A.center.y;
+  return std::abs(c * dx + s * dy) < A.half_x &&
+         std::abs(-s * dx + c * dy) < A.half_y;
+}
+
+template <typename T>
+bool trustedMinAreaRectangle(const ConvexHullT<T> &hull,
+                             OrientedBoxT<T> *rectangle) {
+  const HullDescriptorsT<T> *descriptors = hull.getCachedDescriptors();
+  if (descriptors == nullptr) return false;
+  OrientedBoxT<T> box = minAreaRectangle(*descriptors, hull.id);
+  // Rounding grows with the magnitude of the coordinates, not only with the
+  // size of the hull
+  T magnitude = std::max(std::abs(box.center.x), std::abs(box.center.y));
+  T pad = 32 * std::numeric_limits<T>::epsilon() *
+          (magnitude + box.half_x + box.half_y);
+  box.half_x += pad;
+  box.half_y += pad;
+  // Negated so NaN descriptors are rejected too
+  if (!(box.half_x >= 0 && box.half_y >= 0)) return false;
+  T c = std::cos(box.yaw), s = std::sin(box.yaw);
+  for (const PointT<T> &p : hull.apex) {
+    T dx = p.x - box.center.x, dy = p.y - box.center.y;
+    if (!(std::abs(c * dx + s * dy) <= box.half_x &&
+          std::abs(-s * dx + c * dy) <= box.half_y))
+      return false;
+  }
+  *rectangle = box;
+  return true;
+}
+
+template <typename T>
+bool minAreaRectanglesSeparated(const ConvexHullT<T> &A,
+                                const ConvexHullT<T> &B) {
+  OrientedBoxT<T> a, b;
+  return trustedMinAreaRectangle(A, &a) && trustedMinAreaRectangle(B, &b) &&
+         !obbsOverlap(a, b);
+}
+
+template <typename T>
+std::vector<OrientedBoxT<T>> eliminateOverlappingOBBs(
+    std::vector<OrientedBoxT<T>> *input, double overlapping_percent) {
+  CH_TRACE_SPAN("eliminateOverlappingOBBs", input->size());
+  return eliminateOverlappingCHullsWith(input, overlapping_percent,
+                                        OBBIntersectionBackend());
+}
+
+#define INSTANTIATE_OBB(T)                                                   \
+  template struct OrientedBoxT<T>;                                           \
+  template bool obbsOverlap<T>(const OrientedBoxT<T> &,                      \
+                               const OrientedBoxT<T> &);                     \
+  template T obbIntersectionArea<T>(const OrientedBoxT<T> &,                 \
+                                    const OrientedBoxT<T> &);                \
+  template T obbHullIntersectionArea<T>(const OrientedBoxT<T> &,             \
+                                        const ConvexHullT<T> &);             \
+  template T obbHullIntersectionArea<T>(const OrientedBoxT<T> &,             \
+                                        const ConvexHullViewT<T> &);         \
+  template bool isPointInsideOBB<T>(const OrientedBoxT<T> &,                 \
+                                    const PointT<T> &);                      \
+  template bool trustedMinAreaRectangle<T>(const ConvexHullT<T> &,           \
+                                           OrientedBoxT<T> *);               \
+  template bool minAreaRectanglesSeparated<T>(const ConvexHullT<T> &,        \
+                                              const ConvexHullT<T> &);       \
+  template std::vector<OrientedBoxT<T>> eliminateOverlappingOBBs<T>(         \
+      std::vector<OrientedBoxT<T>> *, double);
+
+INSTANTIATE_OBB(float)
+INSTANTIATE_OBB(double)
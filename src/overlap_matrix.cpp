@@ -0,0 +1,63 @@
+#include <instrumentation.hpp>
+#include <overlap_matrix.hpp>
+#include <spatial_index.hpp>
+#include <trace.hpp>
+
+namespace {
+// Rows per parallel chunk
+const int kRowGrain = 64;
+}  // namespace
+
+OverlapMatrix computeOverlapMatrix(std::vector<ConvexHull> *rows,
+                                   std::vector<ConvexHull> *cols,
+                                   ThreadPool *pool, double cell_size) {
+  CH_TRACE_SPAN("computeOverlapMatrix", rows->size(), cols->size());
+  OverlapMatrix matrix;
+  matrix.n_rows = rows->size();
+  matrix.n_cols = cols->size();
+  if (matrix.n_rows == 0 || matrix.n_cols == 0) return matrix;
+
+  // Candidate columns of every row, in CSR layout. The grid queries are
+  // cheap compared with the intersections, so they run on this thread.
+  SpatialHashGrid grid(cell_size);
+  for (const ConvexHull &c : *cols) grid.insert(computeBoundingBox(c.apex));
+  std::vector<int> offsets(matrix.n_rows + 1, 0), candidates, found;
+  for (int i = 0; i < matrix.n_rows; ++i) {
+    grid.query(computeBoundingBox(rows->at(i).apex), &found);
+    candidates.insert(candidates.end(), found.begin(), found.end());
+    offsets[i + 1] = candidates.size();
+  }
+  CH_STATS_COUNT(kPairsConsidered, candidates.size());
+
+  // Every chunk of rows fills its own entry list; concatenating them in chunk
+  // order keeps the entries sorted
+  int n_chunks = (matrix.n_rows + kRowGrain - 1) / kRowGrain;
+  std::vector<std::vector<OverlapEntry>> chunk_entries(n_chunks);
+  auto compute_rows = [&](int begin, int end) {
+    std::vector<OverlapEntry> &entries = chunk_entries[begin / kRowGrain];
+    for (int i = begin; i < end; ++i) {
+      ConvexHull &C1 = rows->at(i);
+      for (int k = offsets[i]; k < offsets[i + 1]; ++k) {
+        int j = candidates[k];
+        ConvexHull &C2 = cols->at(j);
+        double intersection_area = intersectionArea(&C1, &C2);
+        if (intersection_area <= 0) continue;
+        CH_STATS_COUNT(kPairsIntersected, 1);
+        // The areas cached at construction: getArea() recomputes and
+        // writes them, and the column hulls are shared by the chunks
+        double union_area = C1.area + C2.area - intersection_area;
+        entries.push_back(OverlapEntry(i, j, intersection_area,
+                                       intersection_area / union_area));
+      }
+    }
+  };
+  if (pool != nullptr)
+    pool->parallelFor(matrix.n_rows, kRowGrain, compute_rows);
+  else
+    compute_rows(0, matrix.n_rows);
+
+  for (const std::vector<OverlapEntry> &entries : chunk_entries)
+    matrix.entries.insert(matrix.entries.end(), entries.begin(),
+                          entries.end());
+  return matrix;
+}
@@ -0,0 +1,85 @@
+#include <instrumentation.hpp>
+#include <predicates.hpp>
+
+namespace predicates {
+namespace {
+// x + y == a + b exactly, with x = fl(a + b)
+inline void twoSum(double a, double b, double *x, double *y) {
+  *x = a + b;
+  double b_virtual = *x - a;
+  double a_virtual = *x - b_virtual;
+  *y = (a - a_virtual) + (b - b_virtual);
+}
+
+// x + y == a - b exactly, with x = fl(a - b)
+inline void twoDiff(double a, double b, double *x, double *y) {
+  *x = a - b;
+  double b_virtual = a - *x;
+  double a_virtual = *x + b_virtual;
+  *y = (a - a_virtual) + (b_virtual - b);
+}
+
+// x + y == a * b exactly, with x = fl(a * b)
+inline void twoProduct(double a, double b, double *x, double *y) {
+  *x = a * b;
+  *y = std::fma(a, b, -*x);
+}
+
+/**
+ * Adds a double to an expansion (components sorted by increasing magnitude,
+ * non overlapping), dropping the zero components.
+ * @returns the length of the output expansion h (at most e_length + 1)
+ */
+int growExpansion(int e_length, const double *e, double b, double *h) {
+  double q = b;
+  int h_length = 0;
+  for (int i = 0; i < e_length; ++i) {
+    double sum, error;
+    twoSum(q, e[i], &sum, &error);
+    q = sum;
+    if (error != 0) h[h_length++] = error;
+  }
+  if (q != 0 || h_length == 0) h[h_length++] = q;
+  return h_length;
+}
+}  // namespace
+
+double orient2dExact(double ax, double ay, double bx, double by, double cx,
+                     double cy) {
+  CH_STATS_COUNT(kExactPredicates, 1);
+  // The differences are exact as head + tail
+  double acx, acx_tail, acy, acy_tail, bcx, bcx_tail, bcy, bcy_tail;
+  twoDiff(ax, cx, &acx, &acx_tail);
+  twoDiff(ay, cy, &acy, &acy_tail);
+  twoDiff(bx, cx, &bcx, &bcx_tail);
+  twoDiff(by, cy, &bcy, &bcy_tail);
+
+  // det = acx * bcy - acy * bcx, expanded into 8 exact products
+  const double left[4][2] = {{acx, bcy},
+                             {acx, bcy_tail},
+                             {acx_tail, bcy},
+                             {acx_tail, bcy_tail}};
+  const double right[4][2] = {{acy, bcx},
+                              {acy, bcx_tail},
+                              {acy_tail, bcx},
+                              {acy_tail, bcx_tail}};
+  double terms[16];
+  for (int i = 0; i < 4; ++i) {
+    twoProduct(left[i][0], left[i][1], &terms[4 * i], &terms[4 * i + 1]);
+    twoProduct(-right[i][0], right[i][1], &terms[4 * i + 2],
+               &terms[4 * i + 3]);
+  }
+
+  double expansion[2][17];
+  int length = 0, in = 0;
+  for (int i = 0; i < 16; ++i) {
+    length = growExpansion(length, expansion[in], terms[i], expansion[1 - in]);
+    in = 1 - in;
+  }
+  // The largest component carries the sign; summing the components from
+  // the smallest gives the best double approximation
+  double det = 0;
+  for (int i = 0; i < length; ++i) det += expansion[in][i];
+  return det;
+}
+}  // namespace predicates
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <instrumentation.hpp>
+#include <intersection_backends.hpp>
+#include <quantization.hpp>
+#include <stdexcept>
+#include <string>
+#include <trace.hpp>
+
+namespace {
+// Exact orientation of c relative to a -> b, inputs within kMaxQuantized
+inline int64_t orient(int64_t ax, int64_t ay, int64_t bx, int64_t by,
+                      int64_t cx, int64_t cy) {
+  return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Shoelace area of a polygon given by json vertices, in world units
+double polygonArea(const std::vector<Point> &v) {
+  double sum = v.back().x * v.front().y - v.front().x * v.back().y;
+  for (int i = 0; i + 1 < v.size(); ++i)
+    sum += v[i].x * v[i + 1].y - v[i + 1].x * v[i].y;
+  return std::abs(sum) / 2;
+}
+}  // namespace
+
+Quantizer::Quantizer(double resolution, double origin_x, double origin_y)
+    : resolution_(resolution), origin_x_(origin_x), origin_y_(origin_y) {
+  assert(resolution > 0);
+}
+
+int32_t Quantizer::quantize(double value, double origin, bool *clamped) const {
+  double q = std::round((value - origin) / resolution_);
+  *clamped = false;
+  if (q > kMaxQuantized) {
+    *clamped = true;
+    return kMaxQuantized;
+  }
+  if (q < -kMaxQuantized) {
+    *clamped = true;
+    return -kMaxQuantized;
+  }
+  return static_cast<int32_t>(q);
+}
+
+QuantizedHull::QuantizedHull(const int32_t *xs_, const int32_t *ys_,
+                             int n_apexes, int id_)
+    : id(id_) {
+  assert(n_apexes >= 3);
+  xs.assign(xs_, xs_ + n_apexes);
+  ys.assign(ys_, ys_ + n_apexes);
+  computeArea();
+}
+
+void QuantizedHull::computeArea() {
+  // Fan around the first vertex: every term is bounded by the total area, so
+  // the sum can not overflow
+  const int32_t *x = xs.data(), *y = ys.data();
+  area2 = 0;
+  for (int i = 1; i + 1 < xs.size(); ++i)
+    area2 += orient(x[0], y[0], x[i], y[i], x[i + 1], y[i + 1]);
+}
+
+bool QuantizedHull::isPointInside(int64_t px, int64_t py) const {
+  const int32_t *x = xs.data(), *y = ys.data();
+  int n = xs.size();
+  // Counts the edges that have the point on their left and on their right.
+  // No early exit and no wrap around in the loop, so it vectorizes
+  int n_left = 0, n_right = 0;
+  for (int i = 0; i < n - 1; ++i) {
+    int64_t cross = orient(x[i], y[i], x[i + 1], y[i + 1], px, py);
+    n_left += cross > 0;
+    n_right += cross < 0;
+  }
+  int64_t cross = orient(x[n - 1], y[n - 1], x[0], y[0], px, py);
+  n_left += cross > 0;
+  n_right += cross < 0;
+  return n_left == n || n_right == n;
+}
+
+std::vector<QuantizedHull> convexHullsFromJson(const json &data,
+                                               const Quantizer &quantizer,
+                                               QuantizationReport *report) {
+  CH_TRACE_SPAN("convexHullsFromJson quantized");
+  const json &hulls = data["convex hulls"];
+  int n_hulls = hulls.size();
+  std::vector<QuantizedHull> output;
+  output.reserve(n_hulls);
+  QuantizationReport R;
+  R.error_bound = quantizer.getResolution() * std::sqrt(2.) / 2;
+  double cell_area = quantizer.getResolution() * quantizer.getResolution();
+
+  std::vector<Point> vertices;
+  QuantizedHull::CoordinateVector xs, ys;
+  for (int n = 0; n < n_hulls; ++n) {
+    const json &apexes = hulls[n]["apexes"];
+    int n_apexes = apexes.size();
+    if (n_apexes < 3)
+      throw std::invalid_argument("convex hull " + std::to_string(n) +
+                                  " has fewer than 3 apexes");
+    vertices.clear();
+    xs.clear();
+    ys.clear();
+    for (int a = 0; a < n_apexes; ++a) {
+      double x = apexes[a]["x"], y = apexes[a]["y"];
+      if (!std::isfinite(x) || !std::isfinite(y))
+        throw std::invalid_argument("convex hull " + std::to_string(n) +
+                                    " has a non-finite apex");
+      bool clamped_x, clamped_y;
+      xs.push_back(quantizer.quantize(x, quantizer.getOriginX(), &clamped_x));
+      ys.push_back(quantizer.quantize(y, quantizer.getOriginY(), &clamped_y));
+      vertices.push_back(Point(x, y));
+
+      double dx = quantizer.dequantize(xs.back(), quantizer.getOriginX()) - x;
+      double dy = quantizer.dequantize(ys.back(), quantizer.getOriginY()) - y;
+      double error = std::sqrt(dx * dx + dy * dy);
+      R.max_error = std::max(R.max_error, error);
+      R.sum_error += error;
+      R.n_clamped += clamped_x || clamped_y;
+    }
+    R.n_vertices += n_apexes;
+
+    output.emplace_back(xs.data(), ys.data(), n_apexes, hulls[n]["ID"]);
+    double area = polygonArea(vertices);
+    if (area > 0) {
+      double area_error =
+          std::abs(output.back().getArea() * cell_area - area) / area;
+      R.max_area_error = std::max(R.max_area_error, area_error);
+    }
+  }
+  if (report != nullptr) *report = R;
+  return output;
+}
+
+ConvexHull dequantize(const QuantizedHull &hull, const Quantizer &quantizer) {
+  ConvexHull::ApexVector apexes;
+  apexes.reserve(hull.getNvertices());
+  for (int i = 0; i < hull.getNvertices(); ++i) {
+    apexes.push_back(
+        Point(quantizer.dequantize(hull.xs[i], quantizer.getOriginX()),
+              quantizer.dequantize(hull.ys[i], quantizer.getOriginY())));
+  }
+  return ConvexHull(apexes.data(), apexes.size(), hull.id);
+}
+
+double intersectionArea(const QuantizedHull &C1, const QuantizedHull &C2) {
+  const int32_t *x1 = C1.xs.data(), *y1 = C1.ys.data();
+  const int32_t *x2 = C2.xs.data(), *y2 = C2.ys.data();
+  int n1 = C1.getNvertices(), n2 = C2.getNvertices();
+
+  // Same vertices as getIntersectionPolygonVertices: contained apexes and
+  // edge crossings
+  SmallVector<Point, 4 * kInlineApexes> vertices;
+  for (int i = 0; i < n1; ++i) {
+    if (C2.isPointInside(x1[i], y1[i])) vertices.push_back(Point(x1[i], y1[i]));
+  }
+  for (int i = 0; i < n2; ++i) {
+    if (C1.isPointInside(x2[i], y2[i])) vertices.push_back(Point(x2[i], y2[i]));
+  }
+  for (int i = 0; i < n1; ++i) {
+    int i_next = i + 1 == n1 ? 0 : i + 1;
+    int64_t ax1 = x1[i], ay1 = y1[i], ax2 = x1[i_next], ay2 = y1[i_next];
+    for (int j = 0; j < n2; ++j) {
+      int j_next = j + 1 == n2 ? 0 : j + 1;
+      int64_t bx1 = x2[j], by1 = y2[j], bx2 = x2[j_next], by2 = y2[j_next];
+      if (std::max(ax1, ax2) < std::min(bx1, bx2) ||
+          std::max(bx1, bx2) < std::min(ax1, ax2) ||
+          std::max(ay1, ay2) < std::min(by1, by2) ||
+          std::max(by1, by2) < std::min(ay1, ay2))
+        continue;
+      int64_t a1_side = orient(bx1, by1, bx2, by2, ax1, ay1);
+      int64_t a2_side = orient(bx1, by1, bx2, by2, ax2, ay2);
+      if ((a1_side > 0 && a2_side > 0) || (a1_side < 0 && a2_side < 0))
+        continue;
+      int64_t b1_side = orient(ax1, ay1, ax2, ay2, bx1, by1);
+      int64_t b2_side = orient(ax1, ay1, ax2, ay2, bx2, by2);
+      if ((b1_side > 0 && b2_side > 0) || (b1_side < 0 && b2_side < 0))
+        continue;
+      if (a1_side == 0 && a2_side == 0) continue;  // collinear
+      double t = static_cast<double>(a1_side) /
+                 (static_cast<double>(a1_side) - static_cast<double>(a2_side));
+      vertices.push_back(
+          Point(ax1 + t * (ax2 - ax1), ay1 + t * (ay2 - ay1)));
+    }
+  }
+  CH_STATS_COUNT(kIntersectionVertices, vertices.size());
+  if (vertices.size() < 3) return 0;
+
+  // Sort CCW around the centroid, then shoelace
+  double cx = 0, cy = 0;
+  for (const Point &p : vertices) {
+    cx += p.x;
+    cy += p.y;
+  }
+  cx /= vertices.size();
+  cy /= vertices.size();
+  for (Point &p : vertices) p.set_angle(std::atan2(p.y - cy, p.x - cx));
+  std::sort(vertices.begin(), vertices.end());
+
+  int n = vertices.size();
+  double sum = 0;
+  for (int i = 0; i < n; ++i) {
+    const Point &p = vertices[i], &q = vertices[i + 1 == n ? 0 : i + 1];
+    sum += (p.x - cx) * (q.y - cy) - (q.x - cx) * (p.y - cy);
+  }
+  return std::abs(sum) / 2;
+}
+
+BoundingBox hullBounds(const QuantizedHull &hull) {
+  const int32_t *x = hull.xs.data(), *y = hull.ys.data();
+  int n = hull.getNvertices();
+  int32_t min_x = x[0], min_y = y[0], max_x = x[0], max_y = y[0];
+  for (int i = 1; i < n; ++i) {
+    min_x = std::min(min_x, x[i]);
+    max_x = std::max(max_x, x[i]);
+    min_y = std::min(min_y, y[i]);
+    max_y = std::max(max_y, y[i]);
+  }
+  return BoundingBox(min_x, min_y, max_x, max_y);
+}
+
+std::vector<QuantizedHull> eliminateOverlappingCHulls(
+    std::vector<QuantizedHull> *input, double overlapping_percent) {
+  CH_TRACE_SPAN("eliminateOverlappingCHulls quantized", input->size());
+  return eliminateOverlappingCHullsWith(input, overlapping_percent,
+                                        QuantizedIntersectionBackend());
+}
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <limits>
+#include <shape_descriptors.hpp>
+
+template <typename T>
+HullDescriptorsT<T> computeHullDescriptors(const PointT<T> *apex,
+                                           int n_apexes) {
+  HullDescriptorsT<T> descriptors;
+  int n = n_apexes;
+  if (n == 0) return descriptors;
+  // Coordinates relative to the first vertex, which keeps the precision of
+  // far away (e.g. float) hulls
+  const T ox = apex[0].x, oy = apex[0].y;
+
+  // Signed area and area centroid
+  T area2 = 0, cx = 0, cy = 0, mean_x = 0, mean_y = 0;
+  for (int k = 0; k < n; ++k) {
+    const PointT<T> &q = apex[k + 1 == n ? 0 : k + 1];
+    T x0 = apex[k].x - ox, y0 = apex[k].y - oy;
+    T x1 = q.x - ox, y1 = q.y - oy;
+    T cross = x0 * y1 - x1 * y0;
+    area2 += cross;
+    cx += (x0 + x1) * cross;
+    cy += (y0 + y1) * cross;
+    mean_x += x0;
+    mean_y += y0;
+  }
+  if (area2 != 0) {
+    descriptors.centroid.x = ox + cx / (3 * area2);
+    descriptors.centroid.y = oy + cy / (3 * area2);
+  } else {  // Degenerate polygon: mean of the vertices
+    descriptors.centroid.x = ox + mean_x / n;
+    descriptors.centroid.y = oy + mean_y / n;
+  }
+  descriptors.rect_center = descriptors.centroid;
+
+  // Rotating calipers, always walking the polygon CCW
+  bool ccw = area2 >= 0;
+  auto at = [&](int k) -> const PointT<T> & {
+    return ccw ? apex[k] : apex[n - 1 - k];
+  };
+  auto next = [n](int k) { return k + 1 == n ? 0 : k + 1; };
+  auto distance2 = [&](int a, int b) {
+    T dx = at(a).x - at(b).x, dy = at(a).y - at(b).y;
+    return dx * dx + dy * dy;
+  };
+  // Advances k while the next vertex is not worse. The steps are capped for
+  // degenerate (collinear) polygons, where every vertex ties.
+  auto advance = [&](int k, auto not_worse) {
+    for (int steps = 0; steps < n && not_worse(next(k), k); ++steps)
+      k = next(k);
+    return k;
+  };
+
+  T diameter2 = 0;
+  T min_width = std::numeric_limits<T>::infinity();
+  T min_rect_area = std::numeric_limits<T>::infinity();
+  int r = -1, j = -1, l = -1;  // furthest along, antipodal, furthest behind
+  for (int i = 0; i < n; ++i) {
+    int i2 = next(i);
+    T ex = at(i2).x - at(i).x, ey = at(i2).y - at(i).y;
+    T length = std::sqrt(ex * ex + ey * ey);
+    if (length == 0) continue;
+    T ux = ex / length, uy = ey / length;
+    // Position along the edge direction and height over the edge line
+    auto along = [&](int k) {
+      return ux * (at(k).x - ox) + uy * (at(k).y - oy);
+    };
+    auto height = [&](int k) {
+      return ux * (at(k).y - at(i).y) - uy * (at(k).x - at(i).x);
+    };
+    if (r < 0) r = i2;
+    r = advance(r, [&](int a, int b) { return along(a) >= along(b); });
+    if (j < 0) j = r;
+    j = advance(j, [&](int a, int b) { return height(a) >= height(b); });
+    if (l < 0) l = j;
+    l = advance(l, [&](int a, int b) { return along(a) <= along(b); });
+
+    // Every antipodal vertex pair contains an edge endpoint and a vertex at
+    // the largest height over that edge (j, or the vertex before it on a
+    // side parallel to the edge)
+    int j_prev = j == 0 ? n - 1 : j - 1;
+    diameter2 = std::max({diameter2, distance2(i, j), distance2(i2, j)});
+    if (height(j_prev) == height(j))
+      diameter2 =
+          std::max({diameter2, distance2(i, j_prev), distance2(i2, j_prev)});
+
+    T width = along(r) - along(l), h = height(j);
+    min_width = std::min(min_width, h);
+    if (width * h < min_rect_area) {
+      min_rect_area = width * h;
+      // Center: midway along the edge direction, half the height inwards
+      T s = (along(r) + along(l)) / 2;
+      T t = ux * (at(i).y - oy) - uy * (at(i).x - ox) + h / 2;
+      descriptors.rect_center.x = ox + s * ux - t * uy;
+      descriptors.rect_center.y = oy + s * uy + t * ux;
+      descriptors.rect_half_x = width / 2;
+      descriptors.rect_half_y = h / 2;
+      descriptors.rect_yaw = std::atan2(uy, ux);
+    }
+  }
+  descriptors.diameter = std::sqrt(diameter2);
+  descriptors.min_width = r < 0 ? 0 : min_width;
+  return descriptors;
+}
+
+#define INSTANTIATE_SHAPE_DESCRIPTORS(T)                 \
+  template HullDescriptorsT<T> computeHullDescriptors<T>( \
+      const PointT<T> *, int);
+
+INSTANTIATE_SHAPE_DESCRIPTORS(float)
+INSTANTIATE_SHAPE_DESCRIPTORS(double)
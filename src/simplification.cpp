@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <limits>
+#include <predicates.hpp>
+#include <simplification.hpp>
+#include <spatial_index.hpp>
+#include <stdexcept>
+#include <trace.hpp>
+
+namespace {
+template <typename T>
+T pointSegmentDistance(const PointT<T> &P, const PointT<T> &a,
+                       const PointT<T> &b) {
+  T ex = b.x - a.x, ey = b.y - a.y;
+  T length2 = ex * ex + ey * ey;
+  T t = length2 > 0 ? ((P.x - a.x) * ex + (P.y - a.y) * ey) / length2 : 0;
+  t = std::max(T(0), std::min(T(1), t));
+  return std::hypot(a.x + t * ex - P.x, a.y + t * ey - P.y);
+}
+
+/**
+ * Inner mode: the vertices kept, as indices. The error of a chord (a, b) is
+ * the largest distance from a vertex strictly between a and b to it; it
+ * grows with b, so every run is extended until the bound is exceeded.
+ */
+template <typename T>
+T keepVertices(const PointT<T> *v, int n, T max_error, std::vector<int> *kept) {
+  auto chord_error = [&](int a, int b) {
+    T error = 0;
+    for (int k = a + 1; k < b && error <= max_error; ++k)
+      error = std::max(error, pointSegmentDistance(v[k], v[a], v[b % n]));
+    return error;
+  };
+  T error = 0;
+  kept->assign(1, 0);
+  for (int a = 0; a < n;) {
+    int b = a + 1;
+    T run_error = 0;
+    while (b < n) {
+      T next_error = chord_error(a, b + 1);
+      if (next_error > max_error) break;
+      run_error = next_error;
+      ++b;
+    }
+    error = std::max(error, run_error);
+    if (b < n) kept->push_back(b);
+    a = b;
+  }
+  return error;
+}
+
+/**
+ * Outer mode: the edges kept (edge k goes from v[k] to v[k + 1]), as
+ * indices, and the vertex closing every kept edge. Dropping the edges
+ * between a and b moves the vertex to the crossing of the lines of a and b,
+ * which have to converge ahead of a. Its distance to the removed part of the
+ * boundary grows with b.
+ */
+template <typename T>
+T keepEdges(const PointT<T> *v, int n, T max_error, T orientation,
+            std::vector<PointT<T>> *vertices) {
+  auto apex_error = [&](int a, int b, PointT<T> *apex) {
+    const PointT<T> &pa = v[a], &pb = v[b % n];
+    const PointT<T> &qa = v[(a + 1) % n], &qb = v[(b + 1) % n];
+    T dax = qa.x - pa.x, day = qa.y - pa.y;
+    T dbx = qb.x - pb.x, dby = qb.y - pb.y;
+    T denominator = dax * dby - day * dbx;
+    if (denominator * orientation <= 0)
+      return std::numeric_limits<T>::infinity();
+    T t = ((pb.x - pa.x) * dby - (pb.y - pa.y) * dbx) / denominator;
+    T s = ((pb.x - pa.x) * day - (pb.y - pa.y) * dax) / denominator;
+    // The crossing has to be past the end of a and before the start of b
+    if (t < 1 || s > 0) return std::numeric_limits<T>::infinity();
+    apex->x = pa.x + t * dax;
+    apex->y = pa.y + t * day;
+    T error = std::numeric_limits<T>::infinity();
+    for (int k = a + 1; k < b; ++k) {
+      const PointT<T> &next = v[k + 1 == n ? 0 : k + 1];
+      error = std::min(error, pointSegmentDistance(*apex, v[k], next));
+    }
+    return error;
+  };
+  T error = 0;
+  vertices->clear();
+  for (int a = 0; a < n;) {
+    int b = a + 1;
+    T run_error = 0;
+    PointT<T> vertex = v[b % n], apex;
+    while (b < n) {
+      T next_error = apex_error(a, b + 1, &apex);
+      if (next_error > max_error) break;
+      run_error = next_error;
+      vertex = apex;
+      ++b;
+    }
+    error = std::max(error, run_error);
+    vertices->push_back(vertex);
+    a = b;
+  }
+  // The vertex closing the last edge is the first one of the polygon
+  std::rotate(vertices->begin(), vertices->end() - 1, vertices->end());
+  return error;
+}
+}  // namespace
+
+SimplificationMode simplificationModeFromName(const std::string &name) {
+  if (name == "inner") return kSimplifyInner;
+  if (name == "outer") return kSimplifyOuter;
+  throw std::invalid_argument("unknown simplification mode " + name +
+                              ", expected outer or inner");
+}
+
+template <typename T>
+ConvexHullT<T> simplifyConvexHull(const ConvexHullT<T> &hull,
+                                  const SimplificationOptions &options,
+                                  T *error) {
+  const PointT<T> *v = hull.apex.data();
+  int n = hull.apex.size();
+  T max_error = options.max_error, reached = 0;
+  // The walks start from the lowest (x, y) vertex, an extreme point that any
+  // simplification keeps. In outer mode the vertices between collinear
+  // edges, whose lines never cross, are dropped first (exactly, with
+  // orient2d).
+  std::vector<PointT<T>> ring;
+  ring.reserve(n);
+  T area2 = 0;
+  int start = 0;
+  for (int k = 0; k < n; ++k) {
+    const PointT<T> &p = v[k == 0 ? n - 1 : k - 1];
+    const PointT<T> &q = v[k + 1 == n ? 0 : k + 1];
+    area2 += (v[k].x - v[0].x) * (q.y - v[0].y) -
+             (q.x - v[0].x) * (v[k].y - v[0].y);
+    if (options.mode == kSimplifyOuter &&
+        predicates::orient2d(p, v[k], q) == 0)
+      continue;
+    if (!ring.empty() &&
+        (v[k].x < ring[start].x ||
+         (v[k].x == ring[start].x && v[k].y < ring[start].y)))
+      start = ring.size();
+    ring.push_back(v[k]);
+  }
+  std::rotate(ring.begin(), ring.begin() + start, ring.end());
+
+  std::vector<PointT<T>> vertices;
+  if (ring.size() < 3) {
+    // Every vertex is collinear
+  } else if (options.mode == kSimplifyInner) {
+    std::vector<int> kept;
+    reached = keepVertices(ring.data(), ring.size(), max_error, &kept);
+    for (int k : kept) vertices.push_back(ring[k]);
+  } else {
+    reached = keepEdges(ring.data(), ring.size(), max_error,
+                        area2 >= 0 ? T(1) : T(-1), &vertices);
+  }
+  // Only for hulls thinner than about twice the bound
+  if (vertices.size() < 3) {
+    if (error != nullptr) *error = 0;
+    return hull;
+  }
+  if (error != nullptr) *error = reached;
+  ConvexHullT<T> simplified(vertices, hull.id);
+  return simplified;
+}
+
+void simplifyConvexHulls(std::vector<ConvexHull> *hulls,
+                         const SimplificationOptions &options,
+                         SimplificationReport *report) {
+  CH_TRACE_SPAN("simplifyConvexHulls", hulls->size());
+  SimplificationReport local;
+  local.error_bound = options.max_error;
+  double largest_changes[2] = {0., 0.};
+  for (ConvexHull &hull : *hulls) {
+    ++local.n_hulls;
+    local.n_vertices_before += hull.apex.size();
+    if (hull.apex.size() > options.min_vertices) {
+      double error;
+      ConvexHull simplified = simplifyConvexHull(hull, options, &error);
+      if (simplified.apex.size() < hull.apex.size()) {
+        ++local.n_simplified;
+        local.max_error = std::max(local.max_error, error);
+        double change = std::abs(simplified.getArea() - hull.getArea());
+        local.max_area_change = std::max(local.max_area_change, change);
+        if (change > largest_changes[1]) {
+          largest_changes[1] = change;
+          if (largest_changes[1] > largest_changes[0])
+            std::swap(largest_changes[0], largest_changes[1]);
+        }
+        hull = std::move(simplified);
+      }
+    }
+    local.n_vertices_after += hull.apex.size();
+  }
+  local.overlap_area_error_bound = largest_changes[0] + largest_changes[1];
+  if (report != nullptr) *report = local;
+}
+
+std::vector<ConvexHull> convexHullsFromJson(
+    const json &data, const SimplificationOptions &options,
+    SimplificationReport *report) {
+  std::vector<ConvexHull> hulls = convexHullsFromJson(data);
+  simplifyConvexHulls(&hulls, options, report);
+  return hulls;
+}
+
+double overlapAreaError(std::vector<ConvexHull> *original,
+                        std::vector<ConvexHull> *simplified,
+                        double cell_size) {
+  CH_TRACE_SPAN("overlapAreaError", original->size());
+  int n_hulls = original->size();
+  assert(simplified->size() == n_hulls);
+  // Boxes of both versions, so pairs that overlap in either are candidates
+  SpatialHashGrid grid(cell_size);
+  std::vector<BoundingBox> boxes;
+  boxes.reserve(n_hulls);
+  for (int i = 0; i < n_hulls; ++i) {
+    BoundingBox a = computeBoundingBox(original->at(i).apex);
+    BoundingBox b = computeBoundingBox(simplified->at(i).apex);
+    boxes.push_back(BoundingBox(
+        std::min(a.min_x, b.min_x), std::min(a.min_y, b.min_y),
+        std::max(a.max_x, b.max_x), std::max(a.max_y, b.max_y)));
+    grid.insert(boxes.back());
+  }
+  double error = 0.;
+  std::vector<int> found;
+  for (int i = 0; i < n_hulls; ++i) {
+    grid.query(boxes[i], &found);
+    for (int j : found) {
+      if (j <= i) continue;
+      double before = intersectionArea(&original->at(i), &original->at(j));
+      double after = intersectionArea(&simplified->at(i), &simplified->at(j));
+      error = std::max(error, std::abs(after - before));
+    }
+  }
+  return error;
+}
+
+#define INSTANTIATE_SIMPLIFICATION(T)                                \
+  template ConvexHullT<T> simplifyConvexHull<T>(                     \
+      const ConvexHullT<T> &, const SimplificationOptions &, T *);
+
+INSTANTIATE_SIMPLIFICATION(float)
+INSTANTIATE_SIMPLIFICATION(double)
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include <spatial_index.hpp>
+
+SpatialHashGrid::SpatialHashGrid(double cell_size)
+    : cell_size_(cell_size), query_stamp_(0) {
+  assert(cell_size_ > 0);
+}
+
+int64_t SpatialHashGrid::cellCoordinate(double v) const {
+  // Clamped, so the conversion is defined for far coordinates: boxes beyond
+  // the limit share the border cells, which is still correct
+  const double kMaxCellCoordinate = 1e15;
+  double c = std::floor(v / cell_size_);
+  c = std::max(-kMaxCellCoordinate, std::min(kMaxCellCoordinate, c));
+  return static_cast<int64_t>(c);
+}
+
+uint64_t SpatialHashGrid::cellKey(int64_t cx, int64_t cy) const {
+  // Both coordinates are folded in 32 bits, collisions only cost extra
+  // candidates that are filtered by the box test.
+  return (static_cast<uint64_t>(cx) << 32) ^
+         (static_cast<uint64_t>(cy) & 0xffffffff);
+}
+
+bool SpatialHashGrid::cellRange(const BoundingBox &box,
+                                int64_t range[4]) const {
+  if (!std::isfinite(box.min_x) || !std::isfinite(box.max_x) ||
+      !std::isfinite(box.min_y) || !std::isfinite(box.max_y))
+    return false;
+  range[0] = cellCoordinate(box.min_x);
+  range[1] = cellCoordinate(box.max_x);
+  range[2] = cellCoordinate(box.min_y);
+  range[3] = cellCoordinate(box.max_y);
+  int64_t nx = range[1] - range[0] + 1, ny = range[3] - range[2] + 1;
+  // Each side is checked first so the product can not overflow
+  return nx <= kMaxCellsPerBox && ny <= kMaxCellsPerBox &&
+         nx * ny <= kMaxCellsPerBox;
+}
+
+int SpatialHashGrid::insert(const BoundingBox &box) {
+  int id = boxes_.size();
+  boxes_.push_back(box);
+  visited_.push_back(0);
+
+  int64_t range[4];
+  if (!cellRange(box, range)) {
+    oversized_.push_back(id);
+    return id;
+  }
+  for (int64_t cx = range[0]; cx <= range[1]; ++cx) {
+    for (int64_t cy = range[2]; cy <= range[3]; ++cy) {
+      cells_[cellKey(cx, cy)].push_back(id);
+    }
+  }
+  return id;
+}
+
+void SpatialHashGrid::query(const BoundingBox &box,
+                            std::vector<int> *candidates) {
+  candidates->clear();
+  int64_t range[4];
+  if (!cellRange(box, range)) {
+    // Walking the cells would cost more than testing every element
+    for (int id = 0; id < boxes_.size(); ++id) {
+      if (boxes_[id].overlaps(box)) candidates->push_back(id);
+    }
+    return;
+  }
+  if (++query_stamp_ == 0) {  // stamp wrapped around, reset the marks
+    std::fill(visited_.begin(), visited_.end(), 0);
+    query_stamp_ = 1;
+  }
+
+  for (int64_t cx = range[0]; cx <= range[1]; ++cx) {
+    for (int64_t cy = range[2]; cy <= range[3]; ++cy) {
+      auto cell = cells_.find(cellKey(cx, cy));
+      if (cell == cells_.end()) continue;
+      for (int id : cell->second) {
+        if (visited_[id] == query_stamp_) continue;
+        visited_[id] = query_stamp_;
+        if (boxes_[id].overlaps(box)) candidates->push_back(id);
+      }
+    }
+  }
+  for (int id : oversized_) {
+    if (boxes_[id].overlaps(box)) candidates->push_back(id);
+  }
+  std::sort(candidates->begin(), candidates->end());
+}
+
+void SpatialHashGrid::clear() {
+  cells_.clear();
+  oversized_.clear();
+  boxes_.clear();
+  visited_.clear();
+  query_stamp_ = 0;
+}
@@ -0,0 +1,100 @@
+#include <spatial_index.hpp>
+#include <temporal_eliminator.hpp>
+
+TemporalEliminator::TemporalEliminator(double overlapping_percent,
+                                       double tolerance)
+    : overlapping_percent_(overlapping_percent), tolerance_(tolerance) {}
+
+void TemporalEliminator::reset() {
+  reference_apexes_.clear();
+  pair_cache_.clear();
+  stats_ = FrameStats();
+}
+
+uint64_t TemporalEliminator::pairKey(int id_a, int id_b) {
+  if (id_a > id_b) std::swap(id_a, id_b);
+  return (static_cast<uint64_t>(static_cast<uint32_t>(id_a)) << 32) |
+         static_cast<uint32_t>(id_b);
+}
+
+bool TemporalEliminator::isDirty(const ConvexHull &hull) const {
+  auto reference = reference_apexes_.find(hull.id);
+  if (reference == reference_apexes_.end()) return true;
+  const std::vector<Point> &previous = reference->second;
+  if (previous.size() != hull.apex.size()) return true;
+
+  double tolerance_2 = tolerance_ * tolerance_;
+  for (int i = 0; i < previous.size(); ++i) {
+    double dx = hull.apex[i].x - previous[i].x;
+    double dy = hull.apex[i].y - previous[i].y;
+    if (dx * dx + dy * dy > tolerance_2) return true;
+  }
+  return false;
+}
+
+std::vector<ConvexHull> TemporalEliminator::processFrame(
+    std::vector<ConvexHull> *frame) {
+  stats_ = FrameStats();
+  int n_hulls = frame->size();
+
+  std::vector<bool> dirty(n_hulls);
+  std::vector<BoundingBox> boxes;
+  boxes.reserve(n_hulls);
+  for (int i = 0; i < n_hulls; ++i) {
+    dirty[i] = isDirty(frame->at(i));
+    if (dirty[i]) ++stats_.n_dirty_hulls;
+    boxes.push_back(computeBoundingBox(frame->at(i).apex));
+  }
+
+  // Results of this frame, pairs that disappeared are dropped from the cache
+  std::unordered_map<uint64_t, PairResult> frame_cache;
+  std::vector<bool> remaining_convex_hulls(n_hulls, true);
+  for (int i = 0; i < n_hulls; ++i) {
+    ConvexHull &C1 = frame->at(i);
+    for (int j = i + 1; j < n_hulls; ++j) {
+      if (!boxes[i].overlaps(boxes[j])) continue;
+      ConvexHull &C2 = frame->at(j);
+      ++stats_.n_pairs;
+
+      uint64_t key = pairKey(C1.id, C2.id);
+      PairResult result;
+      auto cached = pair_cache_.find(key);
+      if (!dirty[i] && !dirty[j] && cached != pair_cache_.end()) {
+        result = cached->second;
+        ++stats_.n_cache_hits;
+      } else {
+        result.area = intersectionArea(&C1, &C2);
+        result.intersect = result.area > 0;
+        ++stats_.n_recomputed;
+      }
+      frame_cache[key] = result;
+
+      if (result.intersect) {
+        if (result.area > overlapping_percent_ * C1.getArea())
+          remaining_convex_hulls[i] = false;
+        if (result.area > overlapping_percent_ * C2.getArea())
+          remaining_convex_hulls[j] = false;
+      }
+    }
+  }
+  pair_cache_.swap(frame_cache);
+
+  // Only the dirty hulls get a new reference, so clean hulls can not drift
+  // away more than the tolerance from the vertices their results come from
+  std::unordered_map<int, std::vector<Point>> references;
+  for (int i = 0; i < n_hulls; ++i) {
+    const ConvexHull &c = frame->at(i);
+    if (dirty[i])
+      references[c.id].assign(c.apex.begin(), c.apex.end());
+    else
+      references[c.id] = std::move(reference_apexes_[c.id]);
+  }
+  reference_apexes_.swap(references);
+
+  std::vector<ConvexHull> output;
+  output.reserve(n_hulls);
+  for (int i = 0; i < n_hulls; ++i) {
+    if (remaining_convex_hulls[i]) output.push_back(frame->at(i));
+  }
+  return output;
+}
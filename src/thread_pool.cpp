@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread_pool.hpp>
+#include <trace.hpp>
+
+ThreadPool::ThreadPool(int n_threads) : stop_(false) {
+  if (n_threads <= 0)
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  workers_.reserve(n_threads);
+  for (int i = 0; i < n_threads; ++i)
+    workers_.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  task_available_.notify_all();
+  for (std::thread &worker : workers_) worker.join();
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      // Queued tasks are still run when the pool is destroyed
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+  // packaged_task is move only, std::function needs a copyable callable
+  auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+  std::future<void> result = packaged->get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back([packaged] { (*packaged)(); });
+  }
+  task_available_.notify_one();
+  return result;
+}
+
+void ThreadPool::parallelFor(int n, int grain,
+                             const std::function<void(int, int)> &body) {
+  if (n <= 0) return;
+  grain = std::max(grain, 1);
+
+  // Shared with the helper tasks, which may only start running after every
+  // chunk is done (e.g. when all the workers are busy in a nested
+  // parallelFor). Such late helpers find no chunk left and never touch body.
+  struct State {
+    std::atomic<int> next_chunk, n_done;
+    int n, grain, n_chunks;
+    const std::function<void(int, int)> *body;
+    std::mutex mutex;
+    std::condition_variable all_done;
+  };
+  auto state = std::make_shared<State>();
+  state->next_chunk = 0;
+  state->n_done = 0;
+  state->n = n;
+  state->grain = grain;
+  state->n_chunks = (n + grain - 1) / grain;
+  state->body = &body;
+
+  auto run_chunks = [](State *S) {
+    for (int c = S->next_chunk++; c < S->n_chunks; c = S->next_chunk++) {
+      int begin = c * S->grain, end = std::min(S->n, begin + S->grain);
+      {
+        CH_TRACE_SPAN("parallelFor chunk", begin, end);
+        (*S->body)(begin, end);
+      }
+      if (++S->n_done == S->n_chunks) {
+        std::lock_guard<std::mutex> lock(S->mutex);
+        S->all_done.notify_all();
+      }
+    }
+  };
+
+  int n_helpers = std::min<int>(workers_.size(), state->n_chunks - 1);
+  for (int i = 0; i < n_helpers; ++i)
+    submit([state, run_chunks] { run_chunks(state.get()); });
+  run_chunks(state.get());
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->all_done.wait(lock,
+                       [&] { return state->n_done == state->n_chunks; });
+}
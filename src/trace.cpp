@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <trace.hpp>
+#include <vector>
+
+namespace trace {
+
+std::atomic<bool> enabled(false);
+
+namespace {
+struct ThreadBuffer {
+  int tid;
+  std::atomic<uint64_t> head;  // number of events ever written
+  TraceEvent events[kRingCapacity];
+  explicit ThreadBuffer(int tid_) : tid(tid_), head(0) {}
+};
+
+struct FinishedEvent {
+  int tid;
+  TraceEvent event;
+};
+
+// Buffers of the live threads. The mutex is only taken when a thread records
+// its first span, when it exits and when dumping.
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+int next_tid = 0;
+// Spans of the threads that exited, a single ring shared by all of them, so
+// threads that come and go (e.g. server connections) do not add up memory
+std::vector<FinishedEvent> finished;
+uint64_t finished_head = 0;
+
+const std::chrono::steady_clock::time_point epoch =
+    std::chrono::steady_clock::now();
+
+// Range of events [begin, head) still held by a ring of the given capacity
+uint64_t ringBegin(uint64_t head, uint64_t capacity) {
+  return head > capacity ? head - capacity : 0;
+}
+
+// Moves the spans of an exiting thread to the shared ring and frees its
+// buffer
+void retire(ThreadBuffer *buffer) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  if (head > 0 && finished.empty()) finished.resize(kRingCapacity);
+  for (uint64_t e = ringBegin(head, kRingCapacity); e < head; ++e) {
+    FinishedEvent &slot = finished[finished_head++ % kRingCapacity];
+    slot.tid = buffer->tid;
+    slot.event = buffer->events[e % kRingCapacity];
+  }
+  registry.erase(std::find_if(registry.begin(), registry.end(),
+                              [buffer](const std::unique_ptr<ThreadBuffer> &b) {
+                                return b.get() == buffer;
+                              }));
+}
+
+// Retires the buffer of its thread when the thread exits
+struct ThreadBufferOwner {
+  ThreadBuffer *buffer = nullptr;
+  ~ThreadBufferOwner() {
+    if (buffer != nullptr) retire(buffer);
+  }
+};
+
+ThreadBuffer *threadBuffer() {
+  thread_local ThreadBufferOwner owner;
+  if (owner.buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.emplace_back(new ThreadBuffer(next_tid++));
+    owner.buffer = registry.back().get();
+  }
+  return owner.buffer;
+}
+
+void writeEvent(std::ostream &stream, int tid, const TraceEvent &event) {
+  stream << ",\n{\"name\":\"" << event.name
+         << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+         << ",\"ts\":" << event.start_ns * 1e-3
+         << ",\"dur\":" << event.duration_ns * 1e-3;
+  if (event.arg0 != kNoArg) {
+    stream << ",\"args\":{\"a\":" << event.arg0;
+    if (event.arg1 != kNoArg) stream << ",\"b\":" << event.arg1;
+    stream << "}";
+  }
+  stream << "}";
+}
+
+void writeThreadName(std::ostream &stream, int tid, bool first) {
+  stream << (first ? "\n" : ",\n")
+         << "{\"name\":\"thread_name\",\"ph\":\"M\","
+         << "\"pid\":1,\"tid\":" << tid
+         << ",\"args\":{\"name\":\"thread " << tid << "\"}}";
+}
+}  // namespace
+
+void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+
+uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+void record(const TraceEvent &event) {
+  ThreadBuffer *buffer = threadBuffer();
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  buffer->events[head % kRingCapacity] = event;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+int writeChromeTrace(std::ostream &stream) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  std::ios::fmtflags flags(stream.flags());
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  int n_events = 0;
+  bool first = true;
+  for (const auto &buffer : registry) {
+    writeThreadName(stream, buffer->tid, first);
+    first = false;
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    for (uint64_t e = ringBegin(head, kRingCapacity); e < head; ++e) {
+      writeEvent(stream, buffer->tid, buffer->events[e % kRingCapacity]);
+      ++n_events;
+    }
+  }
+
+  uint64_t begin = ringBegin(finished_head, kRingCapacity);
+  std::vector<int> finished_tids;
+  for (uint64_t e = begin; e < finished_head; ++e)
+    finished_tids.push_back(finished[e % kRingCapacity].tid);
+  std::sort(finished_tids.begin(), finished_tids.end());
+  finished_tids.erase(std::unique(finished_tids.begin(), finished_tids.end()),
+                      finished_tids.end());
+  for (int tid : finished_tids) {
+    writeThreadName(stream, tid, first);
+    first = false;
+  }
+  for (uint64_t e = begin; e < finished_head; ++e) {
+    const FinishedEvent &event = finished[e % kRingCapacity];
+    writeEvent(stream, event.tid, event.event);
+    ++n_events;
+  }
+  stream << "\n]}\n";
+  stream.flags(flags);
+  return n_events;
+}
+
+void clear() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (const auto &buffer : registry)
+    buffer->head.store(0, std::memory_order_relaxed);
+  finished_head = 0;
+}
+
+int getNThreadBuffers() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  return registry.size();
+}
+
+}  // namespace trace
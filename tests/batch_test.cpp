@@ -0,0 +1,109 @@
+#include "batch.hpp"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "convex_hull.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+const int kNFrames = 12;
+
+// Fresh temporary directory with a few frame files
+class BatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/batch_test_XXXXXX";
+    ASSERT_NE(mkdtemp(path), nullptr);
+    dir_ = path;
+    ASSERT_EQ(system(("mkdir " + dir_ + "/in " + dir_ + "/out").c_str()), 0);
+    for (int n = 0; n < kNFrames; ++n) {
+      std::vector<ConvexHull> hulls = randomHulls(40, n, 20.);
+      std::ofstream file(framePath(n));
+      file << convexHullsToJson(hulls);
+    }
+  }
+  void TearDown() override {
+    EXPECT_EQ(system(("rm -r " + dir_).c_str()), 0);
+  }
+
+  std::string framePath(int n) const {
+    return dir_ + "/in/frame_" + std::to_string(n) + ".json";
+  }
+
+  static json eliminate(const json &data) {
+    std::vector<ConvexHull> hulls = convexHullsFromJson(data);
+    return convexHullsToJson(eliminateOverlappingCHulls(&hulls, 0.5));
+  }
+
+  std::string dir_;
+};
+}  // namespace
+
+TEST_F(BatchTest, ExpandInputs) {
+  std::vector<std::string> files = expandInputs({dir_ + "/in/frame_1*.json"});
+  EXPECT_EQ(files, std::vector<std::string>({framePath(1), framePath(10),
+                                             framePath(11)}));
+
+  // List file, and a pattern without matches kept as it is
+  std::string list = dir_ + "/list.txt";
+  {
+    std::ofstream file(list);
+    file << framePath(3) << "\n\n" << dir_ << "/in/frame_2.json\n";
+  }
+  files = expandInputs({"@" + list, dir_ + "/missing_*.json"});
+  EXPECT_EQ(files, std::vector<std::string>({framePath(3), framePath(2),
+                                             dir_ + "/missing_*.json"}));
+}
+
+TEST(BatchOutputPathTest, KeepsTheFileName) {
+  EXPECT_EQ(batchOutputPath("a/b/frame.json", "out"), "out/frame.json");
+  EXPECT_EQ(batchOutputPath("frame.json", "out/"), "out/frame.json");
+  EXPECT_EQ(batchOutputPath("a/frame.json", ""), "frame.json");
+}
+
+TEST_F(BatchTest, OutputsMatchSequentialProcessing) {
+  std::vector<std::string> inputs = expandInputs({dir_ + "/in/*.json"});
+  ASSERT_EQ(inputs.size(), kNFrames);
+  ThreadPool pool(3);
+  // A small window, so files are waited for while others run
+  BatchResult result =
+      processBatch(inputs, dir_ + "/out", &BatchTest::eliminate, &pool, 2);
+  EXPECT_EQ(result.n_files, kNFrames);
+  EXPECT_EQ(result.n_failed, 0);
+
+  for (int n = 0; n < kNFrames; ++n) {
+    std::ifstream input(framePath(n));
+    std::ifstream output(dir_ + "/out/frame_" + std::to_string(n) + ".json");
+    ASSERT_TRUE(output.good());
+    EXPECT_EQ(json::parse(output), eliminate(json::parse(input)));
+  }
+}
+
+TEST_F(BatchTest, FailuresAreReportedAndTheRestIsProcessed) {
+  std::string malformed = dir_ + "/in/malformed.json";
+  {
+    std::ofstream file(malformed);
+    file << "{\"convex hulls\": [";
+  }
+  std::vector<std::string> inputs = {framePath(0), dir_ + "/in/missing.json",
+                                     malformed, framePath(1)};
+  ThreadPool pool(2);
+  BatchResult result =
+      processBatch(inputs, dir_ + "/out", &BatchTest::eliminate, &pool);
+  EXPECT_EQ(result.n_files, 4);
+  EXPECT_EQ(result.n_failed, 2);
+  ASSERT_EQ(result.errors.size(), 2);
+  EXPECT_EQ(result.errors[0].find(dir_ + "/in/missing.json: "), 0);
+  EXPECT_EQ(result.errors[1].find(malformed + ": "), 0);
+  EXPECT_TRUE(std::ifstream(dir_ + "/out/frame_0.json").good());
+  EXPECT_TRUE(std::ifstream(dir_ + "/out/frame_1.json").good());
+
+  // Unwritable output directory
+  result = processBatch({framePath(0)}, dir_ + "/no_such_dir",
+                        &BatchTest::eliminate, &pool);
+  EXPECT_EQ(result.n_failed, 1);
+}
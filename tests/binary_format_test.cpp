@@ -0,0 +1,57 @@
+#include "binary_format.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_hulls.hpp"
+
+TEST(BinaryFormatTest, RoundTrip) {
+  std::vector<ConvexHull> hulls = randomHulls(50, 3);
+  hulls.push_back(ConvexHull({Point(0, 0), Point(1, 0), Point(2, 1),
+                              Point(1, 2), Point(0, 1)},
+                             -7));
+  std::string bytes;
+  encodeHulls(hulls, &bytes);
+  EXPECT_EQ(bytes.size(), 8 + 50 * (8 + 4 * 16) + 8 + 5 * 16);
+
+  std::vector<ConvexHull> decoded;
+  ASSERT_TRUE(decodeHulls(bytes.data(), bytes.size(), &decoded));
+  ASSERT_EQ(decoded.size(), hulls.size());
+  for (int i = 0; i < hulls.size(); ++i) {
+    EXPECT_EQ(decoded[i].id, hulls[i].id);
+    ASSERT_EQ(decoded[i].apex.size(), hulls[i].apex.size());
+    for (int a = 0; a < hulls[i].apex.size(); ++a) {
+      EXPECT_EQ(decoded[i].apex[a].x, hulls[i].apex[a].x);
+      EXPECT_EQ(decoded[i].apex[a].y, hulls[i].apex[a].y);
+    }
+    EXPECT_EQ(decoded[i].getArea(), hulls[i].getArea());
+  }
+
+  std::vector<ConvexHull> empty;
+  encodeHulls(empty, &bytes);
+  ASSERT_TRUE(decodeHulls(bytes.data(), bytes.size(), &decoded));
+  EXPECT_TRUE(decoded.empty());
+}
+
+TEST(BinaryFormatTest, MalformedDataIsRejected) {
+  std::vector<ConvexHull> hulls = randomHulls(5, 4);
+  std::string bytes;
+  encodeHulls(hulls, &bytes);
+  std::vector<ConvexHull> decoded;
+  // Truncated, or with trailing bytes
+  for (int size = 0; size < bytes.size(); size += 7)
+    EXPECT_FALSE(decodeHulls(bytes.data(), size, &decoded)) << size;
+  std::string longer = bytes + "x";
+  EXPECT_FALSE(decodeHulls(longer.data(), longer.size(), &decoded));
+  // Wrong magic
+  std::string wrong = bytes;
+  wrong[0] = 'X';
+  EXPECT_FALSE(decodeHulls(wrong.data(), wrong.size(), &decoded));
+  // Huge hull count
+  std::string huge = bytes;
+  huge[7] = '\x7f';
+  EXPECT_FALSE(decodeHulls(huge.data(), huge.size(), &decoded));
+  // Hull with less than 3 apexes
+  std::string degenerate = bytes;
+  degenerate[12] = 2;
+  EXPECT_FALSE(decodeHulls(degenerate.data(), degenerate.size(), &decoded));
+}
@@ -0,0 +1,129 @@
+#include "convex_hull_c.h"
+
+#include <gtest/gtest.h>
+
+#include "intersection_backends.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+// Flat arrays of a set of hulls, as a C caller would hold them
+struct FlatHulls {
+  std::vector<double> xy;
+  std::vector<int32_t> offsets = {0};
+  std::vector<int32_t> ids;
+
+  explicit FlatHulls(const std::vector<ConvexHull> &hulls) {
+    for (const ConvexHull &hull : hulls) {
+      for (const Point &p : hull.apex) {
+        xy.push_back(p.x);
+        xy.push_back(p.y);
+      }
+      offsets.push_back(offsets.back() + hull.apex.size());
+      ids.push_back(hull.id);
+    }
+  }
+
+  ch_hullset *create() const {
+    ch_hullset *set = nullptr;
+    EXPECT_EQ(ch_hullset_create_from_buffers(xy.data(), offsets.data(),
+                                             ids.data(), ids.size(), &set),
+              CH_OK);
+    return set;
+  }
+};
+}  // namespace
+
+TEST(CApiTest, Version) {
+  EXPECT_EQ(ch_api_version(), CH_API_VERSION);
+  EXPECT_STREQ(ch_status_string(CH_OK), "ok");
+  EXPECT_STREQ(ch_status_string(static_cast<ch_status>(42)),
+               "unknown status");
+}
+
+TEST(CApiTest, AreasMatchTheLibrary) {
+  std::vector<ConvexHull> hulls = randomHulls(60, 5, 20.);
+  hulls.push_back(ConvexHull({Point(0, 0), Point(3, 0), Point(4, 2),
+                              Point(2, 4), Point(0, 3)},
+                             77));
+  FlatHulls flat(hulls);
+  ch_hullset *set = flat.create();
+  ASSERT_NE(set, nullptr);
+  ASSERT_EQ(ch_hullset_size(set), hulls.size());
+
+  for (int i = 0; i < hulls.size(); ++i) {
+    int32_t id;
+    double area;
+    ASSERT_EQ(ch_hull_id(set, i, &id), CH_OK);
+    EXPECT_EQ(id, hulls[i].id);
+    ASSERT_EQ(ch_hull_area(set, i, &area), CH_OK);
+    EXPECT_NEAR(area, hulls[i].getArea(), 1e-9);
+    for (int j = 0; j < hulls.size(); ++j) {
+      ASSERT_EQ(ch_intersection_area(set, i, j, &area), CH_OK);
+      EXPECT_NEAR(area, intersectionArea(&hulls[i], &hulls[j]), 1e-9);
+    }
+  }
+
+  // Polygons given directly
+  double area;
+  ASSERT_EQ(ch_polygon_intersection_area(
+                flat.xy.data(), 4, flat.xy.data() + 2 * flat.offsets[1], 4,
+                &area),
+            CH_OK);
+  EXPECT_NEAR(area, intersectionArea(&hulls[0], &hulls[1]), 1e-9);
+  ch_hullset_destroy(set);
+}
+
+TEST(CApiTest, EliminationMatchesTheLibrary) {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    std::vector<ConvexHull> hulls = randomHulls(150, seed, 30.);
+    FlatHulls flat(hulls);
+    ch_hullset *set = flat.create();
+    std::vector<int32_t> kept(hulls.size());
+    int32_t n_kept = -1;
+    ASSERT_EQ(ch_eliminate(set, 0.5, kept.data(), &n_kept), CH_OK);
+    std::vector<int> kept_ids;
+    for (int k = 0; k < n_kept; ++k) kept_ids.push_back(hulls[kept[k]].id);
+
+    std::vector<ConvexHull> input = hulls;
+    EXPECT_EQ(kept_ids, hullIds(eliminateOverlappingCHulls(&input, 0.5)));
+    ch_hullset_destroy(set);
+  }
+}
+
+TEST(CApiTest, InvalidArguments) {
+  const double xy[] = {0, 0, 1, 0, 1, 1, 0, 1};
+  const int32_t offsets[] = {0, 4};
+  const int32_t bad_offsets[] = {0, 2};
+  ch_hullset *set = nullptr;
+  EXPECT_EQ(ch_hullset_create_from_buffers(nullptr, offsets, nullptr, 1, &set),
+            CH_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(ch_hullset_create_from_buffers(xy, bad_offsets, nullptr, 1, &set),
+            CH_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(ch_hullset_create_from_buffers(xy, offsets, nullptr, -1, &set),
+            CH_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(set, nullptr);
+
+  ASSERT_EQ(ch_hullset_create_from_buffers(xy, offsets, nullptr, 1, &set),
+            CH_OK);
+  int32_t id;
+  double area;
+  EXPECT_EQ(ch_hull_id(set, 0, &id), CH_OK);
+  EXPECT_EQ(id, 0);
+  EXPECT_EQ(ch_hull_area(set, 1, &area), CH_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(ch_intersection_area(set, 0, -1, &area),
+            CH_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(ch_polygon_intersection_area(xy, 2, xy, 4, &area),
+            CH_ERROR_INVALID_ARGUMENT);
+  int32_t n_kept;
+  EXPECT_EQ(ch_eliminate(set, 0.5, nullptr, &n_kept),
+            CH_ERROR_INVALID_ARGUMENT);
+  ch_hullset_destroy(set);
+  ch_hullset_destroy(nullptr);
+
+  // An empty set is valid
+  ASSERT_EQ(ch_hullset_create_from_buffers(nullptr, offsets, nullptr, 0, &set),
+            CH_OK);
+  EXPECT_EQ(ch_eliminate(set, 0.5, nullptr, &n_kept), CH_OK);
+  EXPECT_EQ(n_kept, 0);
+  ch_hullset_destroy(set);
+}
@@ -0,0 +1,92 @@
+#include "clustering.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_hulls.hpp"
+
+namespace {
+// Connected components by depth first search over all pairs
+std::vector<int> referenceLabels(std::vector<ConvexHull> *hulls,
+                                 double min_intersection_area) {
+  int n = hulls->size();
+  std::vector<int> labels(n, -1);
+  int n_clusters = 0;
+  for (int start = 0; start < n; ++start) {
+    if (labels[start] >= 0) continue;
+    std::vector<int> stack = {start};
+    labels[start] = n_clusters;
+    while (!stack.empty()) {
+      int i = stack.back();
+      stack.pop_back();
+      for (int j = 0; j < n; ++j) {
+        if (labels[j] >= 0) continue;
+        if (intersectionArea(&hulls->at(i), &hulls->at(j)) >
+            min_intersection_area) {
+          labels[j] = n_clusters;
+          stack.push_back(j);
+        }
+      }
+    }
+    ++n_clusters;
+  }
+  return labels;
+}
+}  // namespace
+
+TEST(ClusteringTest, UnionFind) {
+  ConcurrentUnionFind sets(6);
+  EXPECT_TRUE(sets.unite(4, 5));
+  EXPECT_TRUE(sets.unite(5, 2));
+  EXPECT_FALSE(sets.unite(4, 2));
+  EXPECT_TRUE(sets.unite(1, 0));
+  // Roots are the smallest members
+  EXPECT_EQ(sets.find(5), 2);
+  EXPECT_EQ(sets.find(4), 2);
+  EXPECT_EQ(sets.find(1), 0);
+  EXPECT_EQ(sets.find(3), 3);
+}
+
+TEST(ClusteringTest, ConcurrentUnions) {
+  // Every thread unites a strided chain, together they connect everything
+  const int n = 20000;
+  ConcurrentUnionFind sets(n);
+  ThreadPool pool(4);
+  pool.parallelFor(n - 1, 16, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) sets.unite(n - 1 - i, n - 2 - i);
+  });
+  for (int i = 0; i < n; ++i) EXPECT_EQ(sets.find(i), 0);
+}
+
+TEST(ClusteringTest, Squares) {
+  // A chain of three squares (A-B and B-C overlap, A-C do not), a pair that
+  // barely overlaps and a lone square
+  std::vector<ConvexHull> hulls = {square(10, 0, 2), square(0, 0, 2),
+                                   square(1, 0, 2),  square(20, 20, 1),
+                                   square(2, 0, 2),  square(11.9, 0, 2)};
+  HullClusters clusters = clusterOverlappingCHulls(&hulls, 0., nullptr, 2.);
+  EXPECT_EQ(clusters.getNClusters(), 3);
+  EXPECT_EQ(clusters.labels, std::vector<int>({0, 1, 1, 2, 1, 0}));
+
+  // The thin overlap (area 0.2) is below the threshold
+  clusters = clusterOverlappingCHulls(&hulls, 0.5, nullptr, 2.);
+  EXPECT_EQ(clusters.getNClusters(), 4);
+  EXPECT_EQ(clusters.labels, std::vector<int>({0, 1, 1, 2, 1, 3}));
+
+  std::vector<ConvexHull> empty;
+  EXPECT_EQ(clusterOverlappingCHulls(&empty).getNClusters(), 0);
+}
+
+TEST(ClusteringTest, MatchesReference) {
+  std::vector<ConvexHull> hulls = randomHulls(400, 6, 80.);
+  ThreadPool pool(3);
+  for (double min_intersection_area : {0., 0.5}) {
+    std::vector<int> expected = referenceLabels(&hulls, min_intersection_area);
+    for (ThreadPool *p : {static_cast<ThreadPool *>(nullptr), &pool}) {
+      HullClusters clusters =
+          clusterOverlappingCHulls(&hulls, min_intersection_area, p, 5.);
+      EXPECT_EQ(clusters.labels, expected);
+      EXPECT_EQ(clusters.getNClusters(),
+                *std::max_element(expected.begin(), expected.end()) + 1);
+    }
+  }
+}
@@ -152,4 +152,54 @@ TEST_F(ConvexHullTest, PointInConvexHullTest) {
   // Check that a point outside the hull is detected correctly
   Point outsidePoint(1.5, 0.5);
   EXPECT_FALSE(ch2.isPointInside(outsidePoint));
-}
\ No newline at end of file
+}
+// Single precision instantiation
+TEST(FloatConvexHullTest, LayoutIsHalfOfDouble) {
+  EXPECT_EQ(sizeof(PointF) * 2, sizeof(Point));
+  EXPECT_EQ(sizeof(LineF) * 2, sizeof(Line));
+}
+
+TEST(FloatConvexHullTest, AreaAndIntersection) {
+  std::vector<PointF> square = {PointF(0, 0), PointF(2, 0), PointF(2, 2),
+                                PointF(0, 2)};
+  std::vector<PointF> triangle = {PointF(1, 0.5), PointF(3, 0.7),
+                                  PointF(1.5, 1.5)};
+  ConvexHullF C1(square, 1);
+  ConvexHullF C2(triangle, 2);
+  EXPECT_FLOAT_EQ(C1.getArea(), 4.f);
+
+  // Same result as the double precision engine, to float precision
+  std::vector<Point> square_d = {Point(0, 0), Point(2, 0), Point(2, 2),
+                                 Point(0, 2)};
+  std::vector<Point> triangle_d = {Point(1, 0.5), Point(3, 0.7),
+                                   Point(1.5, 1.5)};
+  ConvexHull D1(square_d, 1);
+  ConvexHull D2(triangle_d, 2);
+  ConvexHull intersection_d;
+  ASSERT_TRUE(getIntersectingPolygon(&D1, &D2, &intersection_d));
+
+  ConvexHullF intersection;
+  ASSERT_TRUE(getIntersectingPolygon(&C1, &C2, &intersection));
+  EXPECT_GT(intersection.getArea(), 0.5f);
+  EXPECT_NEAR(intersection.getArea(), intersection_d.getArea(), 1e-5);
+}
+
+TEST(FloatConvexHullTest, JsonRoundTripAndElimination) {
+  std::vector<Point> square = {Point(0, 0), Point(1, 0), Point(1, 1),
+                               Point(0, 1)};
+  std::vector<Point> shifted = {Point(0.1, 0), Point(1.1, 0), Point(1.1, 1),
+                                Point(0.1, 1)};
+  std::vector<Point> far = {Point(5, 5), Point(6, 5), Point(6, 6)};
+  std::vector<ConvexHull> hulls = {ConvexHull(square, 0),
+                                   ConvexHull(shifted, 1), ConvexHull(far, 2)};
+  json data = convexHullsToJson(hulls);
+
+  std::vector<ConvexHullF> hulls_f = convexHullsFromJson<float>(data);
+  ASSERT_EQ(hulls_f.size(), 3);
+  EXPECT_FLOAT_EQ(hulls_f[1].apex[0].x, 0.1f);
+  std::vector<ConvexHullF> remaining =
+      eliminateOverlappingCHulls(&hulls_f, 0.5);
+  ASSERT_EQ(remaining.size(), 1);
+  EXPECT_EQ(remaining[0].id, 2);
+  EXPECT_EQ(convexHullsToJson(remaining)["convex hulls"][0]["ID"], 2);
+}
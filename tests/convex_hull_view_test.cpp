@@ -0,0 +1,145 @@
+#include "convex_hull_view.hpp"
+
+#include <gtest/gtest.h>
+
+#include "hull_generator.hpp"
+#include "intersection_backends.hpp"
+#include "obb.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+// Hulls of 3 to 12 vertices, and all their vertices in a single buffer
+struct SharedBuffer {
+  std::vector<ConvexHull> hulls;
+  std::vector<Point> vertices;
+  std::vector<int> offsets = {0};
+  std::vector<int> ids;
+
+  explicit SharedBuffer(unsigned seed) {
+    HullGeneratorOptions options;
+    options.count = 120;
+    options.seed = seed;
+    hulls = generateConvexHulls(options);
+    for (const ConvexHull &hull : hulls) {
+      vertices.insert(vertices.end(), hull.apex.begin(), hull.apex.end());
+      offsets.push_back(vertices.size());
+      ids.push_back(hull.id);
+    }
+  }
+
+  std::vector<ConvexHullView> views() const {
+    return makeConvexHullViews(vertices.data(), offsets.data(), ids.data(),
+                               hulls.size());
+  }
+
+  bool inBuffer(const Point *p) const {
+    return p >= vertices.data() && p < vertices.data() + vertices.size();
+  }
+};
+
+std::vector<int> viewIds(const std::vector<ConvexHullView> &views) {
+  std::vector<int> res;
+  for (const ConvexHullView &v : views) res.push_back(v.id);
+  return res;
+}
+}  // namespace
+
+TEST(ConvexHullViewTest, QueriesMatchTheHull) {
+  SharedBuffer buffer(3);
+  std::vector<ConvexHullView> views = buffer.views();
+  ASSERT_EQ(views.size(), buffer.hulls.size());
+  for (int h = 0; h < views.size(); ++h) {
+    ConvexHull &hull = buffer.hulls[h];
+    const ConvexHullView &view = views[h];
+    EXPECT_EQ(view.apex, buffer.vertices.data() + buffer.offsets[h]);
+    EXPECT_EQ(view.id, hull.id);
+    EXPECT_EQ(view.getNvertices(), hull.getNvertices());
+    EXPECT_EQ(view.getArea(), hull.getArea());
+    BoundingBox box = computeBoundingBox(hull.apex);
+    EXPECT_EQ(view.bounds.min_x, box.min_x);
+    EXPECT_EQ(view.bounds.max_y, box.max_y);
+
+    // The vertex average is inside, a point beyond the box is not
+    Point center;
+    for (const Point &p : hull.apex) {
+      center.x += p.x / hull.apex.size();
+      center.y += p.y / hull.apex.size();
+    }
+    EXPECT_TRUE(view.isPointInside(center));
+    EXPECT_EQ(view.isPointInside(center), hull.isPointInside(center));
+    Point outside(box.max_x + 1, center.y);
+    EXPECT_FALSE(view.isPointInside(outside));
+  }
+
+  // Views of owning hulls point to their apexes
+  std::vector<ConvexHullView> hull_views = makeConvexHullViews(buffer.hulls);
+  EXPECT_EQ(hull_views[5].apex, buffer.hulls[5].apex.data());
+  EXPECT_EQ(hull_views[5].getArea(), views[5].getArea());
+}
+
+TEST(ConvexHullViewTest, IntersectionAreaMatchesTheHulls) {
+  SharedBuffer buffer(11);
+  std::vector<ConvexHullView> views = buffer.views();
+  int n_intersecting = 0;
+  for (int i = 0; i < views.size(); ++i) {
+    for (int j = 0; j < views.size(); ++j) {
+      double expected = intersectionArea(&buffer.hulls[i], &buffer.hulls[j]);
+      EXPECT_NEAR(intersectionArea(&views[i], &views[j]), expected, 1e-9);
+      n_intersecting += expected > 0 && i != j;
+    }
+  }
+  EXPECT_GT(n_intersecting, 0);
+
+  for (const std::string &name : getIntersectionBackendNames()) {
+    std::unique_ptr<IntersectionBackend> backend =
+        makeIntersectionBackend(name);
+    for (int i = 0; i + 1 < views.size(); i += 3) {
+      EXPECT_NEAR(backend->intersectionArea(&views[i], &views[i + 1]),
+                  backend->intersectionArea(&buffer.hulls[i],
+                                            &buffer.hulls[i + 1]),
+                  1e-9)
+          << name;
+    }
+  }
+}
+
+TEST(ConvexHullViewTest, EliminationMatchesTheHullsWithoutCopies) {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    SharedBuffer buffer(seed);
+    std::vector<ConvexHullView> views = buffer.views();
+    std::vector<ConvexHullView> remaining =
+        eliminateOverlappingCHulls(&views, 0.3);
+    std::vector<ConvexHull> input = buffer.hulls;
+    EXPECT_EQ(viewIds(remaining),
+              hullIds(eliminateOverlappingCHulls(&input, 0.3)));
+    for (const ConvexHullView &view : remaining)
+      EXPECT_TRUE(buffer.inBuffer(view.apex));
+
+    input = buffer.hulls;
+    EXPECT_EQ(viewIds(eliminateOverlappingCHullsWith(
+                  &views, 0.3, EdgeAdvancingBackend())),
+              hullIds(eliminateOverlappingCHullsWith(
+                  &input, 0.3, EdgeAdvancingBackend())));
+  }
+}
+
+TEST(ConvexHullViewTest, BoxIntersection) {
+  SharedBuffer buffer(5);
+  std::vector<ConvexHullView> views = buffer.views();
+  const Point &corner = buffer.hulls[0].apex[0];
+  OrientedBox box(corner.x, corner.y, 3., 2., 0.4, 0);
+  for (int h = 0; h < views.size(); ++h) {
+    EXPECT_NEAR(obbHullIntersectionArea(box, views[h]),
+                obbHullIntersectionArea(box, buffer.hulls[h]), 1e-9);
+  }
+}
+
+TEST(ConvexHullViewTest, Float) {
+  const PointF square[] = {PointF(0, 0), PointF(2, 0), PointF(2, 2),
+                           PointF(0, 2)};
+  const PointF triangle[] = {PointF(1, 1), PointF(3, 1), PointF(1, 3)};
+  ConvexHullViewF A(square, 4, 0), B(triangle, 3, 1);
+  EXPECT_FLOAT_EQ(A.getArea(), 4.f);
+  EXPECT_FLOAT_EQ(intersectionArea(&A, &B), 1.f);
+  EXPECT_TRUE(A.isPointInside(PointF(1, 1)));
+}
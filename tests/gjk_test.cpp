@@ -0,0 +1,185 @@
+#include "gjk.hpp"
+
+#include <gtest/gtest.h>
+
+#include "hull_generator.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+double pointSegmentDistance(const Point &P, const Point &a, const Point &b) {
+  double ex = b.x - a.x, ey = b.y - a.y;
+  double t = ((P.x - a.x) * ex + (P.y - a.y) * ey) / (ex * ex + ey * ey);
+  t = std::max(0., std::min(1., t));
+  return std::hypot(a.x + t * ex - P.x, a.y + t * ey - P.y);
+}
+
+// Distance of separated convex polygons: closest vertex to edge pair
+double bruteForceDistance(const ConvexHull &A, const ConvexHull &B) {
+  double best = INFINITY;
+  for (int pass = 0; pass < 2; ++pass) {
+    const ConvexHull &P = pass == 0 ? A : B, &Q = pass == 0 ? B : A;
+    for (const Point &p : P.apex) {
+      for (int j = 0; j < Q.apex.size(); ++j) {
+        const Point &q2 = Q.apex[j + 1 == Q.apex.size() ? 0 : j + 1];
+        best = std::min(best, pointSegmentDistance(p, Q.apex[j], q2));
+      }
+    }
+  }
+  return best;
+}
+
+// Penetration of overlapping convex polygons: smallest overlap of their
+// projections on the edge normals (separating axis theorem)
+double bruteForcePenetration(const ConvexHull &A, const ConvexHull &B) {
+  double best = INFINITY;
+  for (int pass = 0; pass < 2; ++pass) {
+    const ConvexHull &P = pass == 0 ? A : B;
+    for (int i = 0; i < P.apex.size(); ++i) {
+      const Point &p2 = P.apex[i + 1 == P.apex.size() ? 0 : i + 1];
+      double nx = p2.y - P.apex[i].y, ny = P.apex[i].x - p2.x;
+      double length = std::hypot(nx, ny);
+      double a_min = INFINITY, a_max = -INFINITY;
+      double b_min = INFINITY, b_max = -INFINITY;
+      for (const Point &p : A.apex) {
+        a_min = std::min(a_min, (p.x * nx + p.y * ny) / length);
+        a_max = std::max(a_max, (p.x * nx + p.y * ny) / length);
+      }
+      for (const Point &p : B.apex) {
+        b_min = std::min(b_min, (p.x * nx + p.y * ny) / length);
+        b_max = std::max(b_max, (p.x * nx + p.y * ny) / length);
+      }
+      best = std::min(best, std::min(a_max - b_min, b_max - a_min));
+    }
+  }
+  return best;
+}
+}  // namespace
+
+TEST(GjkTest, SeparatedSquares) {
+  ConvexHull A = square(0, 0, 2), B = square(5, 1, 2);
+  HullProximity proximity = hullProximity(A, B);
+  EXPECT_FALSE(proximity.overlapping);
+  EXPECT_NEAR(proximity.distance, 3., 1e-12);
+  EXPECT_EQ(proximity.penetration, 0.);
+  EXPECT_NEAR(proximity.normal.x, 1., 1e-12);
+  EXPECT_NEAR(proximity.normal.y, 0., 1e-12);
+  EXPECT_NEAR(proximity.point_a.x, 2., 1e-12);
+  EXPECT_NEAR(proximity.point_b.x, 5., 1e-12);
+  EXPECT_GE(proximity.point_a.y, 1. - 1e-12);
+  EXPECT_LE(proximity.point_a.y, 2. + 1e-12);
+  EXPECT_NEAR(hullDistance(A, B), 3., 1e-12);
+
+  // Diagonal: corner to corner
+  ConvexHull C = square(4, 6, 1);
+  EXPECT_NEAR(hullDistance(A, C), std::hypot(2., 4.), 1e-12);
+}
+
+TEST(GjkTest, OverlappingSquares) {
+  ConvexHull A = square(0, 0, 2), B = square(1.5, 0.5, 2);
+  HullProximity proximity = hullProximity(A, B);
+  EXPECT_TRUE(proximity.overlapping);
+  EXPECT_EQ(proximity.distance, 0.);
+  EXPECT_NEAR(proximity.penetration, 0.5, 1e-9);
+  // B leaves A by moving right
+  EXPECT_NEAR(proximity.normal.x, 1., 1e-9);
+  EXPECT_NEAR(proximity.normal.y, 0., 1e-9);
+  EXPECT_EQ(hullDistance(A, B), 0.);
+
+  // Contained: the cheapest way out is through the nearest side
+  ConvexHull inner = square(0.2, 0.5, 0.5);
+  proximity = hullProximity(A, inner);
+  EXPECT_TRUE(proximity.overlapping);
+  EXPECT_NEAR(proximity.penetration, 0.7, 1e-9);
+  EXPECT_NEAR(proximity.normal.x, -1., 1e-9);
+
+  // Without EPA
+  proximity = hullProximity(A, B, false);
+  EXPECT_TRUE(proximity.overlapping);
+  EXPECT_EQ(proximity.penetration, 0.);
+}
+
+TEST(GjkTest, MatchesBruteForce) {
+  HullGeneratorOptions options;
+  options.count = 150;
+  options.seed = 9;
+  options.max_vertices = 20;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  int n_overlapping = 0;
+  for (int i = 0; i < hulls.size(); ++i) {
+    for (int j = i + 1; j < hulls.size(); ++j) {
+      HullProximity proximity = hullProximity(hulls[i], hulls[j]);
+      bool intersecting = intersectionArea(&hulls[i], &hulls[j]) > 0;
+      ASSERT_EQ(proximity.overlapping, intersecting) << i << " " << j;
+      if (intersecting) {
+        ++n_overlapping;
+        EXPECT_NEAR(proximity.penetration,
+                    bruteForcePenetration(hulls[i], hulls[j]), 1e-7);
+      } else {
+        EXPECT_NEAR(proximity.distance,
+                    bruteForceDistance(hulls[i], hulls[j]), 1e-9);
+        EXPECT_NEAR(std::hypot(proximity.point_b.x - proximity.point_a.x,
+                               proximity.point_b.y - proximity.point_a.y),
+                    proximity.distance, 1e-9);
+      }
+    }
+  }
+  EXPECT_GT(n_overlapping, 0);
+}
+
+TEST(GjkTest, LargePolygons) {
+  // Regular 1000-gons: the support searches must follow the hint around
+  const int n = 1000;
+  std::vector<Point> a, b;
+  for (int k = 0; k < n; ++k) {
+    double angle = 2 * M_PI * k / n;
+    a.push_back(Point(std::cos(angle), std::sin(angle)));
+    b.push_back(Point(3 + std::cos(angle), 1 + std::sin(angle)));
+  }
+  ConvexHull A(a, 0), B(b, 1);
+  HullProximity proximity = hullProximity(A, B);
+  EXPECT_FALSE(proximity.overlapping);
+  EXPECT_NEAR(proximity.distance, std::hypot(3., 1.) - 2., 2e-5);
+  EXPECT_LT(proximity.n_iterations, 64);
+
+  ConvexHull C(std::vector<Point>(a.rbegin(), a.rend()), 2);  // CW
+  for (Point &p : b) p.x -= 1.5;
+  ConvexHull D(b, 3);
+  proximity = hullProximity(C, D);
+  EXPECT_TRUE(proximity.overlapping);
+  EXPECT_NEAR(proximity.penetration, 2. - std::hypot(1.5, 1.), 2e-5);
+}
+
+TEST(GjkTest, ProximityPairs) {
+  std::vector<ConvexHull> hulls = randomHulls(200, 4, 60.);
+  const double max_distance = 1.5;
+  std::vector<ProximityEntry> expected;
+  for (int i = 0; i < hulls.size(); ++i) {
+    for (int j = i + 1; j < hulls.size(); ++j) {
+      HullProximity proximity = hullProximity(hulls[i], hulls[j]);
+      if (proximity.distance <= max_distance)
+        expected.push_back(ProximityEntry(i, j, proximity.distance,
+                                          proximity.penetration));
+    }
+  }
+  ThreadPool pool(3);
+  for (ThreadPool *p : {static_cast<ThreadPool *>(nullptr), &pool}) {
+    std::vector<ProximityEntry> pairs =
+        findProximityPairs(hulls, max_distance, p, 5.);
+    ASSERT_EQ(pairs.size(), expected.size());
+    for (int k = 0; k < pairs.size(); ++k) {
+      EXPECT_EQ(pairs[k].i, expected[k].i);
+      EXPECT_EQ(pairs[k].j, expected[k].j);
+      EXPECT_EQ(pairs[k].distance, expected[k].distance);
+      EXPECT_EQ(pairs[k].penetration, expected[k].penetration);
+    }
+  }
+}
+
+TEST(GjkTest, FloatAndViews) {
+  const PointF a[] = {PointF(0, 0), PointF(2, 0), PointF(2, 2), PointF(0, 2)};
+  const PointF b[] = {PointF(3, 0), PointF(4, 0), PointF(3.5f, 1)};
+  ConvexHullViewF A(a, 4, 0), B(b, 3, 1);
+  HullProximityF proximity = hullProximity(A, B);
+  EXPECT_FALSE(proximity.overlapping);
+  EXPECT_FLOAT_EQ(proximity.distance, 1.f);
+}
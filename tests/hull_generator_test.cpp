@@ -0,0 +1,63 @@
+#include "hull_generator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+namespace {
+bool isConvexCCW(const ConvexHull::ApexVector &apex) {
+  int n = apex.size();
+  for (int i = 0; i < n; ++i) {
+    const Point &a = apex[i], &b = apex[(i + 1) % n], &c = apex[(i + 2) % n];
+    double cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+    if (cross <= 0) return false;
+  }
+  return true;
+}
+}  // namespace
+
+TEST(HullGeneratorTest, SameSeedSameWorkload) {
+  HullGeneratorOptions options;
+  options.count = 50;
+  options.seed = 7;
+  std::vector<ConvexHull> a = generateConvexHulls(options);
+  std::vector<ConvexHull> b = generateConvexHulls(options);
+  ASSERT_EQ(a.size(), b.size());
+  for (int i = 0; i < a.size(); ++i) {
+    ASSERT_EQ(a[i].getNvertices(), b[i].getNvertices());
+    EXPECT_DOUBLE_EQ(a[i].apex[0].x, b[i].apex[0].x);
+    EXPECT_DOUBLE_EQ(a[i].apex[0].y, b[i].apex[0].y);
+  }
+  options.seed = 8;
+  EXPECT_NE(generateConvexHulls(options)[0].apex[0].x, a[0].apex[0].x);
+}
+
+TEST(HullGeneratorTest, HullsFollowTheOptions) {
+  HullGeneratorOptions options;
+  options.count = 500;
+  options.min_vertices = 4;
+  options.max_vertices = 9;
+  options.min_radius = 1.;
+  options.max_radius = 2.;
+  options.n_clusters = 3;
+  for (const ConvexHull &c : generateConvexHulls(options)) {
+    EXPECT_GE(c.apex.size(), 4);
+    EXPECT_LE(c.apex.size(), 9);
+    EXPECT_LE(c.area, M_PI * 2. * 2.);
+    EXPECT_TRUE(isConvexCCW(c.apex));
+  }
+}
+
+TEST(HullGeneratorTest, StreamedJsonRoundTrips) {
+  HullGeneratorOptions options;
+  options.count = 20;
+  std::stringstream stream;
+  writeGeneratedConvexHullsJson(options, stream);
+  std::vector<ConvexHull> loaded = convexHullsFromJson(json::parse(stream));
+  std::vector<ConvexHull> generated = generateConvexHulls(options);
+  ASSERT_EQ(loaded.size(), generated.size());
+  for (int i = 0; i < loaded.size(); ++i) {
+    EXPECT_EQ(loaded[i].id, generated[i].id);
+    EXPECT_DOUBLE_EQ(loaded[i].area, generated[i].area);
+  }
+}
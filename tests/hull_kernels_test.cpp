@@ -0,0 +1,97 @@
+#include "hull_kernels.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+// Random convex polygon: n sorted angles on an ellipse
+std::vector<Point> randomConvex(int n, std::mt19937 *gen) {
+  std::uniform_real_distribution<double> unit(0., 1.);
+  double cx = 4 * unit(*gen), cy = 4 * unit(*gen);
+  double rx = 0.5 + 2 * unit(*gen), ry = 0.5 + 2 * unit(*gen);
+  std::vector<Point> vertices;
+  for (int i = 0; i < n; ++i) {
+    double a = 2 * M_PI * (i + 0.1 + 0.8 * unit(*gen)) / n;
+    vertices.push_back(Point(cx + rx * std::cos(a), cy + ry * std::sin(a)));
+  }
+  return vertices;
+}
+
+// Reference area through the Matrix determinants, like ConvexHull did
+double shoelaceArea(const std::vector<Point> &v) {
+  double area = Matrix(v.back(), v.front()).getDeterminant();
+  for (int i = 0; i + 1 < v.size(); ++i)
+    area += Matrix(v[i], v[i + 1]).getDeterminant();
+  return std::abs(0.5 * area);
+}
+}  // namespace
+
+TEST(HullKernelsTest, AreaMatchesShoelace) {
+  std::mt19937 gen(1);
+  for (int k = 0; k < 100; ++k) {
+    std::vector<Point> tri = randomConvex(3, &gen);
+    std::vector<Point> quad = randomConvex(4, &gen);
+    std::vector<Point> hexa = randomConvex(6, &gen);
+    EXPECT_NEAR((PolygonKernel<double, 3>::area(tri.data())),
+                shoelaceArea(tri), 1e-12);
+    EXPECT_NEAR((PolygonKernel<double, 4>::area(quad.data())),
+                shoelaceArea(quad), 1e-12);
+    EXPECT_NEAR((PolygonKernel<double, 6>::area(hexa.data())),
+                shoelaceArea(hexa), 1e-12);
+    EXPECT_NEAR(ConvexHull(quad, 0).getArea(), shoelaceArea(quad), 1e-12);
+  }
+}
+
+TEST(HullKernelsTest, ContainsMatchesRayCasting) {
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> pos(-1., 7.);
+  for (int k = 0; k < 50; ++k) {
+    std::vector<Point> tri = randomConvex(3, &gen);
+    std::vector<Point> quad = randomConvex(4, &gen);
+    // Clockwise order must work as well
+    std::vector<Point> quad_cw(quad.rbegin(), quad.rend());
+    for (int p = 0; p < 50; ++p) {
+      Point P(pos(gen), pos(gen));
+      EXPECT_EQ((PolygonKernel<double, 3>::contains(tri.data(), P)),
+                pointInPolygon(tri, P));
+      EXPECT_EQ((PolygonKernel<double, 4>::contains(quad.data(), P)),
+                pointInPolygon(quad, P));
+      EXPECT_EQ((PolygonKernel<double, 4>::contains(quad_cw.data(), P)),
+                pointInPolygon(quad, P));
+    }
+  }
+}
+
+TEST(HullKernelsTest, ClipAreaMatchesGenericIntersection) {
+  std::mt19937 gen(3);
+  int n_overlapping = 0;
+  for (int k = 0; k < 500; ++k) {
+    ConvexHull C1(randomConvex(3 + k % 2, &gen), 0);
+    ConvexHull C2(randomConvex(3 + (k / 2) % 2, &gen), 1);
+    ConvexHull intersection;
+    double expected = getIntersectingPolygon(&C1, &C2, &intersection)
+                          ? intersection.getArea()
+                          : 0.;
+    if (expected > 0) ++n_overlapping;
+    EXPECT_NEAR(intersectionArea(&C1, &C2), expected, 1e-9);
+    EXPECT_NEAR(intersectionArea(&C2, &C1), expected, 1e-9);
+  }
+  EXPECT_GT(n_overlapping, 100);
+}
+
+TEST(HullKernelsTest, IntersectionPolygonIsSortedAroundItsCentroid) {
+  // The pivot of the previous sort was the first vertex, whose angles to the
+  // other vertices could wrap around and give a self intersecting polygon
+  std::vector<Point> square = {Point(0, 0), Point(2, 0), Point(2, 2),
+                               Point(0, 2)};
+  std::vector<Point> quad = {Point(1, 0.5), Point(3, 1), Point(2.5, 3),
+                             Point(0.5, 2.5)};
+  std::vector<Point> pentagon = {Point(1, 0.5), Point(3, 1), Point(3.2, 2),
+                                 Point(2.5, 3), Point(0.5, 2.5)};
+  ConvexHull C1(square, 0), C2(quad, 1), C3(pentagon, 2);
+  ConvexHull intersection;
+  ASSERT_TRUE(getIntersectingPolygon(&C1, &C2, &intersection));
+  EXPECT_NEAR(intersection.getArea(), intersectionArea(&C1, &C2), 1e-12);
+  EXPECT_NEAR(intersectionArea(&C1, &C3), intersectionArea(&C1, &C2), 1e-12);
+}
@@ -0,0 +1,181 @@
+#include "hull_server.hpp"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <json.hpp>
+
+#include "binary_format.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+class HullServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    options_.socket_path =
+        "/tmp/hull_server_test_" + std::to_string(getpid()) + ".sock";
+    options_.n_threads = 2;
+  }
+
+  HullServerOptions options_;
+};
+
+std::vector<int> eliminatedIds(std::vector<ConvexHull> hulls) {
+  return hullIds(eliminateOverlappingCHulls(&hulls, 0.5));
+}
+}  // namespace
+
+TEST_F(HullServerTest, BinaryAndJsonRequests) {
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  HullClient client;
+  ASSERT_TRUE(client.connect(options_.socket_path, &error)) << error;
+
+  // Several requests on the same connection
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    std::vector<ConvexHull> hulls = randomHulls(80, seed, 30.);
+    std::vector<ConvexHull> remaining;
+    ASSERT_TRUE(client.eliminate(hulls, &remaining, &error)) << error;
+    EXPECT_EQ(hullIds(remaining), eliminatedIds(hulls));
+
+    MessageKind kind;
+    std::string response;
+    ASSERT_TRUE(client.request(kMessageJson, convexHullsToJson(hulls).dump(),
+                               &kind, &response));
+    ASSERT_EQ(kind, kMessageJson) << response;
+    EXPECT_EQ(hullIds(convexHullsFromJson(json::parse(response))),
+              eliminatedIds(hulls));
+  }
+  EXPECT_EQ(server.getNRequests(), 10);
+}
+
+TEST_F(HullServerTest, BadRequestsGetAnError) {
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  HullClient client;
+  ASSERT_TRUE(client.connect(options_.socket_path, &error)) << error;
+
+  MessageKind kind;
+  std::string response;
+  ASSERT_TRUE(client.request(kMessageJson, "{\"convex", &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+  ASSERT_TRUE(client.request(kMessageBinary, "garbage", &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+  EXPECT_EQ(response, "malformed binary hulls");
+  ASSERT_TRUE(client.request(kMessageError, "", &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+
+  // The connection still works
+  std::vector<ConvexHull> hulls = randomHulls(20, 1), remaining;
+  EXPECT_TRUE(client.eliminate(hulls, &remaining, &error)) << error;
+}
+
+TEST_F(HullServerTest, MalformedHullsGetAnError) {
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  HullClient client;
+  ASSERT_TRUE(client.connect(options_.socket_path, &error)) << error;
+
+  // A hull of 2 apexes and a NaN coordinate, in both formats
+  MessageKind kind;
+  std::string response;
+  std::string two_apexes =
+      "{\"convex hulls\": [{\"ID\": 0, \"apexes\": "
+      "[{\"x\": 0, \"y\": 0}, {\"x\": 1, \"y\": 0}]}]}";
+  ASSERT_TRUE(client.request(kMessageJson, two_apexes, &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+  EXPECT_EQ(response, "convex hull 0 has fewer than 3 apexes");
+
+  std::vector<ConvexHull> hulls = randomHulls(3, 2);
+  hulls[1].apex[2].x = NAN;
+  json data = convexHullsToJson(hulls);
+  ASSERT_TRUE(client.request(kMessageJson, data.dump(), &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+  std::string encoded;
+  encodeHulls(hulls, &encoded);
+  ASSERT_TRUE(client.request(kMessageBinary, encoded, &kind, &response));
+  EXPECT_EQ(kind, kMessageError);
+
+  // The server is still up and answers the next request
+  hulls = randomHulls(30, 3);
+  std::vector<ConvexHull> remaining;
+  ASSERT_TRUE(client.eliminate(hulls, &remaining, &error)) << error;
+  EXPECT_EQ(hullIds(remaining), eliminatedIds(hulls));
+}
+
+TEST_F(HullServerTest, ConnectionLimit) {
+  options_.max_connections = 1;
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  HullClient first, second;
+  ASSERT_TRUE(first.connect(options_.socket_path, &error)) << error;
+  std::vector<ConvexHull> hulls = randomHulls(20, 4), remaining;
+  ASSERT_TRUE(first.eliminate(hulls, &remaining, &error)) << error;
+
+  // Refused: either the error message or a closed connection
+  ASSERT_TRUE(second.connect(options_.socket_path, &error)) << error;
+  EXPECT_FALSE(second.eliminate(hulls, &remaining, &error));
+  EXPECT_TRUE(first.eliminate(hulls, &remaining, &error)) << error;
+}
+
+TEST_F(HullServerTest, ConcurrentClients) {
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+
+  const int kNClients = 4, kNRequests = 20;
+  std::vector<int> n_correct(kNClients, 0);
+  std::vector<std::thread> clients;
+  for (int c = 0; c < kNClients; ++c) {
+    clients.emplace_back([&, c] {
+      HullClient client;
+      std::string client_error;
+      if (!client.connect(options_.socket_path, &client_error)) return;
+      for (int r = 0; r < kNRequests; ++r) {
+        std::vector<ConvexHull> hulls = randomHulls(30, 100 * c + r, 20.);
+        std::vector<ConvexHull> remaining;
+        if (client.eliminate(hulls, &remaining, &client_error) &&
+            hullIds(remaining) == eliminatedIds(hulls))
+          ++n_correct[c];
+      }
+    });
+  }
+  for (std::thread &client : clients) client.join();
+  for (int c = 0; c < kNClients; ++c) EXPECT_EQ(n_correct[c], kNRequests);
+}
+
+TEST_F(HullServerTest, StopClosesOpenConnections) {
+  HullServer server(options_);
+  std::string error;
+  ASSERT_TRUE(server.start(&error)) << error;
+  HullClient client;
+  ASSERT_TRUE(client.connect(options_.socket_path, &error)) << error;
+  server.stop();
+
+  MessageKind kind;
+  std::string response;
+  EXPECT_FALSE(client.request(kMessageBinary, "", &kind, &response));
+  HullClient late_client;
+  EXPECT_FALSE(late_client.connect(options_.socket_path, &error));
+
+  // It can be started again
+  ASSERT_TRUE(server.start(&error)) << error;
+  ASSERT_TRUE(late_client.connect(options_.socket_path, &error)) << error;
+}
+
+TEST_F(HullServerTest, StartFailures) {
+  options_.backend = "unknown";
+  HullServer unknown_backend(options_);
+  std::string error;
+  EXPECT_FALSE(unknown_backend.start(&error));
+  EXPECT_FALSE(error.empty());
+
+  options_.backend = "auto";
+  options_.socket_path = "/no/such/dir/server.sock";
+  HullServer bad_path(options_);
+  EXPECT_FALSE(bad_path.start(&error));
+}
@@ -0,0 +1,86 @@
+#include "incremental_eliminator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "test_hulls.hpp"
+
+TEST(SpatialHashGridTest, QueryReturnsOverlappingBoxes) {
+  SpatialHashGrid grid(1.0);
+  grid.insert(BoundingBox(0, 0, 0.5, 0.5));
+  grid.insert(BoundingBox(0.2, 0.2, 3.5, 0.8));
+  grid.insert(BoundingBox(10, 10, 11, 11));
+
+  std::vector<int> candidates;
+  grid.query(BoundingBox(0.4, 0.4, 2, 2), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({0, 1}));
+  grid.query(BoundingBox(3, 0, 4, 1), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({1}));
+  grid.query(BoundingBox(-5, -5, -4, -4), &candidates);
+  EXPECT_TRUE(candidates.empty());
+}
+
+TEST(SpatialHashGridTest, HugeAndFarBoxes) {
+  // Neither is registered cell by cell: no allocation or walk of ~1e20
+  // cells, and both are still found by the queries they overlap
+  SpatialHashGrid grid(1.0);
+  grid.insert(BoundingBox(0, 0, 0.5, 0.5));
+  grid.insert(BoundingBox(-1e10, -1e10, 1e10, 1e10));
+  grid.insert(BoundingBox(1e300, 1e300, 1e300 + 1, 1e300 + 1));
+  grid.insert(BoundingBox(-1e300, 5, -1e300, 6));
+
+  std::vector<int> candidates;
+  grid.query(BoundingBox(0.4, 0.4, 2, 2), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({0, 1}));
+  grid.query(BoundingBox(1e300, 1e300, 1e300, 1e300), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({2}));
+  grid.query(BoundingBox(-1e300, 5.5, -1e300, 5.5), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({3}));
+  // A huge query box is answered by testing every element
+  grid.query(BoundingBox(-1e20, -1e20, 1e20, 1e20), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({0, 1}));
+}
+
+TEST(SpatialHashGridTest, NonFiniteBoxes) {
+  SpatialHashGrid grid(1.0);
+  grid.insert(BoundingBox(0, 0, 0.5, 0.5));
+  grid.insert(BoundingBox(NAN, 0, 1, 1));
+  grid.insert(BoundingBox(-INFINITY, 0, 0.2, 0.2));
+
+  // The comparisons with NaN never reject a pair, so the NaN box is a
+  // candidate of every query, like the box that is infinite to the left
+  std::vector<int> candidates;
+  grid.query(BoundingBox(0.1, 0.1, 0.3, 0.3), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({0, 1, 2}));
+  grid.query(BoundingBox(-50, 0.1, -40, 0.15), &candidates);
+  EXPECT_EQ(candidates, std::vector<int>({1, 2}));
+  grid.query(BoundingBox(NAN, NAN, NAN, NAN), &candidates);
+  EXPECT_EQ(candidates.size(), 3);
+}
+
+TEST(IncrementalEliminatorTest, FinalizeMatchesBatch) {
+  for (unsigned seed = 0; seed < 5; ++seed) {
+    std::vector<ConvexHull> hulls = randomHulls(300, seed);
+    std::vector<ConvexHull> batch = eliminateOverlappingCHulls(&hulls, 0.5);
+
+    IncrementalEliminator eliminator(0.5, 5.);
+    for (const ConvexHull &c : hulls) eliminator.insert(c);
+    EXPECT_EQ(eliminator.getNSurvivors(), batch.size());
+    EXPECT_EQ(hullIds(eliminator.finalize()), hullIds(batch));
+    EXPECT_EQ(eliminator.getNInserted(), 0);
+  }
+}
+
+TEST(IncrementalEliminatorTest, SurvivorsAreUpdatedOnInsert) {
+  std::vector<Point> square = {Point(0, 0), Point(1, 0), Point(1, 1),
+                               Point(0, 1)};
+  std::vector<Point> shifted = {Point(0.1, 0), Point(1.1, 0), Point(1.1, 1),
+                                Point(0.1, 1)};
+  IncrementalEliminator eliminator(0.5);
+  eliminator.insert(ConvexHull(square, 0));
+  EXPECT_EQ(eliminator.getNSurvivors(), 1);
+  eliminator.insert(ConvexHull(shifted, 1));
+  EXPECT_EQ(eliminator.getNSurvivors(), 0);
+  EXPECT_TRUE(eliminator.survivors().empty());
+}
@@ -0,0 +1,129 @@
+#include "intersection_backends.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "test_hulls.hpp"
+
+namespace {
+std::vector<Point> regularPolygon(int n, double cx, double cy, double r,
+                                  double phase = 0.1) {
+  std::vector<Point> vertices;
+  for (int i = 0; i < n; ++i) {
+    double a = 2. * M_PI * i / n + phase;
+    vertices.push_back(Point(cx + r * std::cos(a), cy + r * std::sin(a)));
+  }
+  return vertices;
+}
+
+// Area of the intersection with every backend
+std::vector<double> allAreas(ConvexHull *C1, ConvexHull *C2) {
+  std::vector<double> areas;
+  for (const std::string &name : getIntersectionBackendNames())
+    areas.push_back(makeIntersectionBackend(name)->intersectionArea(C1, C2));
+  return areas;
+}
+
+void expectAllAreas(ConvexHull *C1, ConvexHull *C2, double expected) {
+  std::vector<std::string> names = getIntersectionBackendNames();
+  std::vector<double> areas = allAreas(C1, C2);
+  for (int i = 0; i < names.size(); ++i)
+    EXPECT_NEAR(areas[i], expected, 1e-9) << names[i];
+}
+}  // namespace
+
+TEST(IntersectionBackendsTest, Factory) {
+  std::vector<std::string> names = getIntersectionBackendNames();
+  ASSERT_EQ(names.size(), 4);
+  EXPECT_EQ(names[0], "auto");
+  for (const std::string &name : names) {
+    std::unique_ptr<IntersectionBackend> backend =
+        makeIntersectionBackend(name);
+    ASSERT_NE(backend, nullptr);
+    EXPECT_EQ(name, backend->getName());
+  }
+  EXPECT_EQ(makeIntersectionBackend("unknown"), nullptr);
+}
+
+TEST(IntersectionBackendsTest, SpecialCases) {
+  ConvexHull A = square(0., 0., 2., 0);
+  // Partial overlap
+  ConvexHull B = square(1., 1., 2., 1);
+  expectAllAreas(&A, &B, 1.);
+  // Contained, both ways
+  ConvexHull C = square(0.5, 0.5, 1., 2);
+  expectAllAreas(&A, &C, 1.);
+  expectAllAreas(&C, &A, 1.);
+  // Identical
+  ConvexHull D = square(0., 0., 2., 3);
+  expectAllAreas(&A, &D, 4.);
+  // Disjoint
+  ConvexHull E = square(5., 5., 1., 4);
+  expectAllAreas(&A, &E, 0.);
+  // Sharing an edge or a vertex only
+  ConvexHull F = square(2., 0., 2., 5);
+  expectAllAreas(&A, &F, 0.);
+  ConvexHull G = square(2., 2., 1., 6);
+  expectAllAreas(&A, &G, 0.);
+  // Overlapping along a collinear edge
+  ConvexHull H = square(1., 0., 2., 7);
+  expectAllAreas(&A, &H, 2.);
+}
+
+TEST(IntersectionBackendsTest, BackendsAgreeOnRegularPolygons) {
+  for (int n : {3, 4, 5, 8, 16, 40}) {
+    ConvexHull C1(regularPolygon(n, 0., 0., 1.), 0);
+    for (double dx : {0., 0.3, 0.7, 1.5, 2.5}) {
+      ConvexHull C2(regularPolygon(n + 1, dx, 0.2, 0.8, 0.4), 1);
+      std::vector<double> areas = allAreas(&C1, &C2);
+      for (double area : areas) EXPECT_NEAR(area, areas[0], 1e-9) << n;
+
+      // Same result with CW vertices
+      std::vector<Point> reversed = regularPolygon(n + 1, dx, 0.2, 0.8, 0.4);
+      std::reverse(reversed.begin(), reversed.end());
+      ConvexHull C2_cw(reversed, 1);
+      EXPECT_NEAR(edgeAdvancingIntersectionArea(C1.apex.data(), n,
+                                                C2_cw.apex.data(), n + 1),
+                  areas[0], 1e-9);
+    }
+  }
+}
+
+TEST(IntersectionBackendsTest, BackendsAgreeOnRandomHulls) {
+  std::vector<ConvexHull> hulls = randomHulls(200, 41, 30.);
+  int n_intersecting = 0;
+  for (int i = 0; i + 1 < hulls.size(); ++i) {
+    for (int j = i + 1; j < hulls.size(); ++j) {
+      std::vector<double> areas = allAreas(&hulls[i], &hulls[j]);
+      for (double area : areas) EXPECT_NEAR(area, areas[0], 1e-9);
+      n_intersecting += areas[0] > 0;
+    }
+  }
+  EXPECT_GT(n_intersecting, 0);
+}
+
+TEST(IntersectionBackendsTest, EliminationIsTheSameWithEveryBackend) {
+  std::vector<ConvexHull> hulls = randomHulls(150, 7, 30.);
+  std::vector<ConvexHull> input = hulls;
+  std::vector<int> expected = hullIds(eliminateOverlappingCHulls(&input, 0.3));
+
+  // Compile time selection
+  input = hulls;
+  EXPECT_EQ(hullIds(eliminateOverlappingCHullsWith(&input, 0.3,
+                                                   EdgeAdvancingBackend())),
+            expected);
+  input = hulls;
+  EXPECT_EQ(hullIds(eliminateOverlappingCHullsWith(&input, 0.3,
+                                                   SutherlandHodgmanBackend())),
+            expected);
+  // Run time selection
+  for (const std::string &name : getIntersectionBackendNames()) {
+    input = hulls;
+    std::unique_ptr<IntersectionBackend> backend =
+        makeIntersectionBackend(name);
+    EXPECT_EQ(hullIds(eliminateOverlappingCHullsWith(&input, 0.3, *backend)),
+              expected)
+        << name;
+  }
+}
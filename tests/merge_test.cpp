@@ -0,0 +1,135 @@
+#include "merge.hpp"
+
+#include <gtest/gtest.h>
+
+#include "hull_generator.hpp"
+#include "intersection_backends.hpp"
+#include "predicates.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+// True if P is inside or on the boundary of the CCW hull
+bool coveredBy(const ConvexHull &hull, const Point &P) {
+  int n = hull.apex.size();
+  for (int i = 0; i < n; ++i) {
+    if (predicates::orient2d(hull.apex[i], hull.apex[(i + 1) % n], P) < 0)
+      return false;
+  }
+  return true;
+}
+
+// Hull of all the vertices with a general sort, as a reference
+double referenceHullArea(const std::vector<ConvexHull> &hulls) {
+  std::vector<Point> points;
+  for (const ConvexHull &hull : hulls)
+    points.insert(points.end(), hull.apex.begin(), hull.apex.end());
+  std::sort(points.begin(), points.end(), [](const Point &a, const Point &b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+  std::vector<Point> chain;
+  for (int pass = 0; pass < 2; ++pass) {
+    int start = chain.size();
+    for (const Point &p : points) {
+      while (chain.size() >= start + 2 &&
+             predicates::orient2d(chain.end()[-2], chain.back(), p) <= 0)
+        chain.pop_back();
+      chain.push_back(p);
+    }
+    chain.pop_back();
+    std::reverse(points.begin(), points.end());
+  }
+  return ConvexHull(chain, 0).getArea();
+}
+}  // namespace
+
+TEST(MergeTest, TwoSquares) {
+  ConvexHull A = square(0, 0, 2, 1), B = square(1, 1, 2, 2);
+  // B ordered CW
+  std::reverse(B.apex.begin(), B.apex.end());
+  const ConvexHull *hulls[] = {&A, &B};
+  ConvexHull merged = mergeConvexHulls(hulls, 2, 7);
+  EXPECT_EQ(merged.id, 7);
+  // Hexagon: the square [0, 3]^2 without two corner triangles
+  EXPECT_EQ(merged.getNvertices(), 6);
+  EXPECT_NEAR(merged.getArea(), 9. - 2 * 0.5, 1e-12);
+  for (const ConvexHull *hull : hulls) {
+    for (const Point &p : hull->apex) EXPECT_TRUE(coveredBy(merged, p));
+  }
+
+  // A hull merged with itself, or alone, is unchanged
+  const ConvexHull *same[] = {&A, &A};
+  EXPECT_NEAR(mergeConvexHulls(same, 2, 0).getArea(), 4., 1e-12);
+  EXPECT_EQ(mergeConvexHulls(hulls, 1, 0).getNvertices(), 4);
+}
+
+TEST(MergeTest, MatchesSortedHull) {
+  HullGeneratorOptions options;
+  options.count = 40;
+  options.seed = 2;
+  options.max_vertices = 30;
+  std::vector<ConvexHull> input = generateConvexHulls(options);
+  for (int k = 1; k <= input.size(); k += 7) {
+    std::vector<ConvexHull> subset(input.begin(), input.begin() + k);
+    std::vector<const ConvexHull *> hulls;
+    for (const ConvexHull &hull : subset) hulls.push_back(&hull);
+    ConvexHull merged = mergeConvexHulls(hulls.data(), k, 0);
+    EXPECT_NEAR(merged.getArea(), referenceHullArea(subset), 1e-9);
+    for (const ConvexHull &hull : subset) {
+      for (const Point &p : hull.apex) EXPECT_TRUE(coveredBy(merged, p));
+    }
+  }
+}
+
+TEST(MergeTest, MergesComponents) {
+  // A chain of three squares (A-B and B-C overlap, A-C do not), a pair that
+  // barely overlaps and a lone square
+  std::vector<ConvexHull> input = {
+      square(0, 0, 2, 10), square(1, 0, 2, 11), square(2, 0, 2, 12),
+      square(10, 0, 2, 13), square(11.9, 0, 2, 14), square(20, 20, 1, 15)};
+  std::vector<ConvexHull> merged = mergeOverlappingCHulls(&input, 0.3);
+  ASSERT_EQ(merged.size(), 4);
+  EXPECT_EQ(merged[0].id, 10);
+  EXPECT_NEAR(merged[0].getArea(), 8., 1e-12);
+  EXPECT_EQ(merged[1].id, 13);
+  EXPECT_NEAR(merged[1].getArea(), 4., 1e-12);
+  EXPECT_EQ(merged[2].id, 14);
+  EXPECT_EQ(merged[3].id, 15);
+}
+
+TEST(MergeTest, ParallelMatchesSequential) {
+  std::vector<ConvexHull> input = randomHulls(300, 8, 60.);
+  std::vector<ConvexHull> sequential = mergeOverlappingCHulls(&input, 0.2);
+  EXPECT_LT(sequential.size(), input.size());
+  ThreadPool pool(3);
+  std::vector<ConvexHull> parallel =
+      mergeOverlappingCHulls(&input, 0.2, &pool);
+  ASSERT_EQ(parallel.size(), sequential.size());
+  for (int i = 0; i < parallel.size(); ++i) {
+    EXPECT_EQ(parallel[i].id, sequential[i].id);
+    EXPECT_EQ(parallel[i].getArea(), sequential[i].getArea());
+  }
+  // Every input hull is covered by the hull of its component
+  for (const ConvexHull &hull : input) {
+    bool covered = false;
+    for (const ConvexHull &m : sequential) {
+      bool all = true;
+      for (const Point &p : hull.apex) all &= coveredBy(m, p);
+      covered |= all;
+    }
+    EXPECT_TRUE(covered);
+  }
+}
+
+TEST(MergeTest, Backends) {
+  std::vector<ConvexHull> input = randomHulls(200, 9, 40.);
+  std::vector<ConvexHull> expected = mergeOverlappingCHulls(&input, 0.2);
+  for (const std::string &name : getIntersectionBackendNames()) {
+    std::unique_ptr<IntersectionBackend> backend =
+        makeIntersectionBackend(name);
+    std::vector<ConvexHull> merged =
+        mergeOverlappingCHulls(&input, 0.2, nullptr, backend.get());
+    ASSERT_EQ(merged.size(), expected.size()) << name;
+    for (int i = 0; i < merged.size(); ++i)
+      EXPECT_EQ(merged[i].id, expected[i].id) << name;
+  }
+}
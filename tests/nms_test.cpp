@@ -0,0 +1,218 @@
+#include "nms.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "intersection_backends.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+// Textbook greedy NMS over all the pairs
+std::vector<int> bruteForceNms(std::vector<ConvexHull> *input,
+                               const std::vector<double> &scores,
+                               double iou_threshold) {
+  std::vector<int> order(input->size());
+  for (int i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&](int a, int b) { return scores[a] > scores[b]; });
+  std::vector<int> kept;
+  for (int i : order) {
+    bool suppressed = false;
+    for (int k : kept) {
+      double area = intersectionArea(&input->at(i), &input->at(k));
+      double iou = area / (input->at(i).getArea() + input->at(k).getArea() -
+                           area);
+      if (area > 0 && iou > iou_threshold) suppressed = true;
+    }
+    if (!suppressed) kept.push_back(i);
+  }
+  return kept;
+}
+
+std::vector<double> randomScores(int n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> unit(0., 1.);
+  std::vector<double> scores;
+  for (int i = 0; i < n; ++i) scores.push_back(unit(gen));
+  return scores;
+}
+}  // namespace
+
+TEST(NmsTest, OnlyKeptHullsSuppress) {
+  // A overlaps B, B overlaps C, A and C are apart
+  std::vector<ConvexHull> hulls = {square(0., 0., 2., 0),
+                                   square(0.5, 0., 2., 1),
+                                   square(1.2, 0., 2., 2)};
+  std::vector<double> scores = {0.9, 0.8, 0.7};
+  NmsOptions options;
+  options.iou_threshold = 0.3;
+  EXPECT_EQ(nonMaximumSuppression(&hulls, scores, options),
+            std::vector<int>({0, 2}));
+
+  // eliminateOverlappingCHulls removes both members of each pair instead
+  EXPECT_TRUE(eliminateOverlappingCHulls(&hulls, 0.3).empty());
+}
+
+TEST(NmsTest, MatchesBruteForce) {
+  std::vector<ConvexHull> hulls = randomHulls(500, 4, 40.);
+  std::vector<double> scores = randomScores(hulls.size(), 1);
+  for (double iou : {0.1, 0.3, 0.7}) {
+    NmsOptions options;
+    options.iou_threshold = iou;
+    options.cell_size = 4.;
+    EXPECT_EQ(nonMaximumSuppression(&hulls, scores, options),
+              bruteForceNms(&hulls, scores, iou))
+        << iou;
+  }
+}
+
+TEST(NmsTest, Backends) {
+  std::vector<ConvexHull> hulls = randomHulls(300, 6, 30.);
+  std::vector<double> scores = randomScores(hulls.size(), 5);
+  for (NmsMethod method : {kNmsHard, kNmsLinear}) {
+    NmsOptions options;
+    options.method = method;
+    std::vector<int> expected = nonMaximumSuppression(&hulls, scores, options);
+    for (const std::string &name : getIntersectionBackendNames()) {
+      std::unique_ptr<IntersectionBackend> backend =
+          makeIntersectionBackend(name);
+      options.backend = backend.get();
+      EXPECT_EQ(nonMaximumSuppression(&hulls, scores, options), expected)
+          << name;
+    }
+  }
+}
+
+TEST(NmsTest, ResultDoesNotDependOnInputOrder) {
+  std::vector<ConvexHull> hulls = randomHulls(300, 8, 30.);
+  std::vector<double> scores = randomScores(hulls.size(), 2);
+  NmsOptions options;
+  std::vector<int> ids;
+  for (int i : nonMaximumSuppression(&hulls, scores, options))
+    ids.push_back(hulls[i].id);
+
+  std::vector<ConvexHull> reversed(hulls.rbegin(), hulls.rend());
+  std::vector<double> reversed_scores(scores.rbegin(), scores.rend());
+  std::vector<int> reversed_ids;
+  for (int i : nonMaximumSuppression(&reversed, reversed_scores, options))
+    reversed_ids.push_back(reversed[i].id);
+  EXPECT_EQ(ids, reversed_ids);
+}
+
+TEST(NmsTest, EarlyTermination) {
+  std::vector<ConvexHull> hulls = randomHulls(200, 3);
+  std::vector<double> scores = randomScores(hulls.size(), 3);
+  NmsOptions options;
+  std::vector<int> all = nonMaximumSuppression(&hulls, scores, options);
+
+  options.max_output = 10;
+  std::vector<int> top = nonMaximumSuppression(&hulls, scores, options);
+  ASSERT_EQ(top.size(), 10);
+  EXPECT_TRUE(std::equal(top.begin(), top.end(), all.begin()));
+
+  options.max_output = 0;
+  options.score_threshold = 0.5;
+  for (int i : nonMaximumSuppression(&hulls, scores, options))
+    EXPECT_GE(scores[i], 0.5);
+}
+
+TEST(NmsTest, ScoresFromJson) {
+  json data = convexHullsToJson(randomHulls(3, 1));
+  data["convex hulls"][1]["score"] = 0.25;
+  EXPECT_EQ(scoresFromJson(data, 1.), std::vector<double>({1., 0.25, 1.}));
+}
+
+namespace {
+// Textbook Soft-NMS: keep the best remaining hull, decay all the others
+std::vector<int> bruteForceSoftNms(std::vector<ConvexHull> *input,
+                                   std::vector<double> scores,
+                                   const NmsOptions &options,
+                                   std::vector<double> *kept_scores) {
+  std::vector<bool> done(input->size(), false);
+  std::vector<int> kept;
+  kept_scores->clear();
+  while (true) {
+    int best = -1;
+    for (int i = 0; i < input->size(); ++i) {
+      if (done[i] || scores[i] < options.score_threshold) continue;
+      if (best < 0 || scores[i] > scores[best]) best = i;
+    }
+    if (best < 0) break;
+    done[best] = true;
+    kept.push_back(best);
+    kept_scores->push_back(scores[best]);
+    for (int j = 0; j < input->size(); ++j) {
+      if (done[j]) continue;
+      double area = intersectionArea(&input->at(best), &input->at(j));
+      if (area <= 0) continue;
+      double iou = area / (input->at(best).getArea() +
+                           input->at(j).getArea() - area);
+      if (options.method == kNmsLinear) {
+        if (iou > options.iou_threshold) scores[j] *= 1. - iou;
+      } else {
+        scores[j] *= std::exp(-iou * iou / options.sigma);
+      }
+    }
+  }
+  return kept;
+}
+}  // namespace
+
+TEST(SoftNmsTest, LinearDecay) {
+  // IoU of the two squares is 1/3
+  std::vector<ConvexHull> hulls = {square(0., 0., 2., 0),
+                                   square(1., 0., 2., 1),
+                                   square(5., 5., 1., 2)};
+  std::vector<double> scores = {0.9, 0.8, 0.1};
+  NmsOptions options;
+  options.method = kNmsLinear;
+  options.iou_threshold = 0.3;
+  std::vector<double> kept_scores;
+  std::vector<int> kept =
+      nonMaximumSuppression(&hulls, scores, options, &kept_scores);
+  // Decayed hull 1 still ranks above hull 2
+  ASSERT_EQ(kept, std::vector<int>({0, 1, 2}));
+  EXPECT_DOUBLE_EQ(kept_scores[1], 0.8 * (1. - 1. / 3));
+  EXPECT_DOUBLE_EQ(kept_scores[2], 0.1);
+
+  // Below the threshold the score is not decayed
+  options.iou_threshold = 0.5;
+  nonMaximumSuppression(&hulls, scores, options, &kept_scores);
+  EXPECT_DOUBLE_EQ(kept_scores[1], 0.8);
+
+  // Decayed below score_threshold, hull 1 is dropped
+  options.iou_threshold = 0.3;
+  options.score_threshold = 0.6;
+  EXPECT_EQ(nonMaximumSuppression(&hulls, scores, options),
+            std::vector<int>({0}));
+}
+
+TEST(SoftNmsTest, MatchesBruteForce) {
+  std::vector<ConvexHull> hulls = randomHulls(400, 6, 30.);
+  std::vector<double> scores = randomScores(hulls.size(), 4);
+  for (NmsMethod method : {kNmsLinear, kNmsGaussian}) {
+    NmsOptions options;
+    options.method = method;
+    options.iou_threshold = 0.2;
+    options.score_threshold = 0.05;
+    options.cell_size = 4.;
+    std::vector<double> kept_scores, expected_scores;
+    std::vector<int> kept =
+        nonMaximumSuppression(&hulls, scores, options, &kept_scores);
+    std::vector<int> expected =
+        bruteForceSoftNms(&hulls, scores, options, &expected_scores);
+    EXPECT_EQ(kept, expected) << method;
+    ASSERT_EQ(kept_scores.size(), expected_scores.size());
+    for (int k = 0; k < kept_scores.size(); ++k)
+      EXPECT_DOUBLE_EQ(kept_scores[k], expected_scores[k]);
+  }
+}
+
+TEST(SoftNmsTest, MethodFromName) {
+  EXPECT_EQ(nmsMethodFromName("linear"), kNmsLinear);
+  EXPECT_EQ(nmsMethodFromName("gaussian"), kNmsGaussian);
+  EXPECT_EQ(nmsMethodFromName("hard"), kNmsHard);
+  EXPECT_THROW(nmsMethodFromName("soft"), std::invalid_argument);
+  EXPECT_THROW(nmsMethodFromName(""), std::invalid_argument);
+}
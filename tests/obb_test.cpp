@@ -0,0 +1,118 @@
+#include "obb.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+std::vector<OrientedBox> randomBoxes(int n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> position(0., 20.);
+  std::uniform_real_distribution<double> extent(0.5, 3.);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+  std::vector<OrientedBox> boxes;
+  for (int i = 0; i < n; ++i) {
+    boxes.push_back(OrientedBox(position(gen), position(gen), extent(gen),
+                                extent(gen), angle(gen), i));
+  }
+  return boxes;
+}
+}  // namespace
+
+TEST(OBBTest, CornersAndArea) {
+  OrientedBox box(1., 2., 2., 1., M_PI / 2, 0);
+  Point corners[4];
+  box.getCorners(corners);
+  // Rotated by 90 degrees the long side is vertical
+  EXPECT_NEAR(corners[0].x, 2., 1e-12);
+  EXPECT_NEAR(corners[0].y, 0., 1e-12);
+  EXPECT_NEAR(corners[2].x, 0., 1e-12);
+  EXPECT_NEAR(corners[2].y, 4., 1e-12);
+  EXPECT_DOUBLE_EQ(box.getArea(), 8.);
+  EXPECT_NEAR(box.toConvexHull().getArea(), 8., 1e-12);
+
+  BoundingBox aabb = box.getBoundingBox();
+  EXPECT_NEAR(aabb.min_x, 0., 1e-12);
+  EXPECT_NEAR(aabb.max_y, 4., 1e-12);
+}
+
+TEST(OBBTest, AxisAlignedOverlap) {
+  OrientedBox A(0., 0., 1., 1., 0., 0);
+  OrientedBox B(1., 1., 1., 1., 0., 1);
+  OrientedBox C(3., 0., 0.5, 0.5, 0., 2);
+  EXPECT_TRUE(obbsOverlap(A, B));
+  EXPECT_FALSE(obbsOverlap(A, C));
+  EXPECT_NEAR(obbIntersectionArea(A, B), 1., 1e-12);
+  EXPECT_EQ(obbIntersectionArea(A, C), 0.);
+  EXPECT_TRUE(isPointInsideOBB(A, Point(0.5, -0.5)));
+  EXPECT_FALSE(isPointInsideOBB(A, Point(1.5, 0.)));
+}
+
+TEST(OBBTest, MatchesGeneralPolygonPath) {
+  std::vector<OrientedBox> boxes = randomBoxes(60, 7);
+  for (int i = 0; i < boxes.size(); ++i) {
+    ConvexHull hull_i = boxes[i].toConvexHull();
+    for (int j = 0; j < boxes.size(); ++j) {
+      if (i == j) continue;
+      ConvexHull hull_j = boxes[j].toConvexHull();
+      double expected = intersectionArea(&hull_i, &hull_j);
+      EXPECT_NEAR(obbIntersectionArea(boxes[i], boxes[j]), expected, 1e-9);
+      EXPECT_NEAR(obbHullIntersectionArea(boxes[i], hull_j), expected, 1e-9);
+      // Separating axis test agrees with the clipped area
+      if (expected > 1e-9) EXPECT_TRUE(obbsOverlap(boxes[i], boxes[j]));
+    }
+  }
+}
+
+TEST(OBBTest, HullWithManyVertices) {
+  // 40-gon approximating a circle of radius 2, containing a unit box
+  std::vector<Point> vertices;
+  for (int i = 0; i < 40; ++i) {
+    double a = 2 * M_PI * i / 40;
+    vertices.push_back(Point(2 * std::cos(a), 2 * std::sin(a)));
+  }
+  ConvexHull circle(vertices, 0);
+  OrientedBox inside(0.2, -0.1, 0.5, 0.5, 0.3, 1);
+  EXPECT_NEAR(obbHullIntersectionArea(inside, circle), 1., 1e-12);
+
+  OrientedBox around(0., 0., 3., 3., 0.7, 2);
+  EXPECT_NEAR(obbHullIntersectionArea(around, circle), circle.getArea(),
+              1e-9);
+}
+
+TEST(OBBTest, CollinearApexesOnBoxSide) {
+  // The box itself, with 300 apexes along its top side: after the rotation
+  // into the box frame they scatter around the side by rounding, and every
+  // one of them can cross it
+  OrientedBox box(3., -2., 2., 1., 0.3, 0);
+  Point corners[4];
+  box.getCorners(corners);
+  std::vector<Point> vertices(corners, corners + 3);
+  for (int k = 1; k < 300; ++k) {
+    double t = k / 300.;
+    vertices.push_back(Point(corners[2].x + t * (corners[3].x - corners[2].x),
+                             corners[2].y + t * (corners[3].y - corners[2].y)));
+  }
+  vertices.push_back(corners[3]);
+  ConvexHull hull(vertices, 1);
+  EXPECT_NEAR(obbHullIntersectionArea(box, hull), box.getArea(), 1e-9);
+  EXPECT_NEAR(obbIntersectionArea(box, box), box.getArea(), 1e-9);
+}
+
+TEST(OBBTest, EliminationMatchesConvexHulls) {
+  std::vector<OrientedBox> boxes = randomBoxes(200, 3);
+  std::vector<ConvexHull> hulls;
+  for (const OrientedBox &b : boxes) hulls.push_back(b.toConvexHull());
+
+  std::vector<OrientedBox> remaining = eliminateOverlappingOBBs(&boxes, 0.1);
+  std::vector<ConvexHull> expected = eliminateOverlappingCHulls(&hulls, 0.1);
+  ASSERT_EQ(remaining.size(), expected.size());
+  for (int i = 0; i < remaining.size(); ++i)
+    EXPECT_EQ(remaining[i].id, expected[i].id);
+}
+
+TEST(OBBTest, FloatBoxes) {
+  OrientedBoxF A(0.f, 0.f, 1.f, 1.f, 0.f, 0);
+  OrientedBoxF B(1.f, 0.f, 1.f, 1.f, static_cast<float>(M_PI / 2), 1);
+  EXPECT_NEAR(obbIntersectionArea(A, B), 2.f, 1e-5);
+}
@@ -0,0 +1,115 @@
+#include "overlap_matrix.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "instrumentation.hpp"
+#include "test_hulls.hpp"
+
+namespace {
+// Reference: every pair, one thread
+OverlapMatrix bruteForceMatrix(std::vector<ConvexHull> *rows,
+                               std::vector<ConvexHull> *cols) {
+  OverlapMatrix matrix;
+  matrix.n_rows = rows->size();
+  matrix.n_cols = cols->size();
+  for (int i = 0; i < rows->size(); ++i) {
+    for (int j = 0; j < cols->size(); ++j) {
+      double area = intersectionArea(&rows->at(i), &cols->at(j));
+      if (area <= 0) continue;
+      double iou =
+          area / (rows->at(i).getArea() + cols->at(j).getArea() - area);
+      matrix.entries.push_back(OverlapEntry(i, j, area, iou));
+    }
+  }
+  return matrix;
+}
+
+void expectSameMatrix(const OverlapMatrix &A, const OverlapMatrix &B) {
+  ASSERT_EQ(A.getNEntries(), B.getNEntries());
+  for (int k = 0; k < A.getNEntries(); ++k) {
+    EXPECT_EQ(A.entries[k].i, B.entries[k].i);
+    EXPECT_EQ(A.entries[k].j, B.entries[k].j);
+    EXPECT_DOUBLE_EQ(A.entries[k].intersection_area,
+                     B.entries[k].intersection_area);
+    EXPECT_DOUBLE_EQ(A.entries[k].iou, B.entries[k].iou);
+  }
+}
+}  // namespace
+
+TEST(ThreadPoolTest, ParallelForCoversEveryIndexOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> visits(1000);
+  for (auto &v : visits) v = 0;
+  pool.parallelFor(1000, 7, [&](int begin, int end) {
+    for (int i = begin; i < end; ++i) ++visits[i];
+  });
+  for (auto &v : visits) EXPECT_EQ(v, 1);
+
+  // Nested loops from the workers must not deadlock
+  std::atomic<int> total(0);
+  pool.parallelFor(8, 1, [&](int, int) {
+    pool.parallelFor(100, 10, [&](int begin, int end) {
+      total += end - begin;
+    });
+  });
+  EXPECT_EQ(total, 800);
+
+  std::future<void> done = pool.submit([&] { total = -1; });
+  done.get();
+  EXPECT_EQ(total, -1);
+}
+
+TEST(OverlapMatrixTest, MatchesBruteForce) {
+  std::vector<ConvexHull> detections = randomHulls(300, 1);
+  std::vector<ConvexHull> tracks = randomHulls(200, 2);
+  OverlapMatrix expected = bruteForceMatrix(&detections, &tracks);
+  ASSERT_GT(expected.getNEntries(), 0);
+
+  OverlapMatrix serial = computeOverlapMatrix(&detections, &tracks);
+  EXPECT_EQ(serial.n_rows, 300);
+  EXPECT_EQ(serial.n_cols, 200);
+  expectSameMatrix(serial, expected);
+
+  ThreadPool pool(3);
+  expectSameMatrix(computeOverlapMatrix(&detections, &tracks, &pool, 4.),
+                   expected);
+}
+
+TEST(OverlapMatrixTest, IdenticalSetsHaveUnitDiagonal) {
+  std::vector<ConvexHull> hulls = randomHulls(50, 9);
+  std::vector<ConvexHull> same = hulls;
+  OverlapMatrix matrix = computeOverlapMatrix(&hulls, &same);
+  int n_diagonal = 0;
+  for (const OverlapEntry &e : matrix.entries) {
+    EXPECT_GT(e.iou, 0.);
+    EXPECT_LE(e.iou, 1. + 1e-12);
+    if (e.i == e.j) {
+      EXPECT_NEAR(e.iou, 1., 1e-9);
+      ++n_diagonal;
+    }
+  }
+  EXPECT_EQ(n_diagonal, 50);
+
+  std::vector<ConvexHull> empty;
+  EXPECT_EQ(computeOverlapMatrix(&hulls, &empty).getNEntries(), 0);
+}
+
+TEST(OverlapMatrixTest, PoolThreadsCountEveryPair) {
+  // Every thread counts on its own, the totals match the serial run
+  if (!stats::isEnabled()) return;
+  std::vector<ConvexHull> detections = randomHulls(300, 3);
+  std::vector<ConvexHull> tracks = randomHulls(300, 4);
+  stats::reset();
+  computeOverlapMatrix(&detections, &tracks, nullptr, 4.);
+  uint64_t considered = stats::getCount(stats::kPairsConsidered);
+  uint64_t intersected = stats::getCount(stats::kPairsIntersected);
+  ASSERT_GT(intersected, 0);
+
+  ThreadPool pool(4);
+  stats::reset();
+  computeOverlapMatrix(&detections, &tracks, &pool, 4.);
+  EXPECT_EQ(stats::getCount(stats::kPairsConsidered), considered);
+  EXPECT_EQ(stats::getCount(stats::kPairsIntersected), intersected);
+}
@@ -0,0 +1,83 @@
+#include "predicates.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+TEST(PredicatesTest, SimpleOrientations) {
+  Point a(0., 0.), b(1., 0.);
+  EXPECT_GT(predicates::orient2d(a, b, Point(0.5, 1.)), 0.);
+  EXPECT_LT(predicates::orient2d(a, b, Point(0.5, -1.)), 0.);
+  EXPECT_EQ(predicates::orient2d(a, b, Point(3., 0.)), 0.);
+  EXPECT_EQ(predicates::orientation(a, b, Point(0.5, 1.)), 1);
+}
+
+TEST(PredicatesTest, NearlyCollinearGrid) {
+  // Points a few ulps away from the line y = x: the exact orientation is
+  // the sign of py - px, which the naive determinant often gets wrong
+  Point b(12., 12.), c(24., 24.);
+  double ulp = std::nextafter(0.5, 1.) - 0.5;
+  for (int i = 0; i < 64; ++i) {
+    for (int j = 0; j < 64; ++j) {
+      Point p(0.5 + i * ulp, 0.5 + j * ulp);
+      int expected = (j > i) - (j < i);
+      ASSERT_EQ(predicates::orientation(p, b, c), expected) << i << " " << j;
+    }
+  }
+}
+
+TEST(PredicatesTest, ExactAgreesWithFilter) {
+  // Far from degenerate both paths give the same sign
+  EXPECT_GT(predicates::orient2dExact(0., 0., 1., 0., 0.3, 2.), 0.);
+  EXPECT_LT(predicates::orient2dExact(0., 0., 1., 0., 0.3, -2.), 0.);
+  EXPECT_EQ(predicates::orient2dExact(1., 1., 2., 2., 3., 3.), 0.);
+  EXPECT_EQ(predicates::orient2dExact(0.1, 0.1, 0.2, 0.2, 0.3, 0.3) > 0,
+            predicates::orient2d(0.1, 0.1, 0.2, 0.2, 0.3, 0.3) > 0);
+}
+
+TEST(PredicatesTest, SegmentsTouchingAndCollinear) {
+  double t;
+  // Endpoint on the other segment
+  EXPECT_TRUE(predicates::segmentsCross(Point(0., 0.), Point(2., 0.),
+                                        Point(1., 0.), Point(1., 3.), &t));
+  EXPECT_DOUBLE_EQ(t, 0.5);
+  // Collinear overlapping segments do not intersect
+  EXPECT_FALSE(predicates::segmentsCross(Point(0., 0.), Point(2., 0.),
+                                         Point(1., 0.), Point(3., 0.), &t));
+  EXPECT_FALSE(predicates::segmentsCross(Point(0., 0.), Point(1., 0.),
+                                         Point(2., -1.), Point(2., 1.), &t));
+}
+
+TEST(PredicatesTest, TinySegmentsIntersect) {
+  // The old parallel test rejected every pair with |det| < 1e-5, so
+  // millimetre sized segments never intersected
+  Point p1(0., 0.), p2(1e-3, 1e-3), p3(0., 1e-3), p4(1e-3, 0.);
+  Line L1(p1, p2);
+  Line L2(p3, p4);
+  Point intersection;
+  ASSERT_TRUE(segmentsIntersect(&L1, &L2, &intersection));
+  EXPECT_NEAR(intersection.x, 5e-4, 1e-15);
+  EXPECT_NEAR(intersection.y, 5e-4, 1e-15);
+}
+
+TEST(PredicatesTest, IntersectionAreaIsScaleInvariant) {
+  // Octagons go through the general intersection path
+  auto octagon = [](double cx, double cy, double scale) {
+    std::vector<Point> vertices;
+    for (int i = 0; i < 8; ++i) {
+      double a = 2 * M_PI * i / 8 + 0.2;
+      vertices.push_back(
+          Point(scale * (cx + std::cos(a)), scale * (cy + std::sin(a))));
+    }
+    return vertices;
+  };
+  ConvexHull A(octagon(0., 0., 1.), 0), B(octagon(0.7, 0.4, 1.), 1);
+  double reference = intersectionArea(&A, &B);
+  ASSERT_GT(reference, 0.);
+  for (double scale : {1e-4, 1e-2, 1e3}) {
+    ConvexHull As(octagon(0., 0., scale), 0), Bs(octagon(0.7, 0.4, scale), 1);
+    EXPECT_NEAR(intersectionArea(&As, &Bs) / (scale * scale), reference,
+                1e-9 * reference)
+        << scale;
+  }
+}
@@ -0,0 +1,106 @@
+#include "quantization.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_hulls.hpp"
+
+namespace {
+// Hulls with every vertex on the grid, so both engines see the same polygons
+std::vector<ConvexHull> gridHulls(int n, unsigned seed, double resolution) {
+  std::vector<ConvexHull> hulls;
+  for (const ConvexHull &c : randomHulls(n, seed)) {
+    std::vector<Point> apexes;
+    for (const Point &p : c.apex) {
+      apexes.push_back(Point(std::round(p.x / resolution) * resolution,
+                             std::round(p.y / resolution) * resolution));
+    }
+    hulls.push_back(ConvexHull(apexes, c.id));
+  }
+  return hulls;
+}
+}  // namespace
+
+TEST(QuantizationTest, QuantizeAndClamp) {
+  Quantizer quantizer(0.01, 5., -5.);
+  bool clamped;
+  EXPECT_EQ(quantizer.quantize(5.123, 5., &clamped), 12);
+  EXPECT_FALSE(clamped);
+  EXPECT_EQ(quantizer.quantize(-5.126, -5., &clamped), -13);
+  EXPECT_NEAR(quantizer.dequantize(12, 5.), 5.12, 1e-12);
+  EXPECT_EQ(quantizer.quantize(1e30, 0., &clamped), kMaxQuantized);
+  EXPECT_TRUE(clamped);
+  EXPECT_EQ(quantizer.quantize(-1e30, 0., &clamped), -kMaxQuantized);
+  EXPECT_TRUE(clamped);
+}
+
+TEST(QuantizationTest, ExactAreaAndContainment) {
+  const int32_t xs[] = {0, 4, 4, 0}, ys[] = {0, 0, 3, 3};
+  QuantizedHull square(xs, ys, 4, 1);
+  EXPECT_EQ(square.area2, 24);
+  EXPECT_DOUBLE_EQ(square.getArea(), 12.);
+  EXPECT_TRUE(square.isPointInside(1, 1));
+  EXPECT_FALSE(square.isPointInside(4, 1));  // on the boundary
+  EXPECT_FALSE(square.isPointInside(5, 1));
+
+  // Clockwise vertices and coordinates at the edge of the range
+  const int32_t big_x[] = {-kMaxQuantized, -kMaxQuantized, kMaxQuantized};
+  const int32_t big_y[] = {-kMaxQuantized, kMaxQuantized, kMaxQuantized};
+  QuantizedHull big(big_x, big_y, 3, 2);
+  EXPECT_LT(big.area2, 0);
+  EXPECT_TRUE(big.isPointInside(-kMaxQuantized + 1, kMaxQuantized - 1));
+  EXPECT_FALSE(big.isPointInside(1, 0));
+  EXPECT_FALSE(big.isPointInside(0, 0));
+}
+
+TEST(QuantizationTest, ReportFromJson) {
+  std::vector<ConvexHull> hulls = randomHulls(100, 5);
+  json data = convexHullsToJson(hulls);
+
+  Quantizer quantizer(0.001);
+  QuantizationReport report;
+  std::vector<QuantizedHull> quantized =
+      convexHullsFromJson(data, quantizer, &report);
+  ASSERT_EQ(quantized.size(), hulls.size());
+  EXPECT_EQ(report.n_vertices, 400);
+  EXPECT_EQ(report.n_clamped, 0);
+  EXPECT_GT(report.max_error, 0.);
+  EXPECT_LE(report.max_error, report.error_bound);
+  EXPECT_LE(report.getMeanError(), report.max_error);
+  EXPECT_LT(report.max_area_error, 1e-2);
+
+  for (int i = 0; i < hulls.size(); ++i) {
+    ConvexHull back = dequantize(quantized[i], quantizer);
+    EXPECT_EQ(back.id, hulls[i].id);
+    for (int a = 0; a < back.getNvertices(); ++a) {
+      EXPECT_NEAR(back.apex[a].x, hulls[i].apex[a].x, report.error_bound);
+      EXPECT_NEAR(back.apex[a].y, hulls[i].apex[a].y, report.error_bound);
+    }
+  }
+}
+
+TEST(QuantizationTest, MatchesFloatingPointEngine) {
+  double resolution = 1. / 64;
+  std::vector<ConvexHull> hulls = gridHulls(300, 11, resolution);
+  json data = convexHullsToJson(hulls);
+  Quantizer quantizer(resolution);
+  QuantizationReport report;
+  std::vector<QuantizedHull> quantized =
+      convexHullsFromJson(data, quantizer, &report);
+  EXPECT_EQ(report.max_error, 0.);
+
+  double cell_area = resolution * resolution;
+  for (int i = 0; i < 40; ++i) {
+    for (int j = i + 1; j < 40; ++j) {
+      double expected = intersectionArea(&hulls[i], &hulls[j]);
+      EXPECT_NEAR(intersectionArea(quantized[i], quantized[j]) * cell_area,
+                  expected, 1e-9);
+    }
+  }
+
+  std::vector<int> expected_ids =
+      hullIds(eliminateOverlappingCHulls(&hulls, 0.5));
+  std::vector<int> ids;
+  for (const QuantizedHull &c : eliminateOverlappingCHulls(&quantized, 0.5))
+    ids.push_back(c.id);
+  EXPECT_EQ(ids, expected_ids);
+}
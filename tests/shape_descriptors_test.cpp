@@ -0,0 +1,268 @@
+#include "shape_descriptors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "binary_format.hpp"
+#include "hull_generator.hpp"
+#include "obb.hpp"
+
+namespace {
+struct Expected {
+  double diameter = 0, min_width = INFINITY, rect_area = INFINITY;
+};
+
+// Descriptors by brute force: all vertex pairs for the diameter, every edge
+// direction for the width and the rectangle
+Expected bruteForceDescriptors(const ConvexHull &hull) {
+  Expected descriptors;
+  int n = hull.apex.size();
+  for (int i = 0; i < n; ++i) {
+    const Point &p = hull.apex[i], &q = hull.apex[(i + 1) % n];
+    for (int k = 0; k < n; ++k) {
+      descriptors.diameter =
+          std::max(descriptors.diameter, std::hypot(hull.apex[k].x - p.x,
+                                                    hull.apex[k].y - p.y));
+    }
+    double length = std::hypot(q.x - p.x, q.y - p.y);
+    double ux = (q.x - p.x) / length, uy = (q.y - p.y) / length;
+    double min_along = INFINITY, max_along = -INFINITY, height = 0;
+    for (const Point &v : hull.apex) {
+      double along = ux * (v.x - p.x) + uy * (v.y - p.y);
+      min_along = std::min(min_along, along);
+      max_along = std::max(max_along, along);
+      height = std::max(height, std::abs(ux * (v.y - p.y) - uy * (v.x - p.x)));
+    }
+    descriptors.min_width = std::min(descriptors.min_width, height);
+    descriptors.rect_area =
+        std::min(descriptors.rect_area, (max_along - min_along) * height);
+  }
+  return descriptors;
+}
+
+void expectNearDescriptors(const HullDescriptors &a, const HullDescriptors &b,
+                           double tolerance) {
+  EXPECT_NEAR(a.diameter, b.diameter, tolerance);
+  EXPECT_NEAR(a.min_width, b.min_width, tolerance);
+  EXPECT_NEAR(a.centroid.x, b.centroid.x, tolerance);
+  EXPECT_NEAR(a.centroid.y, b.centroid.y, tolerance);
+  EXPECT_NEAR(a.rect_center.x, b.rect_center.x, tolerance);
+  EXPECT_NEAR(a.rect_center.y, b.rect_center.y, tolerance);
+  EXPECT_NEAR(a.rect_half_x, b.rect_half_x, tolerance);
+  EXPECT_NEAR(a.rect_half_y, b.rect_half_y, tolerance);
+  EXPECT_NEAR(a.rect_yaw, b.rect_yaw, tolerance);
+}
+}  // namespace
+
+TEST(ShapeDescriptorsTest, Rectangle) {
+  ConvexHull rectangle(
+      {Point(1, 1), Point(5, 1), Point(5, 3), Point(3, 3), Point(1, 3)}, 0);
+  const HullDescriptors &descriptors = rectangle.getDescriptors();
+  EXPECT_NEAR(descriptors.diameter, std::hypot(4., 2.), 1e-12);
+  EXPECT_NEAR(descriptors.min_width, 2., 1e-12);
+  EXPECT_NEAR(descriptors.centroid.x, 3., 1e-12);
+  EXPECT_NEAR(descriptors.centroid.y, 2., 1e-12);
+  EXPECT_NEAR(descriptors.rect_center.x, 3., 1e-12);
+  EXPECT_NEAR(descriptors.rect_center.y, 2., 1e-12);
+  EXPECT_NEAR(descriptors.getRectArea(), 8., 1e-12);
+
+  // Same rectangle rotated by 30 degrees around the origin, and ordered CW
+  double c = std::cos(M_PI / 6), s = std::sin(M_PI / 6);
+  std::vector<Point> rotated;
+  for (int k = rectangle.apex.size() - 1; k >= 0; --k) {
+    const Point &p = rectangle.apex[k];
+    rotated.push_back(Point(c * p.x - s * p.y, s * p.x + c * p.y));
+  }
+  HullDescriptors r = computeHullDescriptors(rotated.data(), rotated.size());
+  EXPECT_NEAR(r.diameter, descriptors.diameter, 1e-12);
+  EXPECT_NEAR(r.min_width, 2., 1e-12);
+  EXPECT_NEAR(r.centroid.x, 3 * c - 2 * s, 1e-12);
+  EXPECT_NEAR(r.centroid.y, 3 * s + 2 * c, 1e-12);
+  EXPECT_NEAR(r.rect_center.x, 3 * c - 2 * s, 1e-12);
+  EXPECT_NEAR(r.getRectArea(), 8., 1e-12);
+  // The rectangle is aligned with the rotated sides
+  double yaw = std::fmod(r.rect_yaw + 2 * M_PI, M_PI / 2);
+  EXPECT_NEAR(yaw, M_PI / 6, 1e-12);
+
+  // Degenerate polygons
+  Point point[] = {Point(2, 3), Point(2, 3), Point(2, 3)};
+  HullDescriptors d = computeHullDescriptors(point, 3);
+  EXPECT_EQ(d.diameter, 0.);
+  EXPECT_EQ(d.min_width, 0.);
+  EXPECT_EQ(d.centroid.x, 2.);
+  Point segment[] = {Point(0, 0), Point(2, 0), Point(4, 0)};
+  d = computeHullDescriptors(segment, 3);
+  EXPECT_NEAR(d.diameter, 4., 1e-12);
+  EXPECT_EQ(d.min_width, 0.);
+}
+
+TEST(ShapeDescriptorsTest, MatchesBruteForce) {
+  HullGeneratorOptions options;
+  options.count = 300;
+  options.seed = 5;
+  options.max_vertices = 40;
+  for (ConvexHull &hull : generateConvexHulls(options)) {
+    const HullDescriptors &descriptors = hull.getDescriptors();
+    Expected expected = bruteForceDescriptors(hull);
+    EXPECT_NEAR(descriptors.diameter, expected.diameter, 1e-9);
+    EXPECT_NEAR(descriptors.min_width, expected.min_width, 1e-9);
+    EXPECT_NEAR(descriptors.getRectArea(), expected.rect_area, 1e-9);
+    // Every vertex is inside the rectangle, and the centroid inside the hull
+    OrientedBox rectangle = minAreaRectangle(descriptors);
+    rectangle.half_x += 1e-9;
+    rectangle.half_y += 1e-9;
+    for (const Point &p : hull.apex)
+      EXPECT_TRUE(isPointInsideOBB(rectangle, p));
+    EXPECT_TRUE(hull.isPointInside(descriptors.centroid));
+  }
+}
+
+TEST(ShapeDescriptorsTest, Float) {
+  // Far from the origin, where float coordinates only keep a few decimals
+  const PointF apex[] = {PointF(1000, 1000), PointF(1004, 1000),
+                         PointF(1004, 1002), PointF(1000, 1002)};
+  HullDescriptorsF descriptors = computeHullDescriptors(apex, 4);
+  EXPECT_FLOAT_EQ(descriptors.min_width, 2.f);
+  EXPECT_FLOAT_EQ(descriptors.centroid.x, 1002.f);
+  EXPECT_FLOAT_EQ(descriptors.getRectArea(), 8.f);
+}
+
+TEST(ShapeDescriptorsTest, CachedAndSerialized) {
+  HullGeneratorOptions options;
+  options.count = 20;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  EXPECT_EQ(hulls[0].getCachedDescriptors(), nullptr);
+  // Json without descriptors is unchanged
+  EXPECT_EQ(convexHullsToJson(hulls)["convex hulls"][0].count("descriptors"),
+            0);
+  for (int i = 0; i < hulls.size(); i += 2) hulls[i].getDescriptors();
+  EXPECT_NE(hulls[0].getCachedDescriptors(), nullptr);
+  EXPECT_EQ(hulls[1].getCachedDescriptors(), nullptr);
+
+  std::vector<ConvexHull> from_json =
+      convexHullsFromJson(json::parse(convexHullsToJson(hulls).dump()));
+  std::string encoded;
+  encodeHulls(hulls, &encoded);
+  std::vector<ConvexHull> from_binary;
+  ASSERT_TRUE(decodeHulls(encoded.data(), encoded.size(), &from_binary));
+  ASSERT_EQ(from_json.size(), hulls.size());
+  ASSERT_EQ(from_binary.size(), hulls.size());
+  for (int i = 0; i < hulls.size(); ++i) {
+    const HullDescriptors *cached = hulls[i].getCachedDescriptors();
+    ASSERT_EQ(from_json[i].getCachedDescriptors() != nullptr, !!cached);
+    ASSERT_EQ(from_binary[i].getCachedDescriptors() != nullptr, !!cached);
+    if (!cached) continue;
+    expectNearDescriptors(*from_json[i].getCachedDescriptors(), *cached,
+                          1e-12);
+    expectNearDescriptors(*from_binary[i].getCachedDescriptors(), *cached,
+                          0.);
+  }
+  // Truncated descriptors are rejected
+  EXPECT_FALSE(decodeHulls(encoded.data(), encoded.size() - 8, &from_binary));
+
+  // Sets without descriptors keep the first version of the format
+  std::vector<ConvexHull> plain(1, hulls[1]);
+  encodeHulls(plain, &encoded);
+  uint32_t magic;
+  std::memcpy(&magic, encoded.data(), sizeof(magic));
+  EXPECT_EQ(magic, kBinaryHullsMagic);
+
+  // Changing the apexes drops the cache
+  std::vector<Point> square = {Point(0, 0), Point(1, 0), Point(1, 1),
+                               Point(0, 1)};
+  hulls[0].set_apexes(square);
+  EXPECT_EQ(hulls[0].getCachedDescriptors(), nullptr);
+  EXPECT_NEAR(hulls[0].getDescriptors().min_width, 1., 1e-12);
+}
+
+TEST(ShapeDescriptorsTest, RectanglePreTest) {
+  // Two thin diagonal bars: the axis aligned boxes overlap, the minimum area
+  // rectangles do not
+  ConvexHull A({Point(0, 0), Point(0.5, 0), Point(10.5, 10), Point(10, 10)}, 0);
+  ConvexHull B({Point(2, 0), Point(2.5, 0), Point(12.5, 10), Point(12, 10)}, 1);
+  EXPECT_FALSE(minAreaRectanglesSeparated(A, B));  // nothing cached
+  A.getDescriptors();
+  B.getDescriptors();
+  EXPECT_TRUE(minAreaRectanglesSeparated(A, B));
+  ConvexHull C({Point(0, 5), Point(10, 5), Point(10, 6), Point(0, 6)}, 2);
+  C.getDescriptors();
+  EXPECT_FALSE(minAreaRectanglesSeparated(A, C));
+
+  // The pre-test does not change the elimination
+  HullGeneratorOptions options;
+  options.count = 200;
+  options.overlap_density = 6.;
+  std::vector<ConvexHull> hulls = generateConvexHulls(options);
+  std::vector<ConvexHull> expected = eliminateOverlappingCHulls(&hulls, 0.3);
+  for (ConvexHull &c : hulls) {
+    c.getDescriptors();
+    OrientedBox rectangle;
+    EXPECT_TRUE(trustedMinAreaRectangle(c, &rectangle));
+  }
+  std::vector<ConvexHull> remaining = eliminateOverlappingCHulls(&hulls, 0.3);
+  ASSERT_EQ(remaining.size(), expected.size());
+  for (int i = 0; i < remaining.size(); ++i)
+    EXPECT_EQ(remaining[i].id, expected[i].id);
+}
+
+TEST(ShapeDescriptorsTest, UntrustedInput) {
+  // A rectangle moved away from its hull is read back as it was written,
+  // but it must not make the elimination skip the overlap
+  ConvexHull A({Point(0, 0), Point(2, 0), Point(2, 2), Point(0, 2)}, 0);
+  ConvexHull B({Point(1, 1), Point(3, 1), Point(3, 3), Point(1, 3)}, 1);
+  std::vector<ConvexHull> hulls = {A, B};
+  HullDescriptors forged = hulls[0].getDescriptors();
+  forged.rect_center = Point(100., 100.);
+  hulls[0].setDescriptors(forged);
+
+  std::vector<ConvexHull> from_json =
+      convexHullsFromJson(convexHullsToJson(hulls));
+  std::string encoded;
+  encodeHulls(hulls, &encoded);
+  std::vector<ConvexHull> from_binary;
+  ASSERT_TRUE(decodeHulls(encoded.data(), encoded.size(), &from_binary));
+  for (std::vector<ConvexHull> *loaded : {&from_json, &from_binary}) {
+    ASSERT_NE(loaded->at(0).getCachedDescriptors(), nullptr);
+    expectNearDescriptors(*loaded->at(0).getCachedDescriptors(), forged, 0.);
+    OrientedBox rectangle;
+    EXPECT_FALSE(trustedMinAreaRectangle(loaded->at(0), &rectangle));
+    loaded->at(1).getDescriptors();
+    EXPECT_FALSE(minAreaRectanglesSeparated(loaded->at(0), loaded->at(1)));
+    EXPECT_EQ(eliminateOverlappingCHulls(loaded, 0.2).size(), 0);
+  }
+
+  // Descriptors left stale by editing apex directly are not trusted either
+  ConvexHull C({Point(10, 0), Point(12, 0), Point(12, 2), Point(10, 2)}, 2);
+  C.getDescriptors();
+  hulls[1].getDescriptors();
+  EXPECT_TRUE(minAreaRectanglesSeparated(hulls[1], C));
+  for (Point &p : C.apex) p.x -= 9.;
+  EXPECT_FALSE(minAreaRectanglesSeparated(hulls[1], C));
+  std::vector<ConvexHull> moved = {hulls[1], C};
+  EXPECT_EQ(eliminateOverlappingCHulls(&moved, 0.2).size(), 0);
+}
+
+TEST(ShapeDescriptorsTest, FloatPreTestFarFromOrigin) {
+  // Float hulls far from the origin: no overlapping pair is reported
+  // separated, although their rectangles are rounded to a few decimals
+  HullGeneratorOptions options;
+  options.count = 300;
+  options.overlap_density = 6.;
+  std::vector<ConvexHullF> hulls;
+  for (const ConvexHull &c : generateConvexHulls(options)) {
+    std::vector<PointF> apexes;
+    for (const Point &p : c.apex)
+      apexes.push_back(PointF(p.x + 20000., p.y - 20000.));
+    hulls.push_back(ConvexHullF(apexes, c.id));
+    hulls.back().getDescriptors();
+    OrientedBoxF rectangle;
+    EXPECT_TRUE(trustedMinAreaRectangle(hulls.back(), &rectangle));
+  }
+  for (int i = 0; i < hulls.size(); ++i) {
+    for (int j = i + 1; j < hulls.size(); ++j) {
+      if (intersectionArea(&hulls[i], &hulls[j]) > 0)
+        EXPECT_FALSE(minAreaRectanglesSeparated(hulls[i], hulls[j]));
+    }
+  }
+}
@@ -0,0 +1,161 @@
+#include "simplification.hpp"
+
+#include <gtest/gtest.h>
+
+#include "hull_generator.hpp"
+#include "predicates.hpp"
+
+namespace {
+std::vector<Point> regularPolygon(int n, double cx, double cy, double r) {
+  std::vector<Point> vertices;
+  for (int i = 0; i < n; ++i) {
+    double a = 2. * M_PI * i / n + 0.1;
+    vertices.push_back(Point(cx + r * std::cos(a), cy + r * std::sin(a)));
+  }
+  return vertices;
+}
+
+// Distance from P to the CCW hull (0 inside)
+double distanceToHull(const ConvexHull &hull, const Point &P) {
+  int n = hull.apex.size();
+  bool inside = true;
+  double distance = INFINITY;
+  for (int i = 0; i < n; ++i) {
+    const Point &a = hull.apex[i], &b = hull.apex[(i + 1) % n];
+    if (predicates::orient2d(a, b, P) < 0) inside = false;
+    double ex = b.x - a.x, ey = b.y - a.y;
+    double t = ((P.x - a.x) * ex + (P.y - a.y) * ey) / (ex * ex + ey * ey);
+    t = std::max(0., std::min(1., t));
+    distance = std::min(distance, std::hypot(a.x + t * ex - P.x,
+                                             a.y + t * ey - P.y));
+  }
+  return inside ? 0. : distance;
+}
+
+// Hausdorff distance between nested convex hulls: the largest distance from
+// a vertex of the larger one to the smaller one
+void expectWithinBound(const ConvexHull &hull, const ConvexHull &simplified,
+                       SimplificationMode mode, double max_error) {
+  const ConvexHull &outer = mode == kSimplifyOuter ? simplified : hull;
+  const ConvexHull &inner = mode == kSimplifyOuter ? hull : simplified;
+  for (const Point &p : inner.apex) EXPECT_LE(distanceToHull(outer, p), 1e-9);
+  for (const Point &p : outer.apex)
+    EXPECT_LE(distanceToHull(inner, p), max_error + 1e-9);
+}
+}  // namespace
+
+TEST(SimplificationTest, RegularPolygon) {
+  ConvexHull hull(regularPolygon(400, 5., -3., 10.), 4);
+  for (SimplificationMode mode : {kSimplifyInner, kSimplifyOuter}) {
+    SimplificationOptions options;
+    options.mode = mode;
+    options.max_error = 0.01;
+    double error;
+    ConvexHull simplified = simplifyConvexHull(hull, options, &error);
+    EXPECT_EQ(simplified.id, 4);
+    EXPECT_LE(error, options.max_error);
+    EXPECT_GT(error, 0.);
+    // A chord of k edges deviates by about r (k pi / n)^2 / 2: k is 5 here
+    EXPECT_LT(simplified.getNvertices(), 100);
+    EXPECT_GT(simplified.getNvertices(), 40);
+    expectWithinBound(hull, simplified, mode, options.max_error);
+    if (mode == kSimplifyInner)
+      EXPECT_LT(simplified.getArea(), hull.getArea());
+    else
+      EXPECT_GT(simplified.getArea(), hull.getArea());
+  }
+}
+
+TEST(SimplificationTest, CollinearVertices) {
+  // A square with 50 vertices on every side, and a CW copy
+  std::vector<Point> apexes;
+  const double corners[4][2] = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+  for (int side = 0; side < 4; ++side) {
+    const double *a = corners[side], *b = corners[(side + 1) % 4];
+    for (int k = 0; k < 50; ++k)
+      apexes.push_back(Point(a[0] + (b[0] - a[0]) * k / 50.,
+                             a[1] + (b[1] - a[1]) * k / 50.));
+  }
+  ConvexHull hull(apexes, 0);
+  ConvexHull cw(std::vector<Point>(apexes.rbegin(), apexes.rend()), 1);
+  for (SimplificationMode mode : {kSimplifyInner, kSimplifyOuter}) {
+    SimplificationOptions options;
+    options.mode = mode;
+    options.max_error = 1e-9;
+    for (const ConvexHull *h : {&hull, &cw}) {
+      ConvexHull simplified = simplifyConvexHull(*h, options);
+      EXPECT_EQ(simplified.getNvertices(), 4);
+      EXPECT_NEAR(simplified.getArea(), 16., 1e-9);
+    }
+  }
+
+  // No error allowed: only the collinear vertices go
+  SimplificationOptions options;
+  ConvexHull octagon(regularPolygon(8, 0., 0., 1.), 0);
+  EXPECT_EQ(simplifyConvexHull(octagon, options).getNvertices(), 8);
+  // A bound larger than the hull still leaves a triangle or the hull
+  options.max_error = 10.;
+  EXPECT_GE(simplifyConvexHull(octagon, options).getNvertices(), 3);
+}
+
+TEST(SimplificationTest, OverlapAreaError) {
+  HullGeneratorOptions generator;
+  generator.count = 200;
+  generator.seed = 3;
+  generator.min_vertices = 20;
+  generator.max_vertices = 80;
+  generator.overlap_density = 6.;
+  std::vector<ConvexHull> hulls = generateConvexHulls(generator);
+  for (SimplificationMode mode : {kSimplifyInner, kSimplifyOuter}) {
+    SimplificationOptions options;
+    options.mode = mode;
+    options.max_error = 0.02;
+    std::vector<ConvexHull> simplified = hulls;
+    SimplificationReport report;
+    simplifyConvexHulls(&simplified, options, &report);
+    EXPECT_EQ(report.n_hulls, hulls.size());
+    EXPECT_GT(report.n_simplified, 0);
+    EXPECT_LT(report.n_vertices_after, report.n_vertices_before);
+    EXPECT_LE(report.max_error, options.max_error);
+    EXPECT_EQ(report.error_bound, options.max_error);
+    EXPECT_GT(report.max_area_change, 0.);
+
+    int n_vertices = 0;
+    for (int i = 0; i < hulls.size(); ++i) {
+      n_vertices += simplified[i].getNvertices();
+      EXPECT_EQ(simplified[i].id, hulls[i].id);
+      expectWithinBound(hulls[i], simplified[i], mode, options.max_error);
+    }
+    EXPECT_EQ(n_vertices, report.n_vertices_after);
+    double error = overlapAreaError(&hulls, &simplified, 2.);
+    EXPECT_GT(error, 0.);
+    EXPECT_LE(error, report.overlap_area_error_bound);
+
+    // Load path
+    std::vector<ConvexHull> loaded =
+        convexHullsFromJson(convexHullsToJson(hulls), options, nullptr);
+    ASSERT_EQ(loaded.size(), simplified.size());
+    for (int i = 0; i < loaded.size(); ++i)
+      EXPECT_EQ(loaded[i].getNvertices(), simplified[i].getNvertices());
+  }
+}
+
+TEST(SimplificationTest, Float) {
+  std::vector<PointF> apexes;
+  for (const Point &p : regularPolygon(100, 0., 0., 5.))
+    apexes.push_back(PointF(p.x, p.y));
+  ConvexHullF hull(apexes, 0);
+  SimplificationOptions options;
+  options.max_error = 0.05;
+  float error;
+  ConvexHullF simplified = simplifyConvexHull(hull, options, &error);
+  EXPECT_LT(simplified.getNvertices(), 50);
+  EXPECT_LE(error, 0.05f);
+}
+
+TEST(SimplificationTest, ModeFromName) {
+  EXPECT_EQ(simplificationModeFromName("outer"), kSimplifyOuter);
+  EXPECT_EQ(simplificationModeFromName("inner"), kSimplifyInner);
+  EXPECT_THROW(simplificationModeFromName("Inner"), std::invalid_argument);
+  EXPECT_THROW(simplificationModeFromName(""), std::invalid_argument);
+}
@@ -0,0 +1,76 @@
+#include "small_vector.hpp"
+
+#include <gtest/gtest.h>
+
+#include "convex_hull.hpp"
+
+TEST(SmallVectorTest, StaysInlineUpToCapacity) {
+  SmallVector<int, 4> v;
+  for (int i = 0; i < 4; ++i) v.push_back(i);
+  EXPECT_TRUE(v.isInline());
+  EXPECT_EQ(v.size(), 4);
+  v.push_back(4);
+  EXPECT_FALSE(v.isInline());
+  EXPECT_EQ(v.size(), 5);
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(v[i], i);
+  EXPECT_THROW(v.at(5), std::out_of_range);
+}
+
+TEST(SmallVectorTest, CopyAndMove) {
+  SmallVector<int, 2> small;
+  small.push_back(1);
+  SmallVector<int, 2> large(std::vector<int>({1, 2, 3}));
+
+  SmallVector<int, 2> small_copy(small);
+  SmallVector<int, 2> large_copy(large);
+  EXPECT_TRUE(small_copy.isInline());
+  EXPECT_EQ(large_copy.size(), 3);
+  EXPECT_NE(large_copy.data(), large.data());
+
+  const int *heap = large.data();
+  SmallVector<int, 2> moved(std::move(large));
+  EXPECT_EQ(moved.data(), heap);  // heap buffer is stolen, not copied
+  EXPECT_TRUE(large.empty());
+  EXPECT_TRUE(large.isInline());
+
+  moved = small_copy;
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_EQ(moved[0], 1);
+  small_copy = std::move(large_copy);
+  EXPECT_EQ(small_copy.size(), 3);
+  EXPECT_EQ(small_copy[2], 3);
+}
+
+TEST(SmallVectorTest, SmallConvexHullsDoNotUseTheHeap) {
+  std::vector<Point> square = {Point(0, 0), Point(1, 0), Point(1, 1),
+                               Point(0, 1)};
+  ConvexHull c(square, 0);
+  ConvexHull copy(c);
+  EXPECT_TRUE(copy.apex.isInline());
+  EXPECT_DOUBLE_EQ(copy.getArea(), 1.);
+
+  std::vector<Point> circle;
+  for (int i = 0; i < 2 * kInlineApexes; ++i) {
+    double a = 2 * M_PI * i / (2 * kInlineApexes);
+    circle.push_back(Point(std::cos(a), std::sin(a)));
+  }
+  ConvexHull large(circle, 1);
+  EXPECT_FALSE(large.apex.isInline());
+  EXPECT_EQ(large.getNvertices(), 2 * kInlineApexes);
+  EXPECT_EQ(large.getNSegments(), 2 * kInlineApexes);
+  EXPECT_TRUE(large.isPointInside(Point(0.1, 0.1)));
+}
+
+TEST(SmallVectorTest, SetApexesRebuildsSegments) {
+  std::vector<Point> triangle = {Point(0, 0), Point(1, 0), Point(0, 1)};
+  std::vector<Point> square = {Point(0, 0), Point(1, 0), Point(1, 1),
+                               Point(0, 1)};
+  ConvexHull c(triangle, 0);
+  c.set_apexes(square);
+  EXPECT_EQ(c.getNSegments(), 4);
+  // The last edge closes the polygon
+  Line last = c.getSegment(3);
+  EXPECT_EQ(last.p1.y, 1.);
+  EXPECT_EQ(last.p2.x, 0.);
+  EXPECT_EQ(last.p2.y, 0.);
+}
@@ -0,0 +1,51 @@
+#include "temporal_eliminator.hpp"
+
+#include <gtest/gtest.h>
+
+#include "test_hulls.hpp"
+
+namespace {
+void translate(ConvexHull *hull, double dx, double dy) {
+  std::vector<Point> apexes(hull->apex.begin(), hull->apex.end());
+  for (Point &p : apexes) p = Point(p.x + dx, p.y + dy);
+  hull->set_apexes(apexes);
+}
+}  // namespace
+
+TEST(TemporalEliminatorTest, FirstFrameMatchesBatch) {
+  std::vector<ConvexHull> frame = randomHulls(200, 3);
+  std::vector<ConvexHull> batch = eliminateOverlappingCHulls(&frame, 0.5);
+
+  TemporalEliminator eliminator(0.5, 1e-3);
+  EXPECT_EQ(hullIds(eliminator.processFrame(&frame)), hullIds(batch));
+  const FrameStats &stats = eliminator.getLastFrameStats();
+  EXPECT_GT(stats.n_pairs, 0);
+  EXPECT_EQ(stats.n_cache_hits, 0);
+  EXPECT_EQ(stats.n_dirty_hulls, 200);
+}
+
+TEST(TemporalEliminatorTest, StaticFrameIsFullyCached) {
+  std::vector<ConvexHull> frame = randomHulls(200, 4);
+  TemporalEliminator eliminator(0.5, 1e-3);
+  std::vector<int> first = hullIds(eliminator.processFrame(&frame));
+  std::vector<int> second = hullIds(eliminator.processFrame(&frame));
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(eliminator.getLastFrameStats().n_recomputed, 0);
+  EXPECT_DOUBLE_EQ(eliminator.getLastFrameStats().getHitRate(), 1.);
+}
+
+TEST(TemporalEliminatorTest, OnlyDirtyPairsAreRecomputed) {
+  std::vector<ConvexHull> frame = randomHulls(200, 5);
+  TemporalEliminator eliminator(0.5, 0.01);
+  eliminator.processFrame(&frame);
+
+  // Small jitter stays within the tolerance, a large move does not
+  translate(&frame[0], 0.005, 0.);
+  translate(&frame[1], 1., 1.);
+  std::vector<ConvexHull> result = eliminator.processFrame(&frame);
+  const FrameStats &stats = eliminator.getLastFrameStats();
+  EXPECT_EQ(stats.n_dirty_hulls, 1);
+  EXPECT_EQ(stats.n_pairs, stats.n_cache_hits + stats.n_recomputed);
+  EXPECT_LT(stats.n_recomputed, stats.n_pairs);
+  EXPECT_EQ(hullIds(result), hullIds(eliminateOverlappingCHulls(&frame, 0.5)));
+}
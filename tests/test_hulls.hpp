@@ -0,0 +1,43 @@
+#ifndef TESTS_TEST_HULLS_HPP_
+#define TESTS_TEST_HULLS_HPP_
+
+#include <convex_hull.hpp>
+#include <random>
+#include <vector>
+
+// Random rotated rectangles, dense enough to get many overlapping pairs
+inline std::vector<ConvexHull> randomHulls(int n, unsigned seed,
+                                           double extent = 50.) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> pos(0., extent);
+  std::uniform_real_distribution<double> size(0.5, 4.);
+  std::uniform_real_distribution<double> yaw(0., M_PI);
+  std::vector<ConvexHull> hulls;
+  for (int n_hull = 0; n_hull < n; ++n_hull) {
+    double cx = pos(gen), cy = pos(gen), hx = size(gen), hy = size(gen);
+    double a = yaw(gen), c = std::cos(a), s = std::sin(a);
+    std::vector<Point> apexes;
+    const double corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (auto &corner : corners) {
+      double x = corner[0] * hx, y = corner[1] * hy;
+      apexes.push_back(Point(cx + c * x - s * y, cy + s * x + c * y));
+    }
+    hulls.push_back(ConvexHull(apexes, n_hull));
+  }
+  return hulls;
+}
+
+// Axis aligned square with its lower left corner at (x, y)
+inline ConvexHull square(double x, double y, double side, int id = 0) {
+  return ConvexHull({Point(x, y), Point(x + side, y),
+                     Point(x + side, y + side), Point(x, y + side)},
+                    id);
+}
+
+inline std::vector<int> hullIds(const std::vector<ConvexHull> &hulls) {
+  std::vector<int> res;
+  for (const ConvexHull &c : hulls) res.push_back(c.id);
+  return res;
+}
+
+#endif  //  TESTS_TEST_HULLS_HPP_
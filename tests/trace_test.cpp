@@ -0,0 +1,88 @@
+#include "trace.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <json.hpp>
+#include <set>
+#include <sstream>
+#include <thread>
+
+TEST(TraceTest, DisabledTracingRecordsNothing) {
+  trace::clear();
+  trace::setEnabled(false);
+  { trace::ScopedSpan span("ignored"); }
+  std::stringstream stream;
+  EXPECT_EQ(trace::writeChromeTrace(stream), 0);
+}
+
+TEST(TraceTest, SpansOfEveryThreadAreExported) {
+  trace::clear();
+  trace::setEnabled(true);
+  { trace::ScopedSpan span("main", 1, 2); }
+  std::thread worker([] {
+    for (int i = 0; i < 3; ++i) trace::ScopedSpan span("worker", i);
+  });
+  worker.join();
+  trace::setEnabled(false);
+
+  std::stringstream stream;
+  EXPECT_EQ(trace::writeChromeTrace(stream), 4);
+  nlohmann::json data = nlohmann::json::parse(stream);
+  int n_main = 0, n_worker = 0;
+  std::set<int> tids;
+  for (const auto &event : data["traceEvents"]) {
+    if (event["ph"] != "X") continue;
+    tids.insert(event["tid"].get<int>());
+    if (event["name"] == "main") {
+      ++n_main;
+      EXPECT_EQ(event["args"]["a"], 1);
+      EXPECT_EQ(event["args"]["b"], 2);
+    }
+    if (event["name"] == "worker") ++n_worker;
+  }
+  EXPECT_EQ(n_main, 1);
+  EXPECT_EQ(n_worker, 3);
+  EXPECT_EQ(tids.size(), 2);
+}
+
+TEST(TraceTest, RingKeepsTheLatestSpans) {
+  trace::clear();
+  trace::setEnabled(true);
+  for (int i = 0; i < trace::kRingCapacity + 10; ++i)
+    trace::ScopedSpan span("span", i);
+  trace::setEnabled(false);
+  std::stringstream stream;
+  EXPECT_EQ(trace::writeChromeTrace(stream), trace::kRingCapacity);
+  nlohmann::json data = nlohmann::json::parse(stream);
+  int64_t first = INT64_MAX, last = INT64_MIN;
+  for (const auto &event : data["traceEvents"]) {
+    if (event["ph"] != "X") continue;
+    first = std::min(first, event["args"]["a"].get<int64_t>());
+    last = std::max(last, event["args"]["a"].get<int64_t>());
+  }
+  EXPECT_EQ(first, 10);
+  EXPECT_EQ(last, trace::kRingCapacity + 9);
+}
+
+TEST(TraceTest, BuffersOfExitedThreadsAreFreed) {
+  trace::clear();
+  trace::setEnabled(true);
+  { trace::ScopedSpan span("main"); }
+  int n_buffers = trace::getNThreadBuffers();
+  for (int t = 0; t < 20; ++t) {
+    std::thread worker([t] { trace::ScopedSpan span("worker", t); });
+    worker.join();
+  }
+  trace::setEnabled(false);
+  // Their spans outlive them, their buffers do not
+  EXPECT_EQ(trace::getNThreadBuffers(), n_buffers);
+  std::stringstream stream;
+  EXPECT_EQ(trace::writeChromeTrace(stream), 21);
+  nlohmann::json data = nlohmann::json::parse(stream);
+  std::set<int> tids;
+  for (const auto &event : data["traceEvents"]) {
+    if (event["ph"] == "X") tids.insert(event["tid"].get<int>());
+  }
+  EXPECT_EQ(tids.size(), 21);
+}